@@ -0,0 +1,68 @@
+#include "common/bench.hpp"
+#include "components/config.hpp"
+#include "components/headless_renderer.hpp"
+#include "components/logger.hpp"
+#include "tags/action_context.hpp"
+#include "tags/dispatch.hpp"
+
+using namespace polybar;
+
+/**
+ * Pushes whole bar contents through the tag dispatch into the headless
+ * renderer, the same path a bar update takes apart from the X output
+ */
+class BarBenchmark : public benchmark::Fixture {
+ public:
+  void SetUp(const benchmark::State&) override {
+    m_conf.set_sections({{"bar/bench", {{"font-0", "monospace:size=10;2"}, {"font-1", "monospace:size=8;2"}}}});
+
+    m_bar.size.w = 1920;
+    m_bar.size.h = 27;
+    m_bar.background = rgba{0xff222222};
+    m_bar.foreground = rgba{0xffdfdfdf};
+
+    m_renderer = make_unique<headless_renderer>(m_conf, m_log, m_bar, m_action_ctxt);
+  }
+
+  void TearDown(const benchmark::State&) override {
+    m_renderer.reset();
+  }
+
+ protected:
+  void draw(string contents) {
+    m_renderer->begin(m_bar.inner_area());
+    m_dispatch.parse(m_bar, *m_renderer, move(contents));
+    m_renderer->end();
+  }
+
+  logger m_log{loglevel::NONE};
+  config m_conf{m_log, "", "bench"};
+  bar_settings m_bar{};
+  tags::action_context m_action_ctxt{};
+  tags::dispatch m_dispatch{m_log, m_action_ctxt};
+  unique_ptr<headless_renderer> m_renderer;
+};
+
+/**
+ * Every module changes in every frame
+ */
+BENCHMARK_DEFINE_F(BarBenchmark, renderChanged)(benchmark::State& state) {
+  size_t frame{0};
+  for (auto _ : state) {
+    draw(bench::synthetic_bar(state.range(0), frame++));
+  }
+}
+BENCHMARK_REGISTER_F(BarBenchmark, renderChanged)->Arg(10)->Arg(50)->Unit(benchmark::kMicrosecond);
+
+/**
+ * The same contents are drawn again, which should only cost the dispatch
+ */
+BENCHMARK_DEFINE_F(BarBenchmark, renderUnchanged)(benchmark::State& state) {
+  auto contents = bench::synthetic_bar(state.range(0));
+  draw(contents);
+
+  for (auto _ : state) {
+    draw(contents);
+  }
+}
+BENCHMARK_REGISTER_F(BarBenchmark, renderUnchanged)->Arg(10)->Arg(50)->Unit(benchmark::kMicrosecond);
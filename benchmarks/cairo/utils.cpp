@@ -0,0 +1,18 @@
+#include "cairo/utils.hpp"
+
+#include "common/bench.hpp"
+
+using namespace polybar;
+
+static void utf8ToUcs4(benchmark::State& state) {
+  string ascii{"Lorem ipsum dolor sit amet, consectetur adipiscing elit"};
+  string multibyte{"Ẽṽẽṙÿṫḣïṅġ ïṡ ṡḣöṙṫ-ḷïṽẽḋ  \U0001f60a ïṅ ṫḣïṡ ẅöṙḷḋ"};
+  const auto& input = state.range(0) ? multibyte : ascii;
+
+  for (auto _ : state) {
+    cairo::utils::unicode_charlist chars;
+    benchmark::DoNotOptimize(
+        cairo::utils::utf8_to_ucs4(reinterpret_cast<const unsigned char*>(input.c_str()), chars));
+  }
+}
+BENCHMARK(utf8ToUcs4)->ArgName("multibyte")->Arg(0)->Arg(1);
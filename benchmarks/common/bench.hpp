@@ -0,0 +1,41 @@
+#pragma once
+
+#include "benchmark/benchmark.h"
+#include "common.hpp"
+
+POLYBAR_NS
+
+namespace bench {
+  /**
+   * Formatting string of a bar with the given number of modules
+   *
+   * The modules are split evenly between the three alignments and use the
+   * tags that typical module output contains: colors, underlines, offsets,
+   * font changes and actions.
+   */
+  inline string synthetic_bar(size_t modules, size_t seed = 0) {
+    string output;
+
+    for (size_t i = 0; i < modules; i++) {
+      if (i == 0) {
+        output += "%{l}";
+      } else if (i == modules / 3) {
+        output += "%{c}";
+      } else if (i == 2 * modules / 3) {
+        output += "%{r}";
+      }
+
+      auto n = to_string(i);
+      output += "%{A1:module" + n + ":}";
+      output += "%{B#ff282a2e}%{F#c5c8c6}%{u#f0c674}%{+u}";
+      output += "%{O4}%{T2}%{T-}%{O2}module " + n + ": " + to_string((i + 1) * (seed + 13) % 1000) + "%";
+      output += "%{-u}%{F-}%{B-}";
+      output += "%{A}";
+      output += "%{O10}";
+    }
+
+    return output;
+  }
+}  // namespace bench
+
+POLYBAR_NS_END
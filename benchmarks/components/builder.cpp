@@ -0,0 +1,83 @@
+#include "components/builder.hpp"
+
+#include "common/bench.hpp"
+#include "drawtypes/label.hpp"
+
+using namespace polybar;
+
+static void builderNode(benchmark::State& state) {
+  bar_settings bar{};
+  builder b{bar};
+
+  for (auto _ : state) {
+    b.node("module output");
+    benchmark::DoNotOptimize(b.flush());
+  }
+}
+BENCHMARK(builderNode);
+
+static void builderColor(benchmark::State& state) {
+  bar_settings bar{};
+  builder b{bar};
+
+  for (auto _ : state) {
+    b.background(rgba{0xff282a2e});
+    b.color(rgba{0xffc5c8c6});
+    b.underline(rgba{0xfff0c674});
+    b.node("module output");
+    b.underline_close();
+    b.color_close();
+    b.background_close();
+    benchmark::DoNotOptimize(b.flush());
+  }
+}
+BENCHMARK(builderColor);
+
+static void builderAction(benchmark::State& state) {
+  bar_settings bar{};
+  builder b{bar};
+
+  for (auto _ : state) {
+    b.action(mousebtn::LEFT, "#module.toggle");
+    b.action(mousebtn::SCROLL_UP, "#module.next");
+    b.node("module output");
+    b.action_close();
+    b.action_close();
+    benchmark::DoNotOptimize(b.flush());
+  }
+}
+BENCHMARK(builderAction);
+
+static void builderLabel(benchmark::State& state) {
+  bar_settings bar{};
+  builder b{bar};
+  auto label = make_shared<drawtypes::label>("%percentage%%", rgba{0xffc5c8c6}, rgba{0xff282a2e}, rgba{0xfff0c674},
+      rgba{}, 2, side_values{1U, 1U}, side_values{0U, 0U});
+
+  for (auto _ : state) {
+    b.node(label);
+    benchmark::DoNotOptimize(b.flush());
+  }
+}
+BENCHMARK(builderLabel);
+
+/**
+ * A whole module: a few labels with colors and actions, flushed at the end
+ */
+static void builderFlush(benchmark::State& state) {
+  bar_settings bar{};
+  builder b{bar};
+
+  for (auto _ : state) {
+    for (int i = 0; i < state.range(0); i++) {
+      b.action(mousebtn::LEFT, "#module.toggle");
+      b.color(rgba{0xffc5c8c6});
+      b.node("label");
+      b.color_close();
+      b.space(1);
+      b.action_close();
+    }
+    benchmark::DoNotOptimize(b.flush());
+  }
+}
+BENCHMARK(builderFlush)->Arg(1)->Arg(8)->Arg(64);
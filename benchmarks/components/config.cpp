@@ -0,0 +1,46 @@
+#include "components/config.hpp"
+
+#include "common/bench.hpp"
+#include "components/logger.hpp"
+#include "utils/color.hpp"
+
+using namespace polybar;
+
+class ConfigBenchmark : public benchmark::Fixture {
+ public:
+  void SetUp(const benchmark::State&) override {
+    m_conf.set_sections({
+        {"bar/test", {{"width", "100%"}, {"height", "27"}}},
+        {"module/test", {{"interval", "2.5"}, {"label", "%percentage%%"}, {"inherit", "module/base"}}},
+        {"module/base", {{"format-underline", "#f0c674"}, {"format-padding", "2"}}},
+    });
+  }
+
+ protected:
+  logger m_log{loglevel::NONE};
+  config m_conf{m_log, "", "test"};
+};
+
+BENCHMARK_F(ConfigBenchmark, getString)(benchmark::State& state) {
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(m_conf.get<string>("module/test", "label"));
+  }
+}
+
+BENCHMARK_F(ConfigBenchmark, getDouble)(benchmark::State& state) {
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(m_conf.get<double>("module/test", "interval"));
+  }
+}
+
+BENCHMARK_F(ConfigBenchmark, getInherited)(benchmark::State& state) {
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(m_conf.get<rgba>("module/test", "format-underline"));
+  }
+}
+
+BENCHMARK_F(ConfigBenchmark, getDefault)(benchmark::State& state) {
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(m_conf.get<int>("module/test", "format-margin", 0));
+  }
+}
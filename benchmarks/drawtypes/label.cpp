@@ -0,0 +1,33 @@
+#include "drawtypes/label.hpp"
+
+#include "common/bench.hpp"
+
+using namespace polybar;
+using namespace drawtypes;
+
+static void replaceToken(benchmark::State& state) {
+  label l{"%percentage%% used (%used% of %total%)", rgba{}, rgba{}, rgba{}, rgba{}, 0, side_values{0U, 0U},
+      side_values{0U, 0U}, 0, 0_z, alignment::LEFT, true,
+      {token{"%percentage%"}, token{"%used%"}, token{"%total%"}}};
+
+  for (auto _ : state) {
+    l.reset_tokens();
+    l.replace_token("%percentage%", "42");
+    l.replace_token("%used%", "3.4 GiB");
+    l.replace_token("%total%", "7.8 GiB");
+    benchmark::DoNotOptimize(l.get());
+  }
+}
+BENCHMARK(replaceToken);
+
+static void replaceTokenBounded(benchmark::State& state) {
+  label l{"%title%", rgba{}, rgba{}, rgba{}, rgba{}, 0, side_values{0U, 0U}, side_values{0U, 0U}, 0, 0_z,
+      alignment::LEFT, true, {token{"%title%", 5_z, 20_z, "..."}}};
+
+  for (auto _ : state) {
+    l.reset_tokens();
+    l.replace_token("%title%", "Some window title that is too long");
+    benchmark::DoNotOptimize(l.get());
+  }
+}
+BENCHMARK(replaceTokenBounded);
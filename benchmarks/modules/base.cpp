@@ -0,0 +1,84 @@
+#include "common/bench.hpp"
+#include "components/builder.hpp"
+#include "drawtypes/label.hpp"
+#include "modules/meta/base.inl"
+#include "modules/meta/static_module.hpp"
+
+POLYBAR_NS
+
+namespace modules {
+  /**
+   * Label with the given tokens, as load_label would create it
+   */
+  static label_t make_label(string text, vector<token>&& tokens) {
+    return make_shared<label>(move(text), rgba{}, rgba{}, rgba{}, rgba{}, 0, side_values{0U, 0U},
+        side_values{0U, 0U}, 0, 0_z, alignment::LEFT, true, move(tokens));
+  }
+
+  /**
+   * Module with a typical format: a prefix, two labels and an icon
+   */
+  class bench_module : public static_module<bench_module> {
+   public:
+    explicit bench_module(const bar_settings& bar)
+        : static_module<bench_module>(bar, "bench")
+        , m_label(make_label("%percentage%%", {token{"%percentage%"}}))
+        , m_detail(make_label("(%used% of %total%)", {token{"%used%"}, token{"%total%"}})) {
+      m_formatter->add(DEFAULT_FORMAT, "<icon> <label> <detail>", {"<icon>", "<label>", "<detail>"});
+    }
+
+    void update() {}
+
+    string get_format() const {
+      return DEFAULT_FORMAT;
+    }
+
+    bool build(builder* builder, const string& tag) const {
+      if (tag == "<icon>") {
+        builder->color(rgba{0xfff0c674});
+        builder->node("M");
+        builder->color_close();
+      } else if (tag == "<label>") {
+        builder->node(m_label);
+      } else if (tag == "<detail>") {
+        builder->action(mousebtn::LEFT, *this, "toggle", "");
+        builder->node(m_detail);
+        builder->action_close();
+      } else {
+        return false;
+      }
+      return true;
+    }
+
+    string output() {
+      m_label->reset_tokens();
+      m_label->replace_token("%percentage%", "42");
+      m_detail->reset_tokens();
+      m_detail->replace_token("%used%", "3.4 GiB");
+      m_detail->replace_token("%total%", "7.8 GiB");
+      return get_output();
+    }
+
+    static constexpr auto TYPE = "custom/bench";
+
+   private:
+    label_t m_label;
+    label_t m_detail;
+  };
+
+  template class module<bench_module>;
+}  // namespace modules
+
+POLYBAR_NS_END
+
+using namespace polybar;
+
+static void getOutput(benchmark::State& state) {
+  bar_settings bar{};
+  modules::bench_module module{bar};
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(module.output());
+  }
+}
+BENCHMARK(getOutput);
@@ -0,0 +1,54 @@
+#include "tags/dispatch.hpp"
+
+#include "common/bench.hpp"
+#include "components/logger.hpp"
+#include "components/types.hpp"
+#include "tags/action_context.hpp"
+#include "tags/context.hpp"
+
+using namespace polybar;
+using namespace tags;
+
+/**
+ * Renderer that only advances the position, to measure the dispatch overhead
+ */
+class null_renderer : public renderer_interface {
+ public:
+  using renderer_interface::renderer_interface;
+
+  void render_offset(const context& ctxt, int pixels) override {
+    m_x[ctxt.get_alignment()] += pixels;
+  }
+  void render_text(const context& ctxt, const string& str) override {
+    m_x[ctxt.get_alignment()] += 6 * str.size();
+  }
+  void change_alignment(const context&) override {}
+  void begin_slice(const context&, const string&) override {}
+  void end_slice(const context&) override {}
+  double get_x(const context& ctxt) const override {
+    return m_x.at(ctxt.get_alignment());
+  }
+  double get_alignment_start(const alignment) const override {
+    return 0;
+  }
+
+ private:
+  std::map<alignment, double> m_x{{alignment::NONE, 0}, {alignment::LEFT, 0}, {alignment::CENTER, 0},
+      {alignment::RIGHT, 0}};
+};
+
+static void dispatchParse(benchmark::State& state) {
+  auto input = bench::synthetic_bar(state.range(0));
+  logger log{loglevel::NONE};
+  bar_settings bar{};
+  action_context action_ctxt;
+  dispatch d{log, action_ctxt};
+  null_renderer renderer{action_ctxt};
+
+  for (auto _ : state) {
+    d.parse(bar, renderer, string{input});
+  }
+
+  state.SetBytesProcessed(state.iterations() * input.size());
+}
+BENCHMARK(dispatchParse)->Arg(1)->Arg(10)->Arg(50);
@@ -0,0 +1,36 @@
+#include "tags/parser.hpp"
+
+#include "common/bench.hpp"
+
+using namespace polybar;
+using namespace tags;
+
+static void nextElement(benchmark::State& state) {
+  auto input = bench::synthetic_bar(state.range(0));
+  parser p;
+
+  for (auto _ : state) {
+    p.set(string{input});
+    while (p.has_next_element()) {
+      benchmark::DoNotOptimize(p.next_element());
+    }
+  }
+
+  state.SetBytesProcessed(state.iterations() * input.size());
+}
+BENCHMARK(nextElement)->Arg(1)->Arg(10)->Arg(50);
+
+static void nextElementText(benchmark::State& state) {
+  string input(state.range(0), 'a');
+  parser p;
+
+  for (auto _ : state) {
+    p.set(string{input});
+    while (p.has_next_element()) {
+      benchmark::DoNotOptimize(p.next_element());
+    }
+  }
+
+  state.SetBytesProcessed(state.iterations() * input.size());
+}
+BENCHMARK(nextElementText)->Arg(16)->Arg(1024);
@@ -0,0 +1,33 @@
+#include "utils/string.hpp"
+
+#include "common/bench.hpp"
+
+using namespace polybar;
+
+static void replaceAll(benchmark::State& state) {
+  string haystack{"%percentage%% used (%used% of %total%), %percentage_free%% free"};
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(string_util::replace_all(haystack, "%percentage%", "42"));
+  }
+}
+BENCHMARK(replaceAll);
+
+static void floatingPoint(benchmark::State& state) {
+  double value{0};
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(string_util::floating_point(value, 2, true));
+    value += 0.37;
+  }
+}
+BENCHMARK(floatingPoint);
+
+static void utf8Truncate(benchmark::State& state) {
+  string value{"Ẽṽẽṙÿṫḣïṅġ ïṡ ṡḣöṙṫ-ḷïṽẽḋ ïṅ ṫḣïṡ ẅöṙḷḋ"};
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(string_util::utf8_truncate(string{value}, state.range(0)));
+  }
+}
+BENCHMARK(utf8Truncate)->Arg(8)->Arg(32);
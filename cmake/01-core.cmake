@@ -14,6 +14,7 @@ endif()
 option(BUILD_POLYBAR "Build the main polybar executable" ${DEFAULT_ON})
 option(BUILD_POLYBAR_MSG "Build polybar-msg" ${DEFAULT_ON})
 option(BUILD_TESTS "Build testsuite" OFF)
+option(BUILD_BENCHMARKS "Build benchmarks" OFF)
 option(BUILD_DOC "Build documentation" ${DEFAULT_ON})
 option(BUILD_CONFIG "Generate sample configuration" ${DEFAULT_ON})
 option(BUILD_SHELL "Generate shell completion files" ${DEFAULT_ON})
@@ -22,7 +23,7 @@ include(CMakeDependentOption)
 CMAKE_DEPENDENT_OPTION(BUILD_DOC_HTML "Build HTML documentation" ON "BUILD_DOC" OFF)
 CMAKE_DEPENDENT_OPTION(BUILD_DOC_MAN "Build manpages" ON "BUILD_DOC" OFF)
 
-if (BUILD_POLYBAR OR BUILD_TESTS)
+if (BUILD_POLYBAR OR BUILD_TESTS OR BUILD_BENCHMARKS)
   set(BUILD_LIBPOLY ON)
 else()
   set(BUILD_LIBPOLY OFF)
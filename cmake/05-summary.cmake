@@ -23,6 +23,7 @@ message(STATUS " Targets:")
 colored_option("   polybar" BUILD_POLYBAR)
 colored_option("   polybar-msg" BUILD_POLYBAR_MSG)
 colored_option("   testsuite" BUILD_TESTS)
+colored_option("   benchmarks" BUILD_BENCHMARKS)
 colored_option("   documentation" BUILD_DOC)
 colored_option("      html" BUILD_DOC_HTML)
 colored_option("      man" BUILD_DOC_MAN)
@@ -46,6 +47,7 @@ if (BUILD_LIBPOLY)
   colored_option("   xcb-xkb" WITH_XKB Xcb_XKB_VERSION)
   colored_option("   xcb-xrm" WITH_XRM Xcb_XRM_VERSION)
   colored_option("   xcb-cursor" WITH_XCURSOR Xcb_CURSOR_VERSION)
+  colored_option("   xcb-present" WITH_XPRESENT Xcb_PRESENT_VERSION)
 
   message(STATUS " Log options:")
   colored_option("   Trace logging" DEBUG_LOGGER)
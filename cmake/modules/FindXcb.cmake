@@ -20,7 +20,8 @@ set(XCB_known_components
   COMPOSITE
   XKB
   XRM
-  CURSOR)
+  CURSOR
+  PRESENT)
 
 # Deducing header from the name of the component
 foreach(_comp ${XCB_known_components})
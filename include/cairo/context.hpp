@@ -5,7 +5,10 @@
 #include <algorithm>
 #include <cmath>
 #include <deque>
+#include <numeric>
+#include <unordered_set>
 
+#include "cairo/coverage.hpp"
 #include "cairo/font.hpp"
 #include "cairo/surface.hpp"
 #include "cairo/types.hpp"
@@ -15,6 +18,7 @@
 #include "components/types.hpp"
 #include "errors.hpp"
 #include "utils/color.hpp"
+#include "utils/lru_cache.hpp"
 #include "utils/string.hpp"
 
 POLYBAR_NS
@@ -35,6 +39,9 @@ namespace cairo {
 
     virtual ~context() {
       cairo_destroy(m_c);
+      for (auto&& c : m_layers) {
+        cairo_destroy(c);
+      }
     }
 
     operator cairo_t*() const {
@@ -147,90 +154,45 @@ namespace cairo {
       return *this;
     }
 
+    /**
+     * Draw a block of text
+     *
+     * Shaping the text and splitting it up between the fallback fonts is
+     * cached, repeated text is drawn straight from the cached glyphs.
+     */
     context& operator<<(const textblock& t) {
       double x, y;
       position(&x, &y);
 
-      // Prioritize the preferred font
-      vector<shared_ptr<font>> fns(m_fonts.begin(), m_fonts.end());
+      string key{to_string(t.font) + ':' + t.contents};
+      const shaped_text* shaped = m_shaped.get(key);
 
-      if (t.font > 0 && t.font <= std::distance(fns.begin(), fns.end())) {
-        std::iter_swap(fns.begin(), fns.begin() + t.font - 1);
+      if (shaped == nullptr) {
+        shaped = &m_shaped.put(key, shape(t));
       }
 
-      string utf8 = string(t.contents);
-      utils::unicode_charlist chars;
-      utils::utf8_to_ucs4((const unsigned char*)utf8.c_str(), chars);
-
-      while (!chars.empty()) {
-        auto remaining = chars.size();
-        for (auto&& f : fns) {
-          unsigned int matches = 0;
-
-          // Match as many glyphs as possible if the default/preferred font
-          // is being tested. Otherwise test one glyph at a time against
-          // the remaining fonts. Roll back to the top of the font list
-          // when a glyph has been found.
-          if (f == fns.front() && (matches = f->match(chars)) == 0) {
-            continue;
-          } else if (f != fns.front() && (matches = f->match(chars.front())) == 0) {
-            continue;
-          }
-
-          string subset;
-          auto end = chars.begin();
-          while (matches-- && end != chars.end()) {
-            subset += utf8.substr(end->offset, end->length);
-            end++;
-          }
-
-          // Use the font
-          f->use();
-
-          // Get subset extents
-          cairo_text_extents_t extents;
-          f->textwidth(subset, &extents);
-
-          // Draw the background
-          if (t.bg_rect.h != 0.0) {
-            save();
-            cairo_set_operator(m_c, t.bg_operator);
-            *this << t.bg;
-            cairo_rectangle(m_c, t.bg_rect.x + *t.x_advance, t.bg_rect.y + *t.y_advance,
-                t.bg_rect.w + extents.x_advance, t.bg_rect.h);
-            cairo_fill(m_c);
-            restore();
-          }
-
-          // Render subset
-          auto fontextents = f->extents();
-          f->render(subset, x, y - (fontextents.descent / 2 - fontextents.height / 4) + f->offset());
-
-          // Get updated position
-          position(&x, nullptr);
-
-          // Increase position
-          *t.x_advance += extents.x_advance;
-          *t.y_advance += extents.y_advance;
-
-          chars.erase(chars.begin(), end);
-          break;
+      for (auto&& segment : *shaped) {
+        // Use the font
+        segment.fnt->use(m_c);
+
+        // Draw the background
+        if (t.bg_rect.h != 0.0) {
+          save();
+          cairo_set_operator(m_c, t.bg_operator);
+          *this << t.bg;
+          cairo_rectangle(m_c, t.bg_rect.x + *t.x_advance, t.bg_rect.y + *t.y_advance,
+              t.bg_rect.w + segment.extents.x_advance, t.bg_rect.h);
+          cairo_fill(m_c);
+          restore();
         }
 
-        if (chars.empty()) {
-          break;
-        } else if (remaining != chars.size()) {
-          continue;
-        }
+        // Render subset
+        segment.fnt->render(m_c, segment.run, x, y + segment.y_offset);
 
-        char unicode[6]{'\0'};
-        utils::ucs4_to_utf8(unicode, chars.begin()->codepoint);
-        m_log.warn("Dropping unmatched character %s (U+%04x) in '%s'", unicode, chars.begin()->codepoint, t.contents);
-        utf8.erase(chars.begin()->offset, chars.begin()->length);
-        for (auto&& c : chars) {
-          c.offset -= chars.begin()->length;
-        }
-        chars.erase(chars.begin(), ++chars.begin());
+        // Increase position
+        x += segment.run.x_advance;
+        *t.x_advance += segment.extents.x_advance;
+        *t.y_advance += segment.extents.y_advance;
       }
 
       return *this;
@@ -238,6 +200,9 @@ namespace cairo {
 
     context& operator<<(shared_ptr<font>&& f) {
       m_fonts.emplace_back(forward<decltype(f)>(f));
+      m_shaped.clear();
+      m_coverage.reset(m_fonts.size());
+      m_dropped.clear();
       return *this;
     }
 
@@ -288,13 +253,64 @@ namespace cairo {
       return *this;
     }
 
+    /**
+     * End the innermost push() and get what was drawn since
+     */
     context& pop(cairo_pattern_t** pattern) {
-      *pattern = cairo_pop_group(m_c);
+      if (m_pushed.empty() || !m_pushed.back()) {
+        *pattern = cairo_pop_group(m_c);
+      } else {
+        cairo_matrix_t matrix;
+        cairo_get_matrix(m_c, &matrix);
+        *pattern = cairo_pattern_create_for_surface(cairo_get_target(m_c));
+        cairo_pattern_set_matrix(*pattern, &matrix);
+        cairo_destroy(m_c);
+        m_c = m_layers.back();
+        m_layers.pop_back();
+      }
+
+      if (!m_pushed.empty()) {
+        m_pushed.pop_back();
+      }
       return *this;
     }
 
+    /**
+     * Draw into a new intermediate surface until the matching pop()
+     */
     context& push() {
       cairo_push_group(m_c);
+      m_pushed.push_back(false);
+      return *this;
+    }
+
+    /**
+     * Draw into the given surface until the matching pop()
+     *
+     * Works like push() but reuses the surface instead of allocating a new
+     * one. It has to be at least as large as the current target. The part
+     * inside the current clip is cleared, the transformation, clip extents,
+     * source and operator carry over.
+     */
+    context& push(const surface& layer) {
+      cairo_matrix_t matrix;
+      double x1, y1, x2, y2;
+      cairo_get_matrix(m_c, &matrix);
+      cairo_clip_extents(m_c, &x1, &y1, &x2, &y2);
+
+      cairo_t* c = cairo_create(layer);
+      cairo_set_antialias(c, cairo_get_antialias(m_c));
+      cairo_set_matrix(c, &matrix);
+      cairo_rectangle(c, x1, y1, x2 - x1, y2 - y1);
+      cairo_clip(c);
+      cairo_set_operator(c, CAIRO_OPERATOR_CLEAR);
+      cairo_paint(c);
+      cairo_set_operator(c, cairo_get_operator(m_c));
+      cairo_set_source(c, cairo_get_source(m_c));
+
+      m_layers.emplace_back(m_c);
+      m_c = c;
+      m_pushed.push_back(true);
       return *this;
     }
 
@@ -354,11 +370,125 @@ namespace cairo {
     }
 
    protected:
+    /**
+     * \brief Part of a text block that is drawn with a single font
+     */
+    struct shaped_segment {
+      shared_ptr<font> fnt;
+      glyph_run run;
+      cairo_text_extents_t extents;
+      double y_offset;
+    };
+
+    using shaped_text = vector<shaped_segment>;
+
+    /**
+     * Split text up between the fonts and shape each part
+     *
+     * The preferred font is tried first for as many characters as possible,
+     * the other fonts are tested one character at a time. Characters not
+     * found in any font are dropped, the warning is only logged the first
+     * time a character is dropped.
+     */
+    shaped_text shape(const textblock& t) {
+      shaped_text shaped;
+
+      // Prioritize the preferred font
+      vector<size_t> slots(m_fonts.size());
+      std::iota(slots.begin(), slots.end(), 0);
+
+      if (t.font > 0 && t.font <= static_cast<int>(slots.size())) {
+        std::swap(slots.front(), slots[t.font - 1]);
+      }
+
+      string utf8 = string(t.contents);
+      utils::unicode_charlist chars;
+      utils::utf8_to_ucs4((const unsigned char*)utf8.c_str(), chars);
+
+      while (!chars.empty()) {
+        auto remaining = chars.size();
+        for (auto&& slot : slots) {
+          // Match as many glyphs as possible if the default/preferred font
+          // is being tested. Otherwise test one glyph at a time against
+          // the remaining fonts. Roll back to the top of the font list
+          // when a glyph has been found.
+          auto end = chars.begin();
+          while (end != chars.end() && m_coverage.covers(slot, end->codepoint)) {
+            end++;
+            if (slot != slots.front()) {
+              break;
+            }
+          }
+
+          if (end == chars.begin()) {
+            continue;
+          }
+
+          string subset;
+          for (auto it = chars.begin(); it != end; it++) {
+            subset += utf8.substr(it->offset, it->length);
+          }
+
+          auto& f = m_fonts[slot];
+          shaped_segment segment{};
+          segment.fnt = f;
+
+          // Get subset extents
+          f->textwidth(subset, &segment.extents);
+
+          auto fontextents = f->extents();
+          segment.y_offset = f->offset() - (fontextents.descent / 2 - fontextents.height / 4);
+          segment.run = f->shape(subset);
+
+          shaped.emplace_back(move(segment));
+
+          chars.erase(chars.begin(), end);
+          break;
+        }
+
+        if (chars.empty()) {
+          break;
+        } else if (remaining != chars.size()) {
+          continue;
+        }
+
+        if (m_dropped.emplace(chars.begin()->codepoint).second) {
+          char unicode[6]{'\0'};
+          utils::ucs4_to_utf8(unicode, chars.begin()->codepoint);
+          POLYBAR_LOG_WARN(m_log, "Dropping unmatched character %s (U+%04x) in '%s'", unicode, chars.begin()->codepoint,
+              t.contents);
+        }
+        utf8.erase(chars.begin()->offset, chars.begin()->length);
+        for (auto&& c : chars) {
+          c.offset -= chars.begin()->length;
+        }
+        chars.erase(chars.begin(), ++chars.begin());
+      }
+
+      return shaped;
+    }
+
+    /**
+     * \brief Number of shaped text blocks kept around
+     */
+    static constexpr size_t SHAPED_CACHE_SIZE{512};
+
     cairo_t* m_c;
     const logger& m_log;
     vector<shared_ptr<font>> m_fonts;
+    lru_cache<string, shaped_text> m_shaped{SHAPED_CACHE_SIZE};
+    font_coverage m_coverage{[this](size_t slot, uint32_t codepoint) { return m_fonts[slot]->has_glyph(codepoint); }};
+    std::unordered_set<uint32_t> m_dropped;
     std::deque<pair<double, double>> m_points;
     int m_activegroups{0};
+    /**
+     * Contexts of the targets below the surfaces passed to push()
+     */
+    vector<cairo_t*> m_layers;
+    /**
+     * For every unmatched push(), whether it was given a surface
+     */
+    vector<bool> m_pushed;
 
     private:
       const double degree = M_PI / 180.0;
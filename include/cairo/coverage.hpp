@@ -0,0 +1,143 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <functional>
+
+#include "common.hpp"
+#include "utils/lru_cache.hpp"
+
+POLYBAR_NS
+
+namespace cairo {
+  /**
+   * \brief Index of which fonts have a glyph for a given codepoint
+   *
+   * The coverage of a codepoint is probed once for all fonts and then
+   * cached, including codepoints no font has a glyph for. ASCII is
+   * stored in a flat table, the rest of the BMP goes through a small
+   * direct-mapped cache in front of an LRU cache of limited size.
+   *
+   * Only the first 64 fonts are indexed, fonts after that are probed
+   * every time.
+   */
+  class font_coverage {
+   public:
+    using probe_fn = std::function<bool(size_t slot, uint32_t codepoint)>;
+    using mask_t = uint64_t;
+
+    static constexpr size_t MAX_SLOTS{64};
+
+    /**
+     * Number of codepoints outside of ASCII whose coverage is kept
+     */
+    static constexpr size_t CACHE_SIZE{4096};
+
+    explicit font_coverage(probe_fn probe) : m_probe(move(probe)) {
+      reset(0);
+    }
+
+    /**
+     * Drop all cached coverage and set the number of font slots
+     */
+    void reset(size_t slots) {
+      m_slots = slots;
+      m_ascii_known = false;
+      m_ascii.fill(0);
+      m_bmp.fill(bmp_entry{});
+      m_other.clear();
+    }
+
+    /**
+     * Check if the font in the given slot has a glyph for the codepoint
+     */
+    bool covers(size_t slot, uint32_t codepoint) {
+      if (slot >= MAX_SLOTS) {
+        return slot < m_slots && m_probe(slot, codepoint);
+      }
+      return (lookup(codepoint) >> slot) & 1;
+    }
+
+    /**
+     * Check if any font has a glyph for the codepoint
+     */
+    bool covered(uint32_t codepoint) {
+      if (lookup(codepoint) != 0) {
+        return true;
+      }
+      for (size_t slot = MAX_SLOTS; slot < m_slots; slot++) {
+        if (m_probe(slot, codepoint)) {
+          return true;
+        }
+      }
+      return false;
+    }
+
+   protected:
+    static constexpr size_t ASCII_SIZE{128};
+    static constexpr size_t BMP_CACHE_SIZE{1024};
+    static constexpr uint32_t BMP_END{0x10000};
+
+    struct bmp_entry {
+      uint32_t codepoint{BMP_END};
+      mask_t mask{0};
+    };
+
+    mask_t lookup(uint32_t codepoint) {
+      if (codepoint < ASCII_SIZE) {
+        if (!m_ascii_known) {
+          for (uint32_t c = 0; c < ASCII_SIZE; c++) {
+            m_ascii[c] = probe(c);
+          }
+          m_ascii_known = true;
+        }
+        return m_ascii[codepoint];
+      }
+
+      bmp_entry* entry{nullptr};
+      if (codepoint < BMP_END) {
+        entry = &m_bmp[codepoint % BMP_CACHE_SIZE];
+        if (entry->codepoint == codepoint) {
+          return entry->mask;
+        }
+      }
+
+      mask_t mask;
+      auto cached = m_other.get(codepoint);
+      if (cached != nullptr) {
+        mask = *cached;
+      } else {
+        mask = probe(codepoint);
+        m_other.put(codepoint, mask);
+      }
+
+      if (entry != nullptr) {
+        entry->codepoint = codepoint;
+        entry->mask = mask;
+      }
+
+      return mask;
+    }
+
+    mask_t probe(uint32_t codepoint) const {
+      mask_t mask{0};
+      for (size_t slot = 0; slot < m_slots && slot < MAX_SLOTS; slot++) {
+        if (m_probe(slot, codepoint)) {
+          mask |= mask_t{1} << slot;
+        }
+      }
+      return mask;
+    }
+
+   private:
+    probe_fn m_probe;
+    size_t m_slots{0};
+
+    bool m_ascii_known{false};
+    std::array<mask_t, ASCII_SIZE> m_ascii{};
+    std::array<bmp_entry, BMP_CACHE_SIZE> m_bmp{};
+    lru_cache<uint32_t, mask_t> m_other{CACHE_SIZE};
+  };
+}  // namespace cairo
+
+POLYBAR_NS_END
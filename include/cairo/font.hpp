@@ -19,6 +19,19 @@ namespace cairo {
    */
   static FT_Library g_ftlib;
 
+  /**
+   * \brief Glyphs of a piece of text shaped with a single font
+   *
+   * Glyph positions are relative to the origin of the text
+   */
+  struct glyph_run {
+    string text;
+    vector<cairo_glyph_t> glyphs;
+    vector<cairo_text_cluster_t> clusters;
+    cairo_text_cluster_flags_t cluster_flags{};
+    double x_advance{0.0};
+  };
+
   /**
    * \brief Abstract font face
    */
@@ -34,16 +47,19 @@ namespace cairo {
 
     virtual cairo_font_extents_t extents() = 0;
 
-    virtual void use() {
-      cairo_set_font_face(m_cairo, cairo_font_face_reference(m_font_face));
+    virtual void use(cairo_t* cairo) {
+      cairo_set_font_face(cairo, cairo_font_face_reference(m_font_face));
     }
 
-    virtual size_t match(utils::unicode_character& character) = 0;
-    virtual size_t match(utils::unicode_charlist& charlist) = 0;
-    virtual size_t render(const string& text, double x = 0.0, double y = 0.0) = 0;
+    virtual bool has_glyph(unsigned int codepoint) = 0;
+    virtual glyph_run shape(const string& text) = 0;
+    virtual void render(cairo_t* cairo, const glyph_run& run, double x, double y) = 0;
     virtual void textwidth(const string& text, cairo_text_extents_t* extents) = 0;
 
    protected:
+    /**
+     * Context the font was loaded for, text can be drawn with any context
+     */
     cairo_t* m_cairo;
     cairo_font_face_t* m_font_face{nullptr};
     cairo_font_extents_t m_extents{};
@@ -61,6 +77,10 @@ namespace cairo {
       cairo_matrix_init_scale(&fm, size(dpi_x), size(dpi_y));
       cairo_get_matrix(m_cairo, &ctm);
 
+      if (FcPatternGetCharSet(m_pattern, FC_CHARSET, 0, &m_charset) != FcResultMatch) {
+        m_charset = nullptr;
+      }
+
       auto fontface = cairo_ft_font_face_create_for_pattern(m_pattern);
       auto opts = cairo_font_options_create();
       m_scaled = cairo_scaled_font_create(fontface, &fm, &ctm, opts);
@@ -183,47 +203,47 @@ namespace cairo {
       }
     }
 
-    void use() override {
-      cairo_set_scaled_font(m_cairo, m_scaled);
+    void use(cairo_t* cairo) override {
+      cairo_set_scaled_font(cairo, m_scaled);
     }
 
-    size_t match(utils::unicode_character& character) override {
-      auto lock = make_unique<utils::ft_face_lock>(m_scaled);
-      auto face = static_cast<FT_Face>(*lock);
-      return FT_Get_Char_Index(face, character.codepoint) ? 1 : 0;
-    }
+    /**
+     * Check if the font has a glyph for the codepoint
+     *
+     * Uses the charset fontconfig reports for the font if it has one, which
+     * avoids locking the freetype face.
+     */
+    bool has_glyph(unsigned int codepoint) override {
+      if (m_charset != nullptr) {
+        return FcCharSetHasChar(m_charset, codepoint);
+      }
 
-    size_t match(utils::unicode_charlist& charlist) override {
       auto lock = make_unique<utils::ft_face_lock>(m_scaled);
       auto face = static_cast<FT_Face>(*lock);
-      size_t available_chars = 0;
-      for (auto&& c : charlist) {
-        if (FT_Get_Char_Index(face, c.codepoint)) {
-          available_chars++;
-        } else {
-          break;
-        }
-      }
-
-      return available_chars;
+      return FT_Get_Char_Index(face, codepoint) != 0;
     }
 
-    size_t render(const string& text, double x = 0.0, double y = 0.0) override {
+    /**
+     * Convert text to glyphs
+     *
+     * Only the leading part of the text for which the font has glyphs is
+     * part of the returned run.
+     */
+    glyph_run shape(const string& text) override {
+      glyph_run run{};
       cairo_glyph_t* glyphs{nullptr};
       cairo_text_cluster_t* clusters{nullptr};
-      cairo_text_cluster_flags_t cf{};
       int nglyphs = 0, nclusters = 0;
 
-      string utf8 = string(text);
-      auto status = cairo_scaled_font_text_to_glyphs(
-          m_scaled, x, y, utf8.c_str(), utf8.size(), &glyphs, &nglyphs, &clusters, &nclusters, &cf);
+      auto status = cairo_scaled_font_text_to_glyphs(m_scaled, 0.0, 0.0, text.c_str(), text.size(), &glyphs, &nglyphs,
+          &clusters, &nclusters, &run.cluster_flags);
 
       if (status != CAIRO_STATUS_SUCCESS) {
         throw application_error(sstream() << "cairo_scaled_font_text_to_glyphs()" << cairo_status_to_string(status));
       }
 
       size_t bytes = 0;
-      for (int g = 0; g < nglyphs; g++) {
+      for (int g = 0; g < nglyphs && g < nclusters; g++) {
         if (glyphs[g].index) {
           bytes += clusters[g].num_bytes;
         } else {
@@ -235,9 +255,8 @@ namespace cairo {
         cairo_glyph_free(glyphs);
         cairo_text_cluster_free(clusters);
 
-        utf8 = text.substr(0, bytes);
-        auto status = cairo_scaled_font_text_to_glyphs(
-            m_scaled, x, y, utf8.c_str(), utf8.size(), &glyphs, &nglyphs, &clusters, &nclusters, &cf);
+        status = cairo_scaled_font_text_to_glyphs(m_scaled, 0.0, 0.0, text.c_str(), bytes, &glyphs, &nglyphs,
+            &clusters, &nclusters, &run.cluster_flags);
 
         if (status != CAIRO_STATUS_SUCCESS) {
           throw application_error(sstream() << "cairo_scaled_font_text_to_glyphs()" << cairo_status_to_string(status));
@@ -245,22 +264,37 @@ namespace cairo {
       }
 
       if (bytes) {
-        // auto lock = make_unique<utils::device_lock>(cairo_surface_get_device(cairo_get_target(m_cairo)));
-        // if (lock.get()) {
-        //   cairo_glyph_path(m_cairo, glyphs, nglyphs);
-        // }
+        run.text = text.substr(0, bytes);
+        run.glyphs.assign(glyphs, glyphs + nglyphs);
+        run.clusters.assign(clusters, clusters + nclusters);
 
         cairo_text_extents_t extents{};
-        cairo_scaled_font_glyph_extents(m_scaled, glyphs, nglyphs, &extents);
-        cairo_show_text_glyphs(m_cairo, utf8.c_str(), utf8.size(), glyphs, nglyphs, clusters, nclusters, cf);
-        cairo_fill(m_cairo);
-        cairo_move_to(m_cairo, x + extents.x_advance, 0.0);
+        cairo_scaled_font_glyph_extents(m_scaled, run.glyphs.data(), run.glyphs.size(), &extents);
+        run.x_advance = extents.x_advance;
       }
 
       cairo_glyph_free(glyphs);
       cairo_text_cluster_free(clusters);
 
-      return bytes;
+      return run;
+    }
+
+    /**
+     * Draw glyphs previously shaped with this font at the given position
+     */
+    void render(cairo_t* cairo, const glyph_run& run, double x, double y) override {
+      if (run.glyphs.empty()) {
+        return;
+      }
+
+      vector<cairo_glyph_t> glyphs(run.glyphs);
+      for (auto&& g : glyphs) {
+        g.x += x;
+        g.y += y;
+      }
+
+      cairo_show_text_glyphs(cairo, run.text.c_str(), run.text.size(), glyphs.data(), glyphs.size(),
+          run.clusters.data(), run.clusters.size(), run.cluster_flags);
     }
 
     void textwidth(const string& text, cairo_text_extents_t* extents) override {
@@ -294,6 +328,10 @@ namespace cairo {
    private:
     cairo_scaled_font_t* m_scaled{nullptr};
     FcPattern* m_pattern{nullptr};
+    /**
+     * Owned by m_pattern
+     */
+    FcCharSet* m_charset{nullptr};
   };
 
   /**
@@ -315,7 +353,7 @@ namespace cairo {
     auto pattern = FcNameParse((FcChar8*)fontname.c_str());
 
     if(!pattern) {
-      logger::make().err("Could not parse font \"%s\"", fontname);
+      POLYBAR_LOG_ERR(logger::make(), "Could not parse font \"%s\"", fontname);
       throw application_error("Could not parse font \"" + fontname + "\"");
     }
 
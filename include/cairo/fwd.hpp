@@ -8,6 +8,8 @@ namespace cairo {
   class context;
   class surface;
   class xcb_surface;
+  class similar_surface;
+  class image_surface;
   class font;
   class font_fc;
 }
@@ -71,6 +71,61 @@ namespace cairo {
       cairo_xcb_surface_set_drawable(m_s, d, w, h);
     }
   };
+
+  /**
+   * \brief Surface in client memory
+   */
+  class image_surface : public surface {
+   public:
+    explicit image_surface(int w, int h) : surface(cairo_image_surface_create(CAIRO_FORMAT_ARGB32, w, h)) {
+      auto status = cairo_surface_status(m_s);
+      if (status != CAIRO_STATUS_SUCCESS) {
+        throw application_error(sstream() << "cairo_image_surface_create(): " << cairo_status_to_string(status));
+      }
+    }
+
+    ~image_surface() override {}
+
+    /**
+     * Pixel data as premultiplied, native endian 32-bit ARGB values
+     *
+     * Call flush() before reading it
+     */
+    const unsigned char* data() const {
+      return cairo_image_surface_get_data(m_s);
+    }
+
+    int stride() const {
+      return cairo_image_surface_get_stride(m_s);
+    }
+
+    int width() const {
+      return cairo_image_surface_get_width(m_s);
+    }
+
+    int height() const {
+      return cairo_image_surface_get_height(m_s);
+    }
+  };
+
+  /**
+   * \brief Offscreen surface of the same kind as another surface
+   *
+   * For xcb surfaces it is a pixmap on the server, so drawing it onto
+   * the other surface doesn't involve the client
+   */
+  class similar_surface : public surface {
+   public:
+    explicit similar_surface(const surface& other, int w, int h)
+        : surface(cairo_surface_create_similar(other, CAIRO_CONTENT_COLOR_ALPHA, w, h)) {
+      auto status = cairo_surface_status(m_s);
+      if (status != CAIRO_STATUS_SUCCESS) {
+        throw application_error(sstream() << "cairo_surface_create_similar(): " << cairo_status_to_string(status));
+      }
+    }
+
+    ~similar_surface() override {}
+  };
 }
 
 POLYBAR_NS_END
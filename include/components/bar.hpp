@@ -5,12 +5,14 @@
 #include <mutex>
 
 #include "common.hpp"
+#include "components/render_thread.hpp"
 #include "components/types.hpp"
 #include "errors.hpp"
 #include "events/signal_fwd.hpp"
 #include "events/signal_receiver.hpp"
 #include "settings.hpp"
 #include "tags/action_context.hpp"
+#include "tags/types.hpp"
 #include "utils/math.hpp"
 #include "x11/types.hpp"
 #include "x11/window.hpp"
@@ -20,11 +22,13 @@ POLYBAR_NS
 // fwd {{{
 class config;
 class connection;
+class eventloop;
 class logger;
-class renderer;
 class screen;
 class taskqueue;
 class tray_manager;
+class window_renderer;
+struct frame_metrics;
 
 namespace tags {
   class dispatch;
@@ -64,7 +68,7 @@ class bar : public xpp::event::sink<evt::button_press, evt::expose, evt::propert
                 > {
  public:
   using make_type = unique_ptr<bar>;
-  static make_type make(bool only_initialize_values = false);
+  static make_type make(eventloop& loop, bool only_initialize_values = false);
 
   explicit bar(connection&, signal_emitter&, const config&, const logger&, unique_ptr<screen>&&,
       unique_ptr<tray_manager>&&, unique_ptr<tags::dispatch>&&, unique_ptr<tags::action_context>&&,
@@ -72,14 +76,18 @@ class bar : public xpp::event::sink<evt::button_press, evt::expose, evt::propert
   ~bar();
 
   const bar_settings settings() const;
+  frame_metrics* metrics();
 
-  void parse(string&& data, bool force = false);
+  void parse(tags::format_blocks&& data, bool force = false);
 
   void hide();
   void show();
   void toggle();
 
  protected:
+  void redraw(bool force);
+  void draw(const render_thread::frame& frame);
+
   void restack_window();
   void reconfigue_window();
   void reconfigure_geom();
@@ -114,14 +122,30 @@ class bar : public xpp::event::sink<evt::button_press, evt::expose, evt::propert
   const logger& m_log;
   unique_ptr<screen> m_screen;
   unique_ptr<tray_manager> m_tray;
-  unique_ptr<renderer> m_renderer;
+  unique_ptr<window_renderer> m_renderer;
   unique_ptr<tags::dispatch> m_dispatch;
   unique_ptr<tags::action_context> m_action_ctxt;
   unique_ptr<taskqueue> m_taskqueue;
 
+  /**
+   * Draws the bar, stopped before the renderer gets destroyed
+   */
+  unique_ptr<render_thread> m_render_thread;
+
+  /**
+   * Action blocks of the last drawn frame, used for input handling
+   *
+   * Replaced as a whole after each frame, always access it with
+   * std::atomic_load and std::atomic_store.
+   */
+  shared_ptr<const tags::action_context> m_actions{make_shared<const tags::action_context>()};
+
   bar_settings m_opts{};
 
-  string m_lastinput{};
+  tags::format_blocks m_lastinput{};
+  /**
+   * Guards m_lastinput and the input handling state
+   */
   std::mutex m_mutex{};
   std::atomic<bool> m_dblclicks{false};
 
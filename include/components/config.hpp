@@ -106,7 +106,7 @@ class config {
     } catch (const key_error& err) {
       return default_value;
     } catch (const value_error& err) {
-      m_log.err("Invalid value for \"%s.%s\", using default value (reason: %s)", section, key, err.what());
+      POLYBAR_LOG_ERR(m_log, "Invalid value for \"%s.%s\", using default value (reason: %s)", section, key, err.what());
       return default_value;
     }
   }
@@ -169,7 +169,8 @@ class config {
       } catch (const key_error& err) {
         break;
       } catch (const value_error& err) {
-        m_log.err("Invalid value in list \"%s.%s\", using list as-is (reason: %s)", section, key, err.what());
+        POLYBAR_LOG_ERR(m_log, "Invalid value in list \"%s.%s\", using list as-is (reason: %s)", section, key,
+            err.what());
         return default_value;
       }
     }
@@ -255,7 +256,7 @@ class config {
   template <typename T>
   T dereference_local(string section, const string& key, const string& current_section) const {
     if (section == "BAR") {
-      m_log.warn("${BAR.key} is deprecated. Use ${root.key} instead");
+      POLYBAR_LOG_WARN(m_log, "${BAR.key} is deprecated. Use ${root.key} instead");
     }
 
     section = string_util::replace(section, "BAR", this->section(), 0, 3);
@@ -270,7 +271,7 @@ class config {
       size_t pos;
       if ((pos = key.find(':')) != string::npos) {
         string fallback = key.substr(pos + 1);
-        m_log.info("The reference ${%s.%s} does not exist, using defined fallback value \"%s\"", section,
+        POLYBAR_LOG_INFO(m_log, "The reference ${%s.%s} does not exist, using defined fallback value \"%s\"", section,
             key.substr(0, pos), fallback);
         return convert<T>(move(fallback));
       }
@@ -301,10 +302,11 @@ class config {
 
     if (env_util::has(var)) {
       string env_value{env_util::get(var)};
-      m_log.info("Environment var reference ${%s} found (value=%s)", var, env_value);
+      POLYBAR_LOG_INFO(m_log, "Environment var reference ${%s} found (value=%s)", var, env_value);
       return convert<T>(move(env_value));
     } else if (has_default) {
-      m_log.info("Environment var ${%s} is undefined, using defined fallback value \"%s\"", var, env_default);
+      POLYBAR_LOG_INFO(m_log, "Environment var ${%s} is undefined, using defined fallback value \"%s\"", var,
+          env_default);
       return convert<T>(move(env_default));
     } else {
       throw value_error(sstream() << "Environment var ${" << var << "} does not exist (no fallback set)");
@@ -320,7 +322,7 @@ class config {
   T dereference_xrdb(string var) const {
     size_t pos;
 #if not WITH_XRM
-    m_log.warn("No built-in support to dereference ${xrdb:%s} references (requires `xcb-util-xrm`)", var);
+    POLYBAR_LOG_WARN(m_log, "No built-in support to dereference ${xrdb:%s} references (requires `xcb-util-xrm`)", var);
     if ((pos = var.find(':')) != string::npos) {
       return convert<T>(var.substr(pos + 1));
     }
@@ -340,11 +342,11 @@ class config {
 
     try {
       auto value = m_xrm->require<string>(var.c_str());
-      m_log.info("Found matching X resource \"%s\" (value=%s)", var, value);
+      POLYBAR_LOG_INFO(m_log, "Found matching X resource \"%s\" (value=%s)", var, value);
       return convert<T>(move(value));
     } catch (const xresource_error& err) {
       if (has_fallback) {
-        m_log.info("%s, using defined fallback value \"%s\"", err.what(), fallback);
+        POLYBAR_LOG_INFO(m_log, "%s, using defined fallback value \"%s\"", err.what(), fallback);
         return convert<T>(move(fallback));
       }
       throw value_error(sstream() << err.what() << " (no fallback set)");
@@ -370,10 +372,10 @@ class config {
     var = file_util::expand(var);
 
     if (file_util::exists(var)) {
-      m_log.info("File reference \"%s\" found", var);
+      POLYBAR_LOG_INFO(m_log, "File reference \"%s\" found", var);
       return convert<T>(string_util::trim(file_util::contents(var), '\n'));
     } else if (has_fallback) {
-      m_log.info("File reference \"%s\" not found, using defined fallback value \"%s\"", var, fallback);
+      POLYBAR_LOG_INFO(m_log, "File reference \"%s\" not found, using defined fallback value \"%s\"", var, fallback);
       return convert<T>(move(fallback));
     } else {
       throw value_error(sstream() << "The file \"" << var << "\" does not exist (no fallback set)");
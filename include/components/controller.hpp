@@ -5,10 +5,12 @@
 #include <thread>
 
 #include "common.hpp"
+#include "components/eventloop.hpp"
 #include "components/types.hpp"
 #include "events/signal_fwd.hpp"
 #include "events/signal_receiver.hpp"
 #include "events/types.hpp"
+#include "tags/types.hpp"
 #include "settings.hpp"
 #include "utils/actions.hpp"
 #include "utils/file.hpp"
@@ -22,10 +24,13 @@ enum class alignment;
 class bar;
 class config;
 class connection;
+class dirty_set;
+class frame_scheduler;
 class inotify_watch;
 class ipc;
 class logger;
 class signal_emitter;
+class worker_pool;
 namespace modules {
   struct module_interface;
 }  // namespace modules
@@ -41,10 +46,10 @@ class controller
           signals::ui::ready, signals::ui::button_press, signals::ui::update_background> {
  public:
   using make_type = unique_ptr<controller>;
-  static make_type make(unique_ptr<ipc>&& ipc, unique_ptr<inotify_watch>&& config_watch);
+  static make_type make(eventloop& loop, unique_ptr<ipc>&& ipc, unique_ptr<inotify_watch>&& config_watch);
 
-  explicit controller(connection&, signal_emitter&, const logger&, const config&, unique_ptr<bar>&&, unique_ptr<ipc>&&,
-      unique_ptr<inotify_watch>&&);
+  explicit controller(connection&, signal_emitter&, const logger&, const config&, eventloop&, unique_ptr<bar>&&,
+      unique_ptr<ipc>&&, unique_ptr<inotify_watch>&&);
   ~controller();
 
   bool run(bool writeback, string snapshot_dst);
@@ -54,9 +59,11 @@ class controller
 
  protected:
   void read_events();
+  void watch_config();
   void process_eventqueue();
   void process_inputdata();
   bool process_update(bool force);
+  void notify_change(size_t index);
 
   bool on(const signals::eventqueue::notify_change& evt) override;
   bool on(const signals::eventqueue::notify_forcechange& evt) override;
@@ -71,8 +78,45 @@ class controller
   bool on(const signals::ui::update_background& evt) override;
 
  private:
+  /**
+   * \brief Most threads the module output is fetched on in parallel
+   */
+  static constexpr size_t MAX_UPDATE_THREADS{4};
+
+  /**
+   * \brief Last output of a module as used in its block
+   */
+  struct module_cache {
+    string contents;
+    tags::format_string elements;
+    bool shown{false};
+    /**
+     * \brief Position of the module in m_modules
+     */
+    size_t index{0};
+  };
+
+  /**
+   * \brief Assembled contents of a block together with the
+   * output of each of its modules
+   */
+  struct block_cache {
+    vector<module_cache> modules;
+    string contents;
+    /**
+     * \brief Handed to the bar as is, replaced when the block is recomposed
+     */
+    shared_ptr<const tags::format_string> elements{make_shared<const tags::format_string>()};
+    bool dirty{true};
+  };
+
   size_t setup_modules(alignment align);
 
+  bool update_module_cache(const module_t& module, module_cache& cache);
+  void compose_block(alignment align, block_cache& cache) const;
+  tags::format_string parse_contents(string contents) const;
+  string stats() const;
+
   bool forward_action(const actions_util::action& cmd);
   bool try_forward_legacy_action(const string& cmd);
 
@@ -84,7 +128,15 @@ class controller
   unique_ptr<ipc> m_ipc;
   unique_ptr<inotify_watch> m_confwatch;
 
-  array<unique_ptr<file_descriptor>, 2> m_queuefd{};
+  unique_ptr<file_descriptor> m_eventfd;
+
+  /**
+   * \brief Main thread event loop
+   *
+   * Shared with the bar, the tray and ipc, which register with it themselves
+   */
+  eventloop& m_loop;
+  eventloop::handle_t m_confwatch_handle{0};
 
   /**
    * \brief State flag
@@ -106,6 +158,14 @@ class controller
    */
   moodycamel::BlockingConcurrentQueue<event> m_queue;
 
+  /**
+   * \brief Modules whose output changed since the last update
+   *
+   * Indexed like m_modules, which it has to outlive because the module
+   * threads mark it until they are joined.
+   */
+  unique_ptr<dirty_set> m_changes;
+
   /**
    * \brief Loaded modules
    */
@@ -117,14 +177,30 @@ class controller
   modulemap_t m_blocks;
 
   /**
-   * \brief Maximum number of subsequent events to swallow
+   * \brief Composition cache for each block in m_blocks
+   */
+  std::map<alignment, block_cache> m_block_cache;
+
+  /**
+   * \brief Module separator, built once
+   */
+  string m_separator;
+  tags::format_string m_separator_elements;
+
+  /**
+   * \brief Whether the bar may not show the latest contents
+   */
+  bool m_bar_outdated{true};
+
+  /**
+   * \brief Threads the module output is fetched on
    */
-  size_t m_swallow_limit{5U};
+  unique_ptr<worker_pool> m_workers;
 
   /**
-   * \brief Time to wait for subsequent events
+   * \brief Limits the rate at which the bar gets redrawn
    */
-  std::chrono::milliseconds m_swallow_update{10};
+  unique_ptr<frame_scheduler> m_frames;
 
   /**
    * \brief Input data
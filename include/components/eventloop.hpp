@@ -0,0 +1,103 @@
+#pragma once
+
+#include <sys/epoll.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <thread>
+
+#include "common.hpp"
+#include "errors.hpp"
+#include "utils/mixins.hpp"
+#include "utils/timer_wheel.hpp"
+
+POLYBAR_NS
+
+namespace chrono = std::chrono;
+
+DEFINE_ERROR(eventloop_error);
+
+/**
+ * Single-threaded reactor multiplexing file descriptors and timers
+ * over one epoll set.
+ *
+ * Callbacks are always invoked on the loop thread. Handlers can be
+ * registered and removed from any thread; once remove() returns the
+ * callback is guaranteed to not be running (unless remove() is called
+ * from within a callback, in which case it returns immediately).
+ *
+ * Timers are kept in a timer_wheel backed by a single timerfd. Deadlines
+ * are rounded up to the wheel resolution, so timers falling into the same
+ * slack window expire in the same round. Callbacks registered with
+ * defer_unique() run once after each round.
+ *
+ * Callbacks are expected to handle their own errors, an exception
+ * escaping a callback will terminate the loop thread.
+ */
+class eventloop : non_copyable_mixin<eventloop> {
+ public:
+  using clock = chrono::system_clock;
+  using handle_t = unsigned int;
+  using fd_callback = function<void(int fd, unsigned int events)>;
+  using callback = function<void()>;
+
+  using make_type = eventloop&;
+  static make_type make();
+
+  explicit eventloop(clock::duration resolution = chrono::milliseconds{1});
+  ~eventloop();
+
+  handle_t add_fd(int fd, unsigned int events, fd_callback cb);
+  handle_t add_timer(clock::time_point when, callback cb);
+  void reschedule(handle_t handle, clock::time_point when);
+  void remove(handle_t handle);
+
+  void post(callback cb);
+  void defer_unique(string id, callback cb);
+  void wakeup();
+
+  void run();
+  void start();
+  void stop();
+
+  bool running() const;
+  bool in_loop_thread();
+
+ protected:
+  struct handler {
+    int fd{-1};
+    fd_callback func;
+  };
+
+  void loop();
+  void dispatch(handle_t handle, unsigned int events);
+  void expire_timers();
+  void arm_timer();
+  void drain_posted();
+  void run_deferred();
+
+ private:
+  int m_epollfd{-1};
+  int m_wakeupfd{-1};
+  int m_timerfd{-1};
+
+  std::atomic_bool m_running{false};
+  std::thread m_thread;
+  std::thread::id m_loop_thread{};
+
+  std::mutex m_lock;
+  std::condition_variable m_dispatched;
+  handle_t m_nexthandle{0};
+  handle_t m_dispatching{0};
+  std::map<handle_t, shared_ptr<handler>> m_handlers;
+  vector<callback> m_posted;
+  vector<pair<string, callback>> m_deferred;
+
+  timer_wheel m_wheel;
+  clock::time_point m_armed{};
+};
+
+POLYBAR_NS_END
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <chrono>
+
+#include "common.hpp"
+
+POLYBAR_NS
+
+namespace chrono = std::chrono;
+
+/**
+ * Decides when the bar gets redrawn
+ *
+ * Frames are limited to a fixed budget (1s / max_fps). The first request
+ * after an idle period is due immediately, any request arriving while a
+ * frame is pending is merged into that frame.
+ */
+class frame_scheduler {
+ public:
+  using clock = chrono::steady_clock;
+
+  struct stats {
+    size_t rendered{0};
+    size_t merged{0};
+    size_t dropped{0};
+  };
+
+  explicit frame_scheduler(unsigned int max_fps);
+
+  void request(bool force, clock::time_point now = clock::now());
+  bool begin_frame(clock::time_point now = clock::now());
+
+  bool pending() const;
+  clock::time_point deadline() const;
+  clock::duration budget() const;
+  const stats& get_stats() const;
+
+ private:
+  clock::duration m_budget;
+  clock::time_point m_last_frame{};
+  clock::time_point m_deadline{};
+  bool m_pending{false};
+  bool m_force{false};
+  bool m_rendered_once{false};
+  stats m_stats{};
+};
+
+POLYBAR_NS_END
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "cairo/fwd.hpp"
+#include "common.hpp"
+#include "components/renderer.hpp"
+
+POLYBAR_NS
+
+/**
+ * Renders the bar into an image in memory
+ *
+ * Uses the same fonts, layout and compositing as the bar window, but doesn't
+ * need an X server. Meant for profiling the rendering and for comparing
+ * rendered frames in tests.
+ */
+class headless_renderer : public renderer {
+ public:
+  using make_type = unique_ptr<headless_renderer>;
+  static make_type make(const bar_settings& bar, tags::action_context& action_ctxt);
+
+  explicit headless_renderer(
+      const config& conf, const logger& logger, const bar_settings& bar, tags::action_context& action_ctxt);
+  ~headless_renderer() override;
+
+  const cairo::image_surface& image() const;
+  void write_png(const string& dst);
+
+  const vector<xcb_rectangle_t>& damage() const;
+  size_t frames() const;
+
+ protected:
+  void present(const vector<xcb_rectangle_t>& areas) override;
+
+ private:
+  /**
+   * The surface passed to the renderer
+   */
+  cairo::image_surface* m_image{nullptr};
+
+  /**
+   * Areas that changed in the last frame
+   */
+  vector<xcb_rectangle_t> m_damage;
+
+  /**
+   * Number of frames that changed the image
+   */
+  size_t m_frames{0};
+};
+
+POLYBAR_NS_END
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "common.hpp"
+#include "components/eventloop.hpp"
 #include "settings.hpp"
 #include "utils/concurrency.hpp"
 
@@ -23,21 +24,29 @@ static constexpr const char* ipc_action_prefix{"action:"};
  * A unique messaging channel will be setup for each
  * running process which will allow messages and
  * events to be sent to the process externally.
+ *
+ * Messages are received on the given event loop.
  */
 class ipc {
  public:
   using make_type = unique_ptr<ipc>;
-  static make_type make();
+  static make_type make(eventloop& loop);
 
-  explicit ipc(signal_emitter& emitter, const logger& logger);
+  explicit ipc(signal_emitter& emitter, const logger& logger, eventloop& loop);
   ~ipc();
 
   void receive_message();
   int get_file_descriptor() const;
+  void reply(const string& path, const string& payload) const;
+
+ protected:
+  void watch();
 
  private:
   signal_emitter& m_sig;
   const logger& m_log;
+  eventloop& m_loop;
+  eventloop::handle_t m_handle{0};
 
   string m_path{};
   unique_ptr<file_descriptor> m_fd;
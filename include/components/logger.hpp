@@ -4,6 +4,7 @@
 #include <map>
 #include <string>
 #include <thread>
+#include <type_traits>
 #include <utility>
 
 #include "common.hpp"
@@ -38,57 +39,24 @@ class logger {
 
   void verbosity(loglevel level);
 
-#ifdef DEBUG_LOGGER  // {{{
-  template <typename... Args>
-  void trace(const string& message, Args&&... args) const {
-    output(loglevel::TRACE, message, std::forward<Args>(args)...);
-  }
-#ifdef DEBUG_LOGGER_VERBOSE
-  template <typename... Args>
-  void trace_x(const string& message, Args&&... args) const {
-    output(loglevel::TRACE, message, std::forward<Args>(args)...);
-  }
-#else
-  template <typename... Args>
-  void trace_x(Args&&...) const {}
-#endif
-#else
-  template <typename... Args>
-  void trace(Args&&...) const {}
-  template <typename... Args>
-  void trace_x(Args&&...) const {}
-#endif  // }}}
-
-  /**
-   * Output an info message
-   */
-  template <typename... Args>
-  void info(const string& message, Args&&... args) const {
-    output(loglevel::INFO, message, std::forward<Args>(args)...);
-  }
-
-  /**
-   * Output a notice
-   */
-  template <typename... Args>
-  void notice(const string& message, Args&&... args) const {
-    output(loglevel::NOTICE, message, std::forward<Args>(args)...);
-  }
+  static void flush();
 
   /**
-   * Output a warning message
+   * Whether messages of the given level are written
    */
-  template <typename... Args>
-  void warn(const string& message, Args&&... args) const {
-    output(loglevel::WARNING, message, std::forward<Args>(args)...);
+  bool enabled(loglevel level) const {
+    return level <= m_level;
   }
 
   /**
-   * Output an error message
+   * Write the log message to the output channel
+   *
+   * Use the POLYBAR_LOG_* macros instead, they check the format and only
+   * evaluate the arguments if the level is enabled.
    */
   template <typename... Args>
-  void err(const string& message, Args&&... args) const {
-    output(loglevel::ERROR, message, std::forward<Args>(args)...);
+  void output(loglevel level, const char* format, Args&&... values) const {
+    write(level, format, convert(values)...);
   }
 
  protected:
@@ -109,52 +77,199 @@ class logger {
   size_t convert(std::thread::id arg) const;
 
   /**
-   * Write the log message to the output channel
-   * if the defined verbosity level allows it
+   * Format the message and queue it for the writer thread
    */
-  template <typename... Args>
-  void output(loglevel level, const string& format, Args&&... values) const {
-    if (level > m_level) {
-      return;
-    }
-
-#if defined(__clang__)  // {{{
-#pragma clang diagnostic push
-#pragma clang diagnostic ignored "-Wformat-security"
-#elif defined(__GNUC__)
-#pragma GCC diagnostic push
-#pragma GCC diagnostic ignored "-Wformat-security"
-#endif  // }}}
-
-    dprintf(m_fd, (m_prefixes.at(level) + format + m_suffixes.at(level) + "\n").c_str(), convert(values)...);
-
-#if defined(__clang__)  // {{{
-#pragma clang diagnostic pop
-#elif defined(__GNUC__)
-#pragma GCC diagnostic pop
-#endif  // }}}
-  }
+  void write(loglevel level, const char* format, ...) const;
 
  private:
   /**
    * Logger verbosity level
    */
   loglevel m_level{loglevel::TRACE};
+};
+
+/**
+ * Compile time validation of printf style log formats
+ */
+namespace log_format {
+  enum class arg { NONE, INTEGER, FLOAT, STRING, POINTER, OTHER };
+
+  /**
+   * The kind of value an argument is passed as, after logger::convert
+   */
+  template <typename T, typename U = std::decay_t<T>>
+  constexpr arg kind() {
+    // clang-format off
+    return std::is_same<U, string>::value || std::is_convertible<U, const char*>::value ? arg::STRING
+      : std::is_integral<U>::value || std::is_enum<U>::value || std::is_same<U, std::thread::id>::value ? arg::INTEGER
+      : std::is_floating_point<U>::value ? arg::FLOAT
+      : std::is_pointer<U>::value ? arg::POINTER
+      : arg::OTHER;
+    // clang-format on
+  }
+
+  constexpr bool is_digit(char c) {
+    return c >= '0' && c <= '9';
+  }
 
   /**
-   * File descriptor used when writing the log messages
+   * Skips the field width or precision at the given position, which may also
+   * be given as an argument
    */
-  int m_fd{STDERR_FILENO};
+  constexpr bool skip_field(const char* format, size_t& i, const arg* args, size_t& n, size_t count) {
+    if (format[i] == '*') {
+      if (n == count || args[n++] != arg::INTEGER) {
+        return false;
+      }
+      i++;
+    }
+    while (is_digit(format[i])) {
+      i++;
+    }
+    return true;
+  }
 
   /**
-   * Loglevel specific prefixes
+   * Checks that the conversions in the format match the number and the kind
+   * of the given arguments
    */
-  std::map<loglevel, string> m_prefixes;
+  template <typename... Args>
+  constexpr bool valid(const char* format) {
+    const arg args[] = {kind<Args>()..., arg::NONE};
+    const size_t count{sizeof...(Args)};
+    size_t n{0};
+
+    for (size_t i = 0; format[i] != '\0'; i++) {
+      if (format[i] != '%') {
+        continue;
+      }
+      if (format[++i] == '%') {
+        continue;
+      }
+
+      while (format[i] == '-' || format[i] == '+' || format[i] == ' ' || format[i] == '#' || format[i] == '0') {
+        i++;
+      }
+
+      if (!skip_field(format, i, args, n, count)) {
+        return false;
+      }
+      if (format[i] == '.' && !skip_field(format, ++i, args, n, count)) {
+        return false;
+      }
+
+      while (format[i] == 'h' || format[i] == 'l' || format[i] == 'L' || format[i] == 'j' || format[i] == 'z' ||
+             format[i] == 't') {
+        i++;
+      }
+
+      if (format[i] == '\0' || n == count) {
+        return false;
+      }
+
+      auto a = args[n++];
+      switch (format[i]) {
+        case 'd':
+        case 'i':
+        case 'u':
+        case 'o':
+        case 'x':
+        case 'X':
+        case 'c':
+          if (a != arg::INTEGER) {
+            return false;
+          }
+          break;
+        case 'f':
+        case 'F':
+        case 'e':
+        case 'E':
+        case 'g':
+        case 'G':
+        case 'a':
+        case 'A':
+          if (a != arg::FLOAT) {
+            return false;
+          }
+          break;
+        case 's':
+          if (a != arg::STRING) {
+            return false;
+          }
+          break;
+        case 'p':
+          if (a != arg::POINTER && a != arg::STRING) {
+            return false;
+          }
+          break;
+        default:
+          return false;
+      }
+    }
+
+    return n == count;
+  }
+
+  template <typename... Args>
+  struct types {};
 
   /**
-   * Loglevel specific suffixes
+   * Only used to deduce the argument types of a log call, never called
    */
-  std::map<loglevel, string> m_suffixes;
-};
+  template <typename... Args>
+  types<std::decay_t<Args>...> deduce(Args&&...);
+
+  template <typename Format, typename... Args>
+  constexpr bool valid(types<Format, Args...>, const char* format) {
+    return valid<Args...>(format);
+  }
+}  // namespace log_format
 
 POLYBAR_NS_END
+
+#define POLYBAR_LOG_FORMAT_(format, ...) format
+
+/**
+ * Log a message with the given logger if its verbosity allows it
+ *
+ * The format has to be a string literal, it is checked against the arguments
+ * at compile time. The arguments are only evaluated if the message is logged.
+ */
+#define POLYBAR_LOG(log, level, ...)                                                                      \
+  do {                                                                                                    \
+    static_assert(::polybar::log_format::valid(decltype(::polybar::log_format::deduce(__VA_ARGS__)){},    \
+                      POLYBAR_LOG_FORMAT_(__VA_ARGS__, 0)),                                               \
+        "Log format does not match the arguments");                                                       \
+    const auto& polybar_log_ = (log);                                                                     \
+    if (polybar_log_.enabled(level)) {                                                                    \
+      polybar_log_.output(level, __VA_ARGS__);                                                            \
+    }                                                                                                     \
+  } while (0)
+
+/**
+ * Checks the format of a message that is never logged, without evaluating
+ * its arguments
+ */
+#define POLYBAR_LOG_DISABLED(log, ...)                             \
+  do {                                                             \
+    if (false) {                                                   \
+      POLYBAR_LOG(log, ::polybar::loglevel::TRACE, __VA_ARGS__);   \
+    }                                                              \
+  } while (0)
+
+#define POLYBAR_LOG_ERR(log, ...) POLYBAR_LOG(log, ::polybar::loglevel::ERROR, __VA_ARGS__)
+#define POLYBAR_LOG_WARN(log, ...) POLYBAR_LOG(log, ::polybar::loglevel::WARNING, __VA_ARGS__)
+#define POLYBAR_LOG_NOTICE(log, ...) POLYBAR_LOG(log, ::polybar::loglevel::NOTICE, __VA_ARGS__)
+#define POLYBAR_LOG_INFO(log, ...) POLYBAR_LOG(log, ::polybar::loglevel::INFO, __VA_ARGS__)
+
+#ifdef DEBUG_LOGGER
+#define POLYBAR_LOG_TRACE(log, ...) POLYBAR_LOG(log, ::polybar::loglevel::TRACE, __VA_ARGS__)
+#else
+#define POLYBAR_LOG_TRACE(log, ...) POLYBAR_LOG_DISABLED(log, __VA_ARGS__)
+#endif
+
+#if defined(DEBUG_LOGGER) && defined(DEBUG_LOGGER_VERBOSE)
+#define POLYBAR_LOG_TRACE_X(log, ...) POLYBAR_LOG(log, ::polybar::loglevel::TRACE, __VA_ARGS__)
+#else
+#define POLYBAR_LOG_TRACE_X(log, ...) POLYBAR_LOG_DISABLED(log, __VA_ARGS__)
+#endif
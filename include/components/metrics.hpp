@@ -0,0 +1,72 @@
+#pragma once
+
+#include <atomic>
+
+#include "common.hpp"
+#include "utils/histogram.hpp"
+
+POLYBAR_NS
+
+/**
+ * Timings of a single module
+ *
+ * Recorded by the module base classes, from whichever thread does the work.
+ */
+struct module_metrics {
+  /**
+   * Duration of the module update, that is the calls to update() or on_event()
+   */
+  histogram update;
+
+  /**
+   * Time it took to build new output, when broadcasting or when it is
+   * first read after a broadcast from the module event loop
+   */
+  histogram build;
+
+  /**
+   * Time spent waiting for the update and build locks
+   */
+  histogram update_lock;
+  histogram build_lock;
+
+  /**
+   * Number of times the module reported new output
+   */
+  std::atomic<uint64_t> broadcasts{0};
+
+  const histogram::clock::time_point since{histogram::clock::now()};
+
+  string to_json() const;
+};
+
+/**
+ * Timings of the stages a bar update goes through
+ */
+struct frame_metrics {
+  /**
+   * Fetching the changed module output and parsing it into tag elements
+   */
+  histogram parse;
+
+  /**
+   * Dispatching the elements to the renderer, which shapes the text and
+   * draws it into the block layers
+   */
+  histogram layout;
+
+  /**
+   * Compositing the blocks and the bar decorations into the frame
+   */
+  histogram raster;
+
+  /**
+   * Handing the finished frame to the output, including waiting for a free
+   * buffer to draw into
+   */
+  histogram present;
+
+  string to_json() const;
+};
+
+POLYBAR_NS_END
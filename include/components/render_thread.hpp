@@ -0,0 +1,80 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#include "common.hpp"
+#include "components/types.hpp"
+#include "tags/types.hpp"
+#include "utils/mixins.hpp"
+
+POLYBAR_NS
+
+class logger;
+
+/**
+ * Draws the bar on its own thread
+ *
+ * Frames are immutable descriptions of what to draw. Only the newest frame
+ * is kept, a frame submitted before the previous one was drawn replaces it.
+ * Other work that has to happen on the rendering thread, like copying the
+ * last frame to the window again, can be posted as tasks. Tasks run after
+ * the frame that was pending when they were posted.
+ *
+ * If the target is not ready to take a frame, the pending frame is held back
+ * and the thread checks again every RETRY_INTERVAL, tasks still run in the
+ * meantime. Tasks posted while a frame is held back do not wait for it.
+ */
+class render_thread : non_copyable_mixin<render_thread> {
+ public:
+  struct frame {
+    bar_settings settings;
+    tags::format_blocks elements;
+    xcb_rectangle_t rect;
+    bool force{false};
+  };
+
+  struct stats {
+    size_t rendered{0};
+    size_t replaced{0};
+    /**
+     * Number of times the pending frame was held back
+     */
+    size_t held{0};
+  };
+
+  using render_fn = function<void(const frame&)>;
+  using task_fn = function<void()>;
+  using ready_fn = function<bool()>;
+
+  static constexpr std::chrono::milliseconds RETRY_INTERVAL{2};
+
+  explicit render_thread(const logger& logger, render_fn render, ready_fn ready = nullptr);
+  ~render_thread();
+
+  void submit(frame&& f);
+  void post(task_fn task);
+
+  stats get_stats() const;
+
+ protected:
+  void run();
+
+ private:
+  const logger& m_log;
+  render_fn m_render;
+  ready_fn m_ready;
+
+  mutable std::mutex m_lock;
+  std::condition_variable m_cond;
+  unique_ptr<frame> m_pending;
+  vector<task_fn> m_tasks;
+  bool m_active{true};
+  stats m_stats{};
+
+  std::thread m_thread;
+};
+
+POLYBAR_NS_END
@@ -2,26 +2,23 @@
 
 #include <cairo/cairo.h>
 
+#include <array>
 #include <bitset>
 #include <memory>
 
 #include "cairo/fwd.hpp"
 #include "common.hpp"
+#include "components/metrics.hpp"
 #include "components/renderer_interface.hpp"
 #include "components/types.hpp"
-#include "events/signal_fwd.hpp"
-#include "events/signal_receiver.hpp"
-#include "x11/extensions/fwd.hpp"
+#include "utils/lru_cache.hpp"
 #include "x11/types.hpp"
 
 POLYBAR_NS
 
 // fwd {{{
-class connection;
 class config;
 class logger;
-class background_manager;
-class bg_slice;
 // }}}
 
 using std::map;
@@ -30,48 +27,152 @@ struct alignment_block {
   cairo_pattern_t* pattern;
   double x;
   double y;
+  /**
+   * Serialized drawing operations of the block, two blocks
+   * with the same signature and width look the same
+   */
+  string signature{};
 };
 
-class renderer : public renderer_interface,
-                 public signal_receiver<SIGN_PRIORITY_RENDERER, signals::ui::request_snapshot> {
- public:
-  using make_type = unique_ptr<renderer>;
-  static make_type make(const bar_settings& bar, tags::action_context& action_ctxt);
+/**
+ * Position and contents of an alignment block as drawn in the last frame
+ */
+struct drawn_block {
+  double x{0.0};
+  double w{0.0};
+  string signature{};
+};
 
-  explicit renderer(connection& conn, signal_emitter& sig, const config&, const logger& logger, const bar_settings& bar,
-      background_manager& background_manager, tags::action_context& action_ctxt);
-  ~renderer();
+/**
+ * Drawing state in effect when a slice begins, including the subpixel
+ * position it starts at
+ */
+using slice_state = std::array<uint32_t, 8>;
+
+/**
+ * Pre-rendered output of a single module
+ */
+struct cached_slice {
+  /**
+   * What the slice was drawn from, the cache is only keyed by their hash
+   */
+  slice_state state{};
+  string contents{};
+
+  shared_ptr<cairo::surface> surface;
+  /**
+   * Position of the surface relative to the start of the slice
+   */
+  double x{0.0};
+  /**
+   * Horizontal advance of every text and offset drawn in the slice, in order
+   */
+  vector<double> advances{};
+  /**
+   * Spans relative to the start of the slice that replace what is below
+   * them instead of being drawn over it
+   */
+  vector<pair<double, double>> cutouts{};
+};
 
-  xcb_window_t window() const;
+/**
+ * Output of a single module that is currently being drawn
+ */
+struct active_slice {
+  size_t key{0};
+  slice_state state{};
+  /**
+   * Module output the slice is drawn from, only kept while recording
+   */
+  string contents{};
+  /**
+   * Start of the slice inside its alignment block
+   */
+  double x{0.0};
+  /**
+   * Cached rendering the slice is replayed from, nullptr while recording
+   */
+  const cached_slice* cached{nullptr};
+  size_t replayed{0};
+  vector<double> advances{};
+  vector<pair<double, double>> cutouts{};
+  bool cacheable{true};
+};
+
+/**
+ * Draws the bar onto a cairo surface
+ *
+ * Where the surface comes from and what happens with the finished
+ * frames is up to the subclasses.
+ */
+class renderer : public renderer_interface {
+ public:
+  virtual ~renderer();
 
   void begin(xcb_rectangle_t rect);
   void end();
-  void flush();
+  void invalidate();
+
+  frame_metrics& metrics();
 
   void render_offset(const tags::context& ctxt, int pixels) override;
-  void render_text(const tags::context& ctxt, const string&&) override;
+  void render_text(const tags::context& ctxt, const string&) override;
 
   void change_alignment(const tags::context& ctxt) override;
 
+  void begin_slice(const tags::context& ctxt, const string& key) override;
+  void end_slice(const tags::context& ctxt) override;
+
   double get_x(const tags::context& ctxt) const override;
 
   double get_alignment_start(const alignment align) const override;
 
  protected:
-  void fill_background();
+  explicit renderer(const config&, const logger& logger, const bar_settings& bar, tags::action_context& action_ctxt);
+
+  void init(unique_ptr<cairo::surface>&& surface, double fallback_dpi_x, double fallback_dpi_y);
+
+  /**
+   * Called before a frame is drawn onto the surface
+   *
+   * \param keep Only parts of the frame are drawn, the surface
+   *             has to contain the previous frame
+   */
+  virtual void prepare(bool /* keep */) {}
+
+  /**
+   * Called after a frame was drawn
+   *
+   * \param areas Parts of the surface that changed, empty if the frame
+   *              looks the same as the previous one
+   */
+  virtual void present(const vector<xcb_rectangle_t>& areas) = 0;
+
+  /**
+   * Background the bar is drawn on with pseudo-transparency, if any
+   */
+  virtual const cairo::surface* backdrop() const {
+    return nullptr;
+  }
+
+  void fill_background(cairo_operator_t op);
   void fill_overline(rgba color, double x, double w);
   void fill_underline(rgba color, double x, double w);
-  void fill_borders();
+  void fill_borders(cairo_operator_t op);
 
   double block_x(alignment a) const;
   double block_y(alignment a) const;
   double block_w(alignment a) const;
   double block_h(alignment a) const;
 
-  void flush(alignment a);
+  void flush(alignment a, const cairo::surface* backdrop);
+  vector<xcb_rectangle_t> damaged_areas();
+  slice_state current_slice_state(const tags::context& ctxt) const;
+  void finish_slice();
+  bool replaying() const;
+  void advance(double dx);
   void highlight_clickable_areas();
-
-  bool on(const signals::ui::request_snapshot& evt) override;
+  cairo::surface& layer(unique_ptr<cairo::surface>& slot);
 
  protected:
   struct reserve_area {
@@ -79,20 +180,10 @@ class renderer : public renderer_interface,
     unsigned int size{0U};
   };
 
- private:
-  connection& m_connection;
-  signal_emitter& m_sig;
+ protected:
   const config& m_conf;
   const logger& m_log;
   const bar_settings& m_bar;
-  std::shared_ptr<bg_slice> m_background;
-
-  int m_depth{32};
-  xcb_window_t m_window;
-  xcb_colormap_t m_colormap;
-  xcb_visualtype_t* m_visual;
-  xcb_gcontext_t m_gcontext;
-  xcb_pixmap_t m_pixmap;
 
   xcb_rectangle_t m_rect{0, 0, 0U, 0U};
   reserve_area m_cleararea{};
@@ -100,10 +191,38 @@ class renderer : public renderer_interface,
   // bool m_autosize{false};
 
   unique_ptr<cairo::context> m_context;
-  unique_ptr<cairo::xcb_surface> m_surface;
+  unique_ptr<cairo::surface> m_surface;
   map<alignment, alignment_block> m_blocks;
+  map<alignment, drawn_block> m_drawn;
   cairo_pattern_t* m_cornermask{};
 
+  /**
+   * Offscreen surfaces the alignment blocks are drawn into and the frame is
+   * composited from if needed, allocated once and reused for every frame
+   */
+  map<alignment, unique_ptr<cairo::surface>> m_block_layers;
+  unique_ptr<cairo::surface> m_blocks_layer;
+  unique_ptr<cairo::surface> m_bar_layer;
+
+  /**
+   * Forces the next frame to repaint the whole bar
+   */
+  bool m_damage_all{true};
+
+  /**
+   * \brief Number of pre-rendered module outputs kept around
+   */
+  static constexpr size_t SLICE_CACHE_SIZE{64};
+
+  /**
+   * Module outputs can only be drawn separately and composited afterwards
+   * if that looks the same as drawing them directly
+   */
+  bool m_slices_enabled{false};
+  bool m_slicing{false};
+  active_slice m_slice{};
+  lru_cache<size_t, cached_slice> m_slices{SLICE_CACHE_SIZE};
+
   cairo_operator_t m_comp_bg{CAIRO_OPERATOR_SOURCE};
   cairo_operator_t m_comp_fg{CAIRO_OPERATOR_OVER};
   cairo_operator_t m_comp_ol{CAIRO_OPERATOR_OVER};
@@ -111,10 +230,17 @@ class renderer : public renderer_interface,
   cairo_operator_t m_comp_border{CAIRO_OPERATOR_OVER};
   bool m_pseudo_transparency{false};
 
+  /**
+   * With pseudo-transparency, the bar can be drawn straight onto the desktop
+   * background if that looks the same as compositing it afterwards
+   */
+  bool m_direct_transparency{false};
+
   alignment m_align;
 
   bool m_fixedcenter;
-  string m_snapshot_dst;
+
+  frame_metrics m_metrics;
 };
 
 POLYBAR_NS_END
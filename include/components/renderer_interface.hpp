@@ -11,9 +11,23 @@ class renderer_interface {
   renderer_interface(const tags::action_context& action_ctxt) : m_action_ctxt(action_ctxt){};
 
   virtual void render_offset(const tags::context& ctxt, int pixels) = 0;
-  virtual void render_text(const tags::context& ctxt, const string&& str) = 0;
+  virtual void render_text(const tags::context& ctxt, const string& str) = 0;
   virtual void change_alignment(const tags::context& ctxt) = 0;
 
+  /**
+   * Mark the start of the output of a single module.
+   *
+   * The key uniquely identifies the output, renderers can use it to reuse
+   * what they drew for the same output in an earlier frame. Everything up to
+   * the next call to end_slice still has to be passed to the renderer.
+   */
+  virtual void begin_slice(const tags::context&, const string&) {}
+
+  /**
+   * Mark the end of the output of a single module.
+   */
+  virtual void end_slice(const tags::context&) {}
+
   /**
    * Get the current x-coordinate of the renderer.
    *
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <xcb/xcb.h>
+
+#include "common.hpp"
+
+POLYBAR_NS
+
+/**
+ * Decides which of a fixed set of buffers the next frame is drawn into
+ *
+ * The newest complete frame is in the front buffer. The next frame goes into
+ * the first buffer after it that the display server no longer reads from.
+ * A buffer that is still in use is never handed out, if all of them are
+ * busy the caller has to hold back the frame until one becomes idle.
+ *
+ * It also tracks in which areas each buffer differs from the front buffer,
+ * so that only those have to be copied over before a buffer is partially
+ * redrawn. If too many areas pile up, the whole buffer is marked instead.
+ */
+class swap_chain {
+ public:
+  using idle_fn = function<bool(size_t)>;
+
+  static constexpr size_t MAX_STALE_AREAS{16};
+
+  explicit swap_chain(size_t count, xcb_rectangle_t full);
+
+  size_t size() const;
+  size_t front() const;
+  size_t back() const;
+
+  bool available(const idle_fn& idle = nullptr) const;
+  bool acquire(const idle_fn& idle = nullptr);
+  vector<xcb_rectangle_t> take_stale();
+  void present(const vector<xcb_rectangle_t>& areas);
+
+ private:
+  const xcb_rectangle_t m_full;
+  vector<vector<xcb_rectangle_t>> m_stale;
+  size_t m_front{0};
+  size_t m_back{0};
+
+  size_t find_idle(const idle_fn& idle) const;
+};
+
+POLYBAR_NS_END
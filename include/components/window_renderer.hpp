@@ -0,0 +1,95 @@
+#pragma once
+
+#include <array>
+#include <mutex>
+
+#include "common.hpp"
+#include "components/renderer.hpp"
+#include "components/swap_chain.hpp"
+#include "events/signal_fwd.hpp"
+#include "events/signal_receiver.hpp"
+#include "x11/extensions/fwd.hpp"
+#include "x11/types.hpp"
+
+POLYBAR_NS
+
+// fwd {{{
+class connection;
+class background_manager;
+class bg_slice;
+class present_window;
+// }}}
+
+/**
+ * Renders the bar into the bar window
+ */
+class window_renderer : public renderer,
+                        public signal_receiver<SIGN_PRIORITY_RENDERER, signals::ui::request_snapshot> {
+ public:
+  using make_type = unique_ptr<window_renderer>;
+  static make_type make(const bar_settings& bar, tags::action_context& action_ctxt);
+
+  explicit window_renderer(connection& conn, signal_emitter& sig, const config&, const logger& logger,
+      const bar_settings& bar, background_manager& background_manager, tags::action_context& action_ctxt);
+  ~window_renderer() override;
+
+  xcb_window_t window() const;
+
+  bool ready();
+  void flush();
+
+ protected:
+  void prepare(bool keep) override;
+  void present(const vector<xcb_rectangle_t>& areas) override;
+  const cairo::surface* backdrop() const override;
+
+  void flush(const vector<xcb_rectangle_t>& areas);
+  swap_chain::idle_fn idle_check();
+
+  bool on(const signals::ui::request_snapshot& evt) override;
+
+ private:
+  connection& m_connection;
+  signal_emitter& m_sig;
+  std::shared_ptr<bg_slice> m_background;
+
+  int m_depth{32};
+  xcb_window_t m_window;
+  xcb_colormap_t m_colormap;
+  xcb_visualtype_t* m_visual;
+  xcb_gcontext_t m_gcontext;
+
+  /**
+   * \brief Number of pixmaps the frames are drawn into in turn
+   */
+  static constexpr size_t PIXMAP_COUNT{3};
+
+  std::array<xcb_pixmap_t, PIXMAP_COUNT> m_pixmaps{};
+
+  /**
+   * Which pixmap holds the newest complete frame, which one is drawn into and
+   * what has to be copied over before drawing
+   */
+  swap_chain m_chain;
+
+  /**
+   * The surface passed to the renderer, drawing into the current back pixmap
+   */
+  cairo::xcb_surface* m_xcb_surface{nullptr};
+
+#if WITH_XPRESENT
+  /**
+   * Shows the frames through the X Present extension, nullptr if the server
+   * does not support it and the pixmaps are copied onto the window instead
+   */
+  unique_ptr<present_window> m_present;
+#endif
+
+  /**
+   * Set from the signal thread, written when the next frame is flushed
+   */
+  std::mutex m_snapshot_lock;
+  string m_snapshot_dst;
+};
+
+POLYBAR_NS_END
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <thread>
+
+#include "common.hpp"
+#include "utils/mixins.hpp"
+
+POLYBAR_NS
+
+/**
+ * Fixed set of threads that run batches of tasks in parallel
+ *
+ * The tasks of a batch are spread over one queue per thread. A thread first
+ * takes tasks from the front of its own queue and then steals from the back
+ * of the others, so a batch finishes as soon as its slowest task is done.
+ * The thread submitting a batch works on it as well.
+ */
+class worker_pool : non_copyable_mixin<worker_pool> {
+ public:
+  using task_fn = function<void()>;
+
+  explicit worker_pool(size_t workers);
+  ~worker_pool();
+
+  size_t size() const;
+
+  void run(vector<task_fn>& tasks);
+
+ protected:
+  struct queue {
+    std::mutex lock;
+    std::deque<task_fn*> tasks;
+  };
+
+  void work(size_t index);
+  bool run_next(size_t index);
+
+ private:
+  /**
+   * One queue per worker, the last one belongs to the submitting thread
+   */
+  vector<unique_ptr<queue>> m_queues;
+
+  std::mutex m_run_lock;
+
+  std::mutex m_lock;
+  std::condition_variable m_wakeup;
+  std::condition_variable m_done;
+  std::atomic<size_t> m_queued{0};
+  std::atomic<size_t> m_remaining{0};
+  std::exception_ptr m_error;
+  bool m_active{true};
+
+  vector<std::thread> m_threads;
+};
+
+POLYBAR_NS_END
@@ -18,6 +18,27 @@ namespace drawtypes {
     bool zpad{false};
   };
 
+  /**
+   * Label text split up at its tokens
+   *
+   * Built once when a label is created and shared by all of its clones. Every
+   * occurrence of a token in the text becomes a slot, which is filled by
+   * label::replace_token.
+   */
+  struct label_template {
+    explicit label_template(const string& text, vector<token>&& tokens);
+
+    /**
+     * Text in front of each slot, the last entry follows the last slot
+     */
+    vector<string> literals;
+    /**
+     * Index of the token in tokens that fills each slot
+     */
+    vector<size_t> slots;
+    vector<token> tokens;
+  };
+
   class label : public non_copyable_mixin<label> {
    public:
     rgba m_foreground{};
@@ -40,7 +61,9 @@ namespace drawtypes {
     alignment m_alignment{alignment::LEFT};
     bool m_ellipsis{true};
 
-    explicit label(string text, int font) : m_font(font), m_text(text), m_tokenized(m_text) {}
+    explicit label(string text, int font) : m_font(font) {
+      set_template(make_shared<const label_template>(text, vector<token>{}));
+    }
     explicit label(string text, rgba foreground = rgba{}, rgba background = rgba{}, rgba underline = rgba{},
         rgba overline = rgba{}, int font = 0, struct side_values padding = {0U, 0U},
         struct side_values margin = {0U, 0U}, int minlen = 0, size_t maxlen = 0_z,
@@ -55,11 +78,9 @@ namespace drawtypes {
         , m_minlen(minlen)
         , m_maxlen(maxlen)
         , m_alignment(label_alignment)
-        , m_ellipsis(ellipsis)
-        , m_text(text)
-        , m_tokenized(m_text)
-        , m_tokens(forward<vector<token>>(tokens)) {
+        , m_ellipsis(ellipsis) {
       assert(!m_ellipsis || (m_maxlen == 0 || m_maxlen >= 3));
+      set_template(make_shared<const label_template>(text, forward<vector<token>>(tokens)));
     }
 
     string get() const;
@@ -67,16 +88,49 @@ namespace drawtypes {
     label_t clone();
     void clear();
     void reset_tokens();
-    void reset_tokens(const string& tokenized);
     bool has_token(const string& token) const;
-    void replace_token(const string& token, string replacement);
+    void replace_token(const string& token, const string& replacement);
     void replace_defined_values(const label_t& label);
     void copy_undefined(const label_t& label);
 
+   protected:
+    void set_template(shared_ptr<const label_template> tmpl);
+    const string& tokenized() const;
+
    private:
-    string m_text{};
-    string m_tokenized{};
-    const vector<token> m_tokens{};
+    /**
+     * Label with the settings of the given one, sharing its template
+     *
+     * Used by clone(), does not allocate a template of its own.
+     */
+    explicit label(const label& source, shared_ptr<const label_template> tmpl)
+        : m_foreground(source.m_foreground)
+        , m_background(source.m_background)
+        , m_underline(source.m_underline)
+        , m_overline(source.m_overline)
+        , m_font(source.m_font)
+        , m_padding(source.m_padding)
+        , m_margin(source.m_margin)
+        , m_minlen(source.m_minlen)
+        , m_maxlen(source.m_maxlen)
+        , m_alignment(source.m_alignment)
+        , m_ellipsis(source.m_ellipsis) {
+      set_template(move(tmpl));
+    }
+
+    shared_ptr<const label_template> m_template;
+    /**
+     * Replacement in each slot of the template, if it was filled
+     */
+    vector<string> m_values;
+    vector<bool> m_filled;
+    bool m_cleared{false};
+
+    /**
+     * The text with the filled slots, rebuilt on demand into the same buffer
+     */
+    mutable string m_tokenized;
+    mutable bool m_outdated{true};
   };
 
   label_t load_label(const config& conf, const string& section, string name, bool required = true, string def = ""s);
@@ -1,15 +1,49 @@
 #pragma once
 
+#include <array>
+#include <atomic>
+#include <memory>
+
 #include "common.hpp"
 #include "components/logger.hpp"
+#include "events/signal_fwd.hpp"
 #include "events/signal_receiver.hpp"
+#include "utils/trace.hpp"
 
 POLYBAR_NS
 
+/**
+ * \brief Receiver attached to a signal
+ */
+struct signal_sink {
+  signal_receiver_interface::prio priority;
+  signal_receiver_interface* receiver;
+
+  /**
+   * The receiver as signal_receiver_impl of the signal it is attached to
+   */
+  void* impl;
+};
+
+using signal_sinks = vector<signal_sink>;
+
 /**
  * \brief Holds all signal receivers attached to the emitter
+ *
+ * Indexed by signals::index(), each list is sorted by priority. Lists are
+ * never modified, attaching or detaching a receiver replaces the list.
  */
-extern signal_receivers_t g_signal_receivers;
+extern std::array<shared_ptr<const signal_sinks>, signals::count()> g_signal_receivers;
+
+/**
+ * \brief Number of emits in flight for each signal, detach() waits for them
+ */
+extern std::array<std::atomic<size_t>, signals::count()> g_signal_readers;
+
+/**
+ * \brief Number of emits in flight on the current thread, for each signal
+ */
+extern thread_local std::array<size_t, signals::count()> g_signal_depth;
 
 /**
  * Wrapper used to delegate emitted signals
@@ -23,18 +57,31 @@ class signal_emitter {
   explicit signal_emitter() = default;
   virtual ~signal_emitter() {}
 
+  /**
+   * Deliver the signal to the attached receivers, in the order of their
+   * priority, until one of them handles it
+   *
+   * Safe to call concurrently with attach() and detach(). Receivers that are
+   * attached meanwhile may or may not get the signal, detach() waits until
+   * the emit is done.
+   */
   template <typename Signal>
   bool emit(const Signal& sig) {
+    trace_util::span span{"emit", trace_util::type_name<Signal>()};
+    reader_guard reader{signals::index<Signal>()};
+    auto sinks = std::atomic_load(&g_signal_receivers[signals::index<Signal>()]);
+    if (!sinks) {
+      return false;
+    }
+
     try {
-      if (g_signal_receivers.find(id<Signal>()) != g_signal_receivers.end()) {
-        for (auto&& item : g_signal_receivers.at(id<Signal>())) {
-          if (item.second->on(sig)) {
-            return true;
-          }
+      for (auto&& sink : *sinks) {
+        if (static_cast<signal_receiver_impl<Signal>*>(sink.impl)->on(sig)) {
+          return true;
         }
       }
     } catch (const std::exception& e) {
-      logger::make().err("Signal receiver raised an exception: %s", e.what());
+      POLYBAR_LOG_ERR(logger::make(), "Signal receiver raised an exception: %s", e.what());
     }
 
     return false;
@@ -56,52 +103,48 @@ class signal_emitter {
   }
 
  protected:
-  template <typename Signal>
-  std::type_index id() const {
-    return typeid(Signal);
-  }
+  /**
+   * Marks an emit as in flight for as long as it exists
+   */
+  struct reader_guard {
+    explicit reader_guard(size_t index) : m_index(index) {
+      g_signal_readers[m_index]++;
+      g_signal_depth[m_index]++;
+    }
+
+    ~reader_guard() {
+      g_signal_depth[m_index]--;
+      g_signal_readers[m_index]--;
+    }
+
+    size_t m_index;
+  };
 
   template <typename Receiver, typename Signal>
   void attach(Receiver* s) {
-    attach(s, id<Signal>());
+    attach(signals::index<Signal>(), {s->priority(), s, static_cast<signal_receiver_impl<Signal>*>(s)});
   }
 
   template <typename Receiver, typename Signal, typename Next, typename... Signals>
   void attach(Receiver* s) {
-    attach(s, id<Signal>());
+    attach<Receiver, Signal>(s);
     attach<Receiver, Next, Signals...>(s);
   }
 
-  void attach(signal_receiver_interface* s, std::type_index id) {
-    g_signal_receivers[id].emplace(s->priority(), s);
-  }
+  void attach(size_t index, signal_sink sink);
 
   template <typename Receiver, typename Signal>
   void detach(Receiver* s) {
-    detach(s, id<Signal>());
+    detach(signals::index<Signal>(), s);
   }
 
   template <typename Receiver, typename Signal, typename Next, typename... Signals>
   void detach(Receiver* s) {
-    detach(s, id<Signal>());
+    detach<Receiver, Signal>(s);
     detach<Receiver, Next, Signals...>(s);
   }
 
-  void detach(signal_receiver_interface* d, std::type_index id) {
-    try {
-      auto& prio_map = g_signal_receivers.at(id);
-      const auto& prio_sink_pair = prio_map.equal_range(d->priority());
-
-      for (auto it = prio_sink_pair.first; it != prio_sink_pair.second;) {
-        if (d == it->second) {
-          it = prio_map.erase(it);
-        } else {
-          ++it;
-        }
-      }
-    } catch (...) {
-    }
-  }
+  void detach(size_t index, signal_receiver_interface* s);
 };
 
 POLYBAR_NS_END
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <type_traits>
+
 #include "common.hpp"
 
 POLYBAR_NS
@@ -44,6 +46,51 @@ namespace signals {
   namespace ui_tray {
     struct mapped_clients;
   }
+
+  template <typename... Signals>
+  struct list {};
+
+  /**
+   * All signals, the position of a signal in this list is its slot in the
+   * dispatch table of the signal_emitter
+   */
+  using all = list<eventqueue::start, eventqueue::exit_terminate, eventqueue::exit_reload, eventqueue::notify_change,
+      eventqueue::notify_forcechange, eventqueue::check_state, ipc::command, ipc::hook, ipc::action, ui::ready,
+      ui::changed, ui::tick, ui::button_press, ui::cursor_change, ui::visibility_change, ui::dim_window,
+      ui::shade_window, ui::unshade_window, ui::request_snapshot, ui::update_background, ui::update_geometry,
+      ui_tray::mapped_clients>;
+
+  namespace detail {
+    template <typename Signal, typename List>
+    struct index_of {
+      static_assert(!std::is_same<Signal, Signal>::value, "Signal is missing from signals::all");
+    };
+
+    template <typename Signal, typename... Rest>
+    struct index_of<Signal, list<Signal, Rest...>> : std::integral_constant<size_t, 0> {};
+
+    template <typename Signal, typename First, typename... Rest>
+    struct index_of<Signal, list<First, Rest...>>
+        : std::integral_constant<size_t, 1 + index_of<Signal, list<Rest...>>::value> {};
+
+    template <typename List>
+    struct count;
+
+    template <typename... Signals>
+    struct count<list<Signals...>> : std::integral_constant<size_t, sizeof...(Signals)> {};
+  }  // namespace detail
+
+  /**
+   * Slot of the given signal in the dispatch table
+   */
+  template <typename Signal>
+  constexpr size_t index() {
+    return detail::index_of<Signal, all>::value;
+  }
+
+  constexpr size_t count() {
+    return detail::count<all>::value;
+  }
 }  // namespace signals
 
 POLYBAR_NS_END
@@ -22,7 +22,7 @@ namespace modules {
    public:
     explicit backlight_module(const bar_settings&, string);
 
-    void idle();
+    chrono::milliseconds idle_interval() const;
     bool on_event(inotify_event* event);
     bool build(builder* builder, const string& tag) const;
 
@@ -50,7 +50,6 @@ namespace modules {
 
     void start() override;
     void teardown();
-    void idle();
     bool on_event(inotify_event* event);
     string get_format() const;
     bool build(builder* builder, const string& tag) const;
@@ -64,6 +63,7 @@ namespace modules {
     string current_time();
     string current_consumption();
     void subthread();
+    void poll();
 
    private:
     static constexpr const char* FORMAT_CHARGING{"format-charging"};
@@ -114,6 +114,7 @@ namespace modules {
     chrono::duration<double> m_interval{};
     chrono::system_clock::time_point m_lastpoll;
     thread m_subthread;
+    eventloop::handle_t m_polltimer{0};
   };
 }  // namespace modules
 
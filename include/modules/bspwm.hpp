@@ -42,6 +42,7 @@ namespace modules {
     explicit bspwm_module(const bar_settings&, string);
 
     void stop() override;
+    int get_event_fd();
     bool has_event();
     bool update();
     string get_output();
@@ -39,6 +39,7 @@ namespace modules {
    public:
     explicit fs_module(const bar_settings&, string);
 
+    bool blocking_update() const;
     bool update();
     string get_format() const;
     string get_output();
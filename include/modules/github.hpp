@@ -14,6 +14,7 @@ namespace modules {
    public:
     explicit github_module(const bar_settings&, string);
 
+    bool blocking_update() const;
     bool update();
     bool build(builder* builder, const string& tag) const;
     string get_format() const;
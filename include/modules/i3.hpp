@@ -56,6 +56,7 @@ namespace modules {
     explicit i3_module(const bar_settings&, string);
 
     void stop() override;
+    int get_event_fd();
     bool has_event();
     bool update();
     bool build(builder* builder, const string& tag) const;
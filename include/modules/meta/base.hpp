@@ -4,15 +4,19 @@
 #include <chrono>
 #include <condition_variable>
 #include <map>
+#include <memory>
 #include <mutex>
 
 #include "common.hpp"
+#include "components/logger.hpp"
+#include "components/metrics.hpp"
 #include "components/types.hpp"
 #include "errors.hpp"
 #include "utils/concurrency.hpp"
 #include "utils/functional.hpp"
 #include "utils/inotify.hpp"
 #include "utils/string.hpp"
+#include "utils/trace.hpp"
 POLYBAR_NS
 
 namespace chrono = std::chrono;
@@ -57,8 +61,35 @@ namespace modules {
   // class definition : module_format {{{
 
   struct module_format {
+    /**
+     * \brief A tag of the format together with the text in front of it
+     */
+    struct segment {
+      string text;
+      /**
+       * \brief The text without leading spaces, used until a tag was built
+       */
+      string trimmed;
+      string tag;
+      /**
+       * \brief Position of the tag in tags, string::npos if it is not allowed
+       */
+      size_t id;
+    };
+
+    static constexpr size_t MASK_BITS{64};
+
     string value{};
+    /**
+     * \brief Tags allowed in the format, the position of a tag is its id
+     */
     vector<string> tags{};
+    /**
+     * \brief The value split up at its tags, see compile()
+     */
+    vector<segment> segments{};
+    string tail{};
+    uint64_t tag_mask{0};
     label_t prefix{};
     label_t suffix{};
     rgba fg{};
@@ -74,6 +105,8 @@ namespace modules {
     int font{0};
 
     string decorate(builder* builder, string output);
+    void compile();
+    bool has(const string& tag) const;
   };
 
   // }}}
@@ -119,6 +152,11 @@ namespace modules {
     virtual bool running() const = 0;
     virtual bool visible() const = 0;
 
+    /**
+     * Whether the output changed since contents() was last called
+     */
+    virtual bool changed() const = 0;
+
     /**
      * Handle action, possibly with data attached
      *
@@ -133,6 +171,19 @@ namespace modules {
     virtual void stop() = 0;
     virtual void halt(string error_message) = 0;
     virtual string contents() = 0;
+
+    /**
+     * Timings of the module updates and output generation
+     */
+    virtual const module_metrics& metrics() const = 0;
+
+    /**
+     * Report changes through the given handler instead of emitting the
+     * notify_change signal
+     *
+     * Has to be set before the module is started.
+     */
+    virtual void set_change_handler(callback<> handler) = 0;
   };
 
   // }}}
@@ -155,16 +206,21 @@ namespace modules {
     bool running() const override;
 
     bool visible() const override;
+    bool changed() const override;
 
     void stop() override;
     void halt(string error_message) override;
     void teardown();
     string contents() override;
+    const module_metrics& metrics() const override;
+    void set_change_handler(callback<> handler) override;
 
     bool input(const string& action, const string& data) final override;
 
    protected:
     void broadcast();
+    void publish();
+    void notify();
     void idle();
     void sleep(chrono::duration<double> duration);
     template <class Clock, class Duration>
@@ -172,6 +228,7 @@ namespace modules {
     void wakeup();
     string get_format() const;
     string get_output();
+    std::unique_lock<std::mutex> lock_update();
 
     void set_visible(bool value);
 
@@ -189,6 +246,7 @@ namespace modules {
 
     mutex m_buildlock;
     mutex m_updatelock;
+    mutex m_publishlock;
     mutex m_sleeplock;
     std::condition_variable m_sleephandler;
 
@@ -201,11 +259,28 @@ namespace modules {
 
     bool m_handle_events{true};
 
+    module_metrics m_metrics;
+
    private:
+    callback<> m_change_handler;
+
     atomic<bool> m_enabled{true};
     atomic<bool> m_visible{true};
-    atomic<bool> m_changed{true};
-    string m_cache;
+    /**
+     * Whether a snapshot was published since contents() was last called
+     */
+    atomic<bool> m_changed{false};
+
+    /**
+     * Whether the output was broadcast from the module event loop and still
+     * has to be built
+     */
+    atomic<bool> m_stale{false};
+
+    /**
+     * Last built output, replaced as a whole and never modified
+     */
+    shared_ptr<const string> m_output;
   };
 
   // }}}
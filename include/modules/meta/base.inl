@@ -2,6 +2,7 @@
 
 #include "components/builder.hpp"
 #include "components/config.hpp"
+#include "components/eventloop.hpp"
 #include "components/logger.hpp"
 #include "events/signal.hpp"
 #include "events/signal_emitter.hpp"
@@ -34,7 +35,7 @@ namespace modules {
 
   template <typename Impl>
   module<Impl>::~module() noexcept {
-    m_log.trace("%s: Deconstructing", name());
+    POLYBAR_LOG_TRACE(m_log, "%s: Deconstructing", name());
 
     for (auto&& thread_ : m_threads) {
       if (thread_.joinable()) {
@@ -71,13 +72,18 @@ namespace modules {
     return static_cast<bool>(m_visible);
   }
 
+  template <typename Impl>
+  bool module<Impl>::changed() const {
+    return m_changed || m_stale;
+  }
+
   template <typename Impl>
   void module<Impl>::stop() {
     if (!static_cast<bool>(m_enabled)) {
       return;
     }
 
-    m_log.info("%s: Stopping", name());
+    POLYBAR_LOG_INFO(m_log, "%s: Stopping", name());
     m_enabled = false;
 
     std::lock(m_buildlock, m_updatelock);
@@ -87,35 +93,57 @@ namespace modules {
       CAST_MOD(Impl)->wakeup();
       CAST_MOD(Impl)->teardown();
 
+      // Let the controller remove the output of the stopped module
+      notify();
       m_sig.emit(signals::eventqueue::check_state{});
     }
   }
 
   template <typename Impl>
   void module<Impl>::halt(string error_message) {
-    m_log.err("%s: %s", name(), error_message);
-    m_log.notice("Stopping '%s'...", name());
+    POLYBAR_LOG_ERR(m_log, "%s: %s", name(), error_message);
+    POLYBAR_LOG_NOTICE(m_log, "Stopping '%s'...", name());
     stop();
   }
 
   template <typename Impl>
   void module<Impl>::teardown() {}
 
+  /**
+   * Latest published output
+   *
+   * Output broadcast from the module event loop is built here, on the
+   * thread reading it, but only if the module is not updating right now.
+   * Otherwise the previous snapshot is returned and the module is marked
+   * as changed again, so that the next read builds it. This never waits
+   * for the module.
+   */
   template <typename Impl>
   string module<Impl>::contents() {
-    if (m_changed) {
-      m_log.info("%s: Rebuilding cache", name());
-      m_cache = CAST_MOD(Impl)->get_output();
-      // Make sure builder is really empty
-      m_builder->flush();
-      if (!m_cache.empty()) {
-        // Add a reset tag after the module
-        m_builder->control(tags::controltag::R);
-        m_cache += m_builder->flush();
+    if (m_stale.exchange(false)) {
+      std::unique_lock<std::mutex> guard(m_updatelock, std::try_to_lock);
+      if (guard.owns_lock()) {
+        publish();
+      } else {
+        m_stale = true;
+        notify();
       }
-      m_changed = false;
     }
-    return m_cache;
+
+    // Cleared before loading, a snapshot published in between sets it again
+    m_changed = false;
+    auto output = std::atomic_load(&m_output);
+    return output ? *output : ""s;
+  }
+
+  template <typename Impl>
+  const module_metrics& module<Impl>::metrics() const {
+    return m_metrics;
+  }
+
+  template <typename Impl>
+  void module<Impl>::set_change_handler(callback<> handler) {
+    m_change_handler = move(handler);
   }
 
   template <typename Impl>
@@ -127,7 +155,8 @@ namespace modules {
     try {
       m_router->invoke(name, data);
     } catch (const exception& err) {
-      m_log.err("%s: Failed to handle command '%s' with data '%s' (%s)", this->name(), name, data, err.what());
+      POLYBAR_LOG_ERR(m_log, "%s: Failed to handle command '%s' with data '%s' (%s)", this->name(), name, data,
+          err.what());
     }
     return true;
   }
@@ -137,8 +166,61 @@ namespace modules {
 
   template <typename Impl>
   void module<Impl>::broadcast() {
-    m_changed = true;
-    m_sig.emit(signals::eventqueue::notify_change{});
+    m_metrics.broadcasts.fetch_add(1, std::memory_order_relaxed);
+    if (eventloop::make().in_loop_thread()) {
+      // Don't hold up the other modules on the shared event loop, the
+      // output is built by the next call to contents()
+      m_stale = true;
+    } else {
+      publish();
+    }
+    notify();
+  }
+
+  /**
+   * Build the output and publish it as the new snapshot for contents()
+   *
+   * Nothing is built while the module is stopped or hidden, showing the
+   * module again broadcasts.
+   */
+  template <typename Impl>
+  void module<Impl>::publish() {
+    if (!running() || !visible()) {
+      return;
+    }
+
+    std::lock_guard<std::mutex> guard(m_publishlock);
+    POLYBAR_LOG_INFO(m_log, "%s: Rebuilding cache", name());
+    trace_util::span span{"build", m_name};
+    auto timer = m_metrics.build.measure();
+
+    try {
+      auto output = CAST_MOD(Impl)->get_output();
+      // Make sure builder is really empty
+      m_builder->flush();
+      if (!output.empty()) {
+        // Add a reset tag after the module
+        m_builder->control(tags::controltag::R);
+        output += m_builder->flush();
+      }
+      std::atomic_store(&m_output, shared_ptr<const string>(make_shared<string>(move(output))));
+      m_changed = true;
+    } catch (const exception& err) {
+      m_builder->flush();
+      POLYBAR_LOG_ERR(m_log, "%s: Failed to build output (reason: %s)", name(), err.what());
+    }
+  }
+
+  /**
+   * Tell the controller that the output of this module needs to be fetched
+   */
+  template <typename Impl>
+  void module<Impl>::notify() {
+    if (m_change_handler) {
+      m_change_handler();
+    } else {
+      m_sig.emit(signals::eventqueue::notify_change{});
+    }
   }
 
   template <typename Impl>
@@ -167,7 +249,7 @@ namespace modules {
 
   template <typename Impl>
   void module<Impl>::wakeup() {
-    m_log.trace("%s: Release sleep lock", name());
+    POLYBAR_LOG_TRACE(m_log, "%s: Release sleep lock", name());
     m_sleephandler.notify_all();
   }
 
@@ -178,59 +260,58 @@ namespace modules {
 
   template <typename Impl>
   string module<Impl>::get_output() {
+    auto lock_start = histogram::clock::now();
     std::lock_guard<std::mutex> guard(m_buildlock);
+    m_metrics.build_lock.record(histogram::clock::now() - lock_start);
     auto format_name = CONST_MOD(Impl).get_format();
     auto format = m_formatter->get(format_name);
     bool no_tag_built{true};
-    bool fake_no_tag_built{false};
     bool tag_built{false};
     auto mingap = std::max(1_z, format->spacing);
-    size_t start, end;
-    string value{format->value};
-    while ((start = value.find('<')) != string::npos && (end = value.find('>', start)) != string::npos) {
-      if (start > 0) {
-        if (no_tag_built) {
-          // If no module tag has been built we do not want to add
-          // whitespace defined between the format tags, but we do still
-          // want to output other non-tag content
-          auto trimmed = string_util::ltrim(value.substr(0, start), ' ');
-          if (!trimmed.empty()) {
-            fake_no_tag_built = false;
-            m_builder->node(move(trimmed));
-          }
-        } else {
-          m_builder->node(value.substr(0, start));
+
+    for (auto&& segment : format->segments) {
+      if (no_tag_built) {
+        // If no module tag has been built we do not want to add
+        // whitespace defined between the format tags, but we do still
+        // want to output other non-tag content
+        if (!segment.trimmed.empty()) {
+          m_builder->node(segment.trimmed);
         }
-        value.erase(0, start);
-        end -= start;
-        start = 0;
+      } else {
+        if (!segment.text.empty()) {
+          m_builder->node(segment.text);
+        }
+        m_builder->space(format->spacing);
+      }
+      if (!(tag_built = CONST_MOD(Impl).build(m_builder.get(), segment.tag)) && !no_tag_built) {
+        m_builder->remove_trailing_space(mingap);
       }
-      string tag{value.substr(start, end + 1)};
-      if (tag.empty()) {
-        continue;
-      } else if (tag[0] == '<' && tag[tag.size() - 1] == '>') {
-        if (!no_tag_built)
-          m_builder->space(format->spacing);
-        else if (fake_no_tag_built)
-          no_tag_built = false;
-        if (!(tag_built = CONST_MOD(Impl).build(m_builder.get(), tag)) && !no_tag_built)
-          m_builder->remove_trailing_space(mingap);
-        if (tag_built)
-          no_tag_built = false;
+      if (tag_built) {
+        no_tag_built = false;
       }
-      value.erase(0, tag.size());
     }
 
-    if (!value.empty()) {
-      m_builder->append(value);
+    if (!format->tail.empty()) {
+      m_builder->append(format->tail);
     }
 
     return format->decorate(&*m_builder, m_builder->flush());
   }
 
+  /**
+   * Acquire the update lock, the time spent waiting for it is recorded
+   */
+  template <typename Impl>
+  std::unique_lock<std::mutex> module<Impl>::lock_update() {
+    auto start = histogram::clock::now();
+    std::unique_lock<std::mutex> guard(m_updatelock);
+    m_metrics.update_lock.record(histogram::clock::now() - start);
+    return guard;
+  }
+
   template <typename Impl>
   void module<Impl>::set_visible(bool value) {
-    m_log.notice("%s: Visibility changed (state=%s)", m_name, value ? "shown" : "hidden");
+    POLYBAR_LOG_NOTICE(m_log, "%s: Visibility changed (state=%s)", m_name, value ? "shown" : "hidden");
     m_visible = value;
     broadcast();
   }
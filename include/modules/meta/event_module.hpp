@@ -1,5 +1,6 @@
 #pragma once
 
+#include "components/eventloop.hpp"
 #include "modules/meta/base.hpp"
 
 POLYBAR_NS
@@ -11,22 +12,47 @@ namespace modules {
     using module<Impl>::module;
 
     void start() override {
-      this->m_mainthread = thread(&event_module::runner, this);
+      if (CAST_MOD(Impl)->get_event_fd() == -1) {
+        this->m_mainthread = thread(&event_module::runner, this);
+        return;
+      }
+
+      auto& loop = eventloop::make();
+      // warm up module output before attaching the event fd
+      m_retry = loop.add_timer(eventloop::clock::now(), [this] { warmup(); });
+      loop.start();
+    }
+
+    void stop() override {
+      detach();
+      module<Impl>::stop();
     }
 
    protected:
+    /**
+     * File descriptor that becomes readable when has_event() would
+     * return without blocking.
+     *
+     * Modules returning -1 (the default) are polled from their own thread.
+     */
+    int get_event_fd() {
+      return -1;
+    }
+
     void runner() {
-      this->m_log.trace("%s: Thread id = %i", this->name(), concurrency_util::thread_id(this_thread::get_id()));
+      POLYBAR_LOG_TRACE(this->m_log, "%s: Thread id = %i", this->name(),
+          concurrency_util::thread_id(this_thread::get_id()));
+      trace_util::thread_name(this->m_name);
       try {
         // warm up module output before entering the loop
-        std::unique_lock<std::mutex> guard(this->m_updatelock);
-        CAST_MOD(Impl)->update();
+        auto guard = this->lock_update();
+        timed_update();
         CAST_MOD(Impl)->broadcast();
         guard.unlock();
 
         const auto check = [&]() -> bool {
-          std::lock_guard<std::mutex> guard(this->m_updatelock);
-          return CAST_MOD(Impl)->has_event() && CAST_MOD(Impl)->update();
+          auto guard = this->lock_update();
+          return CAST_MOD(Impl)->has_event() && timed_update();
         };
 
         while (this->running()) {
@@ -39,6 +65,90 @@ namespace modules {
         CAST_MOD(Impl)->halt(err.what());
       }
     }
+
+    void warmup() {
+      if (!this->running()) {
+        return;
+      }
+      try {
+        {
+          auto guard = this->lock_update();
+          timed_update();
+        }
+        CAST_MOD(Impl)->broadcast();
+        attach();
+      } catch (const exception& err) {
+        CAST_MOD(Impl)->halt(err.what());
+      }
+    }
+
+    /**
+     * Called from the event loop when the event fd is ready
+     */
+    void on_ready(unsigned int events) {
+      if (!this->running()) {
+        return;
+      }
+      try {
+        bool changed{false};
+        {
+          auto guard = this->lock_update();
+          changed = CAST_MOD(Impl)->has_event() && timed_update();
+        }
+        if (changed) {
+          CAST_MOD(Impl)->broadcast();
+        }
+
+        // The module reconnected or the peer hung up: give it a moment
+        // to settle before attaching the (possibly new) descriptor
+        if (events & (EPOLLHUP | EPOLLERR) || CAST_MOD(Impl)->get_event_fd() != m_fd) {
+          eventloop::make().remove(m_handle.exchange(0));
+          if (!m_detached) {
+            m_retry = eventloop::make().add_timer(eventloop::clock::now() + 25ms, [this] { attach(); });
+          }
+        }
+      } catch (const exception& err) {
+        CAST_MOD(Impl)->halt(err.what());
+      }
+    }
+
+    /**
+     * Update the module, has to be called with the update lock held
+     */
+    bool timed_update() {
+      trace_util::span span{"update", this->m_name};
+      auto timer = this->m_metrics.update.measure();
+      return CAST_MOD(Impl)->update();
+    }
+
+    void attach() {
+      auto& loop = eventloop::make();
+      loop.remove(m_retry.exchange(0));
+      if (m_detached || (m_fd = CAST_MOD(Impl)->get_event_fd()) == -1) {
+        return;
+      }
+      m_handle = loop.add_fd(m_fd, EPOLLIN, [this](int, unsigned int events) { on_ready(events); });
+    }
+
+    /**
+     * Unregister from the event loop
+     *
+     * A callback already in flight may register one more handle of the
+     * other kind before it notices m_detached, hence the second pass
+     */
+    void detach() {
+      auto& loop = eventloop::make();
+      m_detached = true;
+      loop.remove(m_retry.exchange(0));
+      loop.remove(m_handle.exchange(0));
+      loop.remove(m_retry.exchange(0));
+    }
+
+   private:
+    int m_fd{-1};
+    atomic<bool> m_detached{false};
+    atomic<eventloop::handle_t> m_handle{0};
+    atomic<eventloop::handle_t> m_retry{0};
   };
 }  // namespace modules
 
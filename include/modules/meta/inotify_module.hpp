@@ -1,6 +1,7 @@
 #pragma once
 
 #include "components/builder.hpp"
+#include "components/eventloop.hpp"
 #include "modules/meta/base.hpp"
 
 POLYBAR_NS
@@ -12,81 +13,154 @@ namespace modules {
     using module<Impl>::module;
 
     void start() override {
-      this->m_mainthread = thread(&inotify_module::runner, this);
+      auto& loop = eventloop::make();
+      // Warm up module output before attaching the watches
+      schedule(eventloop::clock::now(), [this] { warmup(); });
+      loop.start();
+    }
+
+    void stop() override {
+      detach();
+      module<Impl>::stop();
     }
 
    protected:
-    void runner() {
-      this->m_log.trace("%s: Thread id = %i", this->name(), concurrency_util::thread_id(this_thread::get_id()));
-      try {
-        // Warm up module output before entering the loop
-        std::unique_lock<std::mutex> guard(this->m_updatelock);
-        CAST_MOD(Impl)->on_event(nullptr);
-        CAST_MOD(Impl)->broadcast();
-        guard.unlock();
+    void watch(string path, int mask = IN_ALL_EVENTS) {
+      POLYBAR_LOG_TRACE(this->m_log, "%s: Attach inotify at %s", this->name(), path);
+      m_watchlist.insert(make_pair(path, mask));
+    }
+
+    /**
+     * Time to wait after an event before the watches are attached again
+     */
+    chrono::milliseconds idle_interval() const {
+      return 200ms;
+    }
 
-        while (this->running()) {
-          std::lock_guard<std::mutex> guard(this->m_updatelock);
-          CAST_MOD(Impl)->poll_events();
+    void warmup() {
+      try {
+        {
+          auto guard = this->lock_update();
+          trace_util::span span{"update", this->m_name};
+          auto timer = this->m_metrics.update.measure();
+          CAST_MOD(Impl)->on_event(nullptr);
         }
-      } catch (const module_error& err) {
-        CAST_MOD(Impl)->halt(err.what());
+        CAST_MOD(Impl)->broadcast();
+        attach();
       } catch (const std::exception& err) {
         CAST_MOD(Impl)->halt(err.what());
       }
     }
 
-    void watch(string path, int mask = IN_ALL_EVENTS) {
-      this->m_log.trace("%s: Attach inotify at %s", this->name(), path);
-      m_watchlist.insert(make_pair(path, mask));
-    }
+    /**
+     * Create the inotify watches and register them with the event loop
+     */
+    void attach() {
+      release();
 
-    void idle() {
-      this->sleep(200ms);
-    }
+      std::lock_guard<std::mutex> guard(m_watchlock);
 
-    void poll_events() {
-      vector<unique_ptr<inotify_watch>> watches;
+      if (m_detached) {
+        return;
+      }
 
       try {
         for (auto&& w : m_watchlist) {
-          watches.emplace_back(inotify_util::make_watch(w.first));
-          watches.back()->attach(w.second);
+          m_watches.emplace_back(inotify_util::make_watch(w.first));
+          m_watches.back()->attach(w.second);
         }
       } catch (const system_error& e) {
-        watches.clear();
-        this->m_log.err("%s: Error while creating inotify watch (what: %s)", this->name(), e.what());
-        CAST_MOD(Impl)->sleep(0.1s);
+        m_watches.clear();
+        POLYBAR_LOG_ERR(this->m_log, "%s: Error while creating inotify watch (what: %s)", this->name(), e.what());
+        m_handles.emplace_back(
+            eventloop::make().add_timer(eventloop::clock::now() + 100ms, [this] { attach(); }));
         return;
       }
 
-      while (this->running()) {
-        for (auto&& w : watches) {
-          this->m_log.trace_x("%s: Poll inotify watch %s", this->name(), w->path());
-
-          if (w->poll(1000 / watches.size())) {
-            auto event = w->get_event();
-
-            for (auto&& w : watches) {
-              w->remove(true);
-            }
+      for (size_t i = 0; i < m_watches.size(); i++) {
+        POLYBAR_LOG_TRACE_X(this->m_log, "%s: Register inotify watch %s", this->name(), m_watches[i]->path());
+        m_handles.emplace_back(eventloop::make().add_fd(
+            m_watches[i]->get_file_descriptor(), EPOLLIN, [this, i](int, unsigned int) { on_ready(i); }));
+      }
+    }
 
-            if (CAST_MOD(Impl)->on_event(event.get())) {
-              CAST_MOD(Impl)->broadcast();
-            }
-            CAST_MOD(Impl)->idle();
+    /**
+     * Called from the event loop when one of the watches reported an event
+     */
+    void on_ready(size_t index) {
+      try {
+        unique_ptr<inotify_event> event;
+        {
+          std::lock_guard<std::mutex> guard(m_watchlock);
+          if (index >= m_watches.size()) {
             return;
           }
+          event = m_watches[index]->get_event();
+        }
 
-          if (!this->running())
-            break;
+        release();
+
+        bool changed{false};
+        {
+          auto guard = this->lock_update();
+          trace_util::span span{"update", this->m_name};
+          auto timer = this->m_metrics.update.measure();
+          changed = this->running() && CAST_MOD(Impl)->on_event(event.get());
+        }
+        if (changed) {
+          CAST_MOD(Impl)->broadcast();
         }
-        CAST_MOD(Impl)->idle();
+
+        schedule(eventloop::clock::now() + CONST_MOD(Impl).idle_interval(), [this] { attach(); });
+      } catch (const std::exception& err) {
+        CAST_MOD(Impl)->halt(err.what());
+      }
+    }
+
+    void schedule(eventloop::clock::time_point when, eventloop::callback cb) {
+      std::lock_guard<std::mutex> guard(m_watchlock);
+      if (!m_detached) {
+        m_handles.emplace_back(eventloop::make().add_timer(when, move(cb)));
       }
     }
 
+    /**
+     * Unregister all handles and close the watches, called from the loop thread
+     */
+    void release() {
+      vector<eventloop::handle_t> handles;
+      vector<unique_ptr<inotify_watch>> watches;
+      {
+        std::lock_guard<std::mutex> guard(m_watchlock);
+        std::swap(handles, m_handles);
+        std::swap(watches, m_watches);
+      }
+      for (auto&& handle : handles) {
+        eventloop::make().remove(handle);
+      }
+      for (auto&& w : watches) {
+        w->remove(true);
+      }
+    }
+
+    /**
+     * Permanently unregister from the event loop
+     */
+    void detach() {
+      {
+        std::lock_guard<std::mutex> guard(m_watchlock);
+        m_detached = true;
+      }
+      release();
+    }
+
    private:
     map<string, int> m_watchlist;
+
+    mutex m_watchlock;
+    bool m_detached{false};
+    vector<unique_ptr<inotify_watch>> m_watches;
+    vector<eventloop::handle_t> m_handles;
   };
 }  // namespace modules
 
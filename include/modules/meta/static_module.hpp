@@ -12,13 +12,19 @@ namespace modules {
 
     void start() override {
       this->m_mainthread = thread([&] {
-        this->m_log.trace("%s: Thread id = %i", this->name(), concurrency_util::thread_id(this_thread::get_id()));
-        CAST_MOD(Impl)->update();
+        POLYBAR_LOG_TRACE(this->m_log, "%s: Thread id = %i", this->name(),
+            concurrency_util::thread_id(this_thread::get_id()));
+        trace_util::thread_name(this->m_name);
+        {
+          trace_util::span span{"update", this->m_name};
+          auto timer = this->m_metrics.update.measure();
+          CAST_MOD(Impl)->update();
+        }
         CAST_MOD(Impl)->broadcast();
       });
     }
 
-    bool build(builder*, string) const {
+    bool build(builder*, const string&) const {
       return true;
     }
   };
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "components/eventloop.hpp"
+#include "events/signal.hpp"
 #include "modules/meta/base.hpp"
 
 POLYBAR_NS
@@ -13,10 +15,46 @@ namespace modules {
     using module<Impl>::module;
 
     void start() override {
-      this->m_mainthread = thread(&timer_module::runner, this);
+      if (CAST_MOD(Impl)->blocking_update()) {
+        this->m_mainthread = thread(&timer_module::runner, this);
+      }
+
+      auto& loop = eventloop::make();
+      // warm up module output right away, then align with the interval
+      m_timer = loop.add_timer(eventloop::clock::now(), [this] { tick(); });
+      loop.start();
+    }
+
+    void stop() override {
+      eventloop::make().remove(m_timer.exchange(0));
+      module<Impl>::stop();
+
+      // Let the update thread see that the module stopped
+      { std::lock_guard<std::mutex> guard(m_duelock); }
+      m_due_cond.notify_all();
+    }
+
+    /**
+     * Fire the module timer immediately
+     */
+    void wakeup() {
+      if (m_timer) {
+        eventloop::make().reschedule(m_timer, eventloop::clock::now());
+      }
+      module<Impl>::wakeup();
     }
 
    protected:
+    /**
+     * Whether update() can block on I/O for a noticeable time
+     *
+     * Such modules are updated on their own thread whenever their timer
+     * expires, so they can't hold up the other modules on the event loop.
+     */
+    bool blocking_update() const {
+      return false;
+    }
+
     /**
      * Loads and sets the interval for this module.
      *
@@ -31,46 +69,110 @@ namespace modules {
       }
     }
 
+    /**
+     * Called from the event loop each time the module timer expires
+     *
+     * Timers expiring in the same slack window are dispatched in one round.
+     * Their outputs are only marked as changed, the controller is woken up
+     * once for all of them after the round.
+     */
+    void tick() {
+      if (!this->running()) {
+        return;
+      }
+
+      if (CAST_MOD(Impl)->blocking_update()) {
+        {
+          std::lock_guard<std::mutex> guard(m_duelock);
+          m_due = true;
+        }
+        m_due_cond.notify_all();
+        return;
+      }
+
+      run_update();
+    }
+
+    /**
+     * Update thread of modules with a blocking update()
+     *
+     * The timer is only rescheduled once an update is done, so updates
+     * never pile up while one of them is stuck.
+     */
     void runner() {
-      this->m_log.trace("%s: Thread id = %i", this->name(), concurrency_util::thread_id(this_thread::get_id()));
+      trace_util::thread_name(this->m_name);
+
+      while (true) {
+        {
+          std::unique_lock<std::mutex> guard(m_duelock);
+          m_due_cond.wait(guard, [&] { return m_due || !this->running(); });
+          if (!this->running()) {
+            break;
+          }
+          m_due = false;
+        }
 
-      const auto check = [&]() -> bool {
-        std::unique_lock<std::mutex> guard(this->m_updatelock);
-        return CAST_MOD(Impl)->update();
-      };
+        run_update();
+      }
+    }
 
+    /**
+     * Update the module output and schedule the next tick
+     */
+    void run_update() {
       try {
-        // warm up module output before entering the loop
-        check();
-        CAST_MOD(Impl)->broadcast();
-
-        while (this->running()) {
-          if (check()) {
-            CAST_MOD(Impl)->broadcast();
+        bool changed{false};
+        {
+          auto guard = this->lock_update();
+          if (!this->running()) {
+            // stopped while this update was waiting for the lock
+            return;
           }
-          // wait until next full interval to avoid drifting clocks
-          using clock = chrono::system_clock;
-          using sys_duration_t = clock::time_point::duration;
-
-          auto sys_interval = chrono::duration_cast<sys_duration_t>(m_interval);
-          clock::time_point now = clock::now();
-          sys_duration_t adjusted = sys_interval - (now.time_since_epoch() % sys_interval);
-
-          // The seemingly arbitrary addition of 500ms is due
-          // to the fact that if we wait the exact time our
-          // thread will be woken just a tiny bit prematurely
-          // and therefore the wrong time will be displayed.
-          // It is currently unknown why exactly the thread gets
-          // woken prematurely.
-          CAST_MOD(Impl)->sleep_until(now + adjusted + 500ms);
+          trace_util::span span{"update", this->m_name};
+          auto timer = this->m_metrics.update.measure();
+          changed = CAST_MOD(Impl)->update();
         }
+        // the first tick always broadcasts to warm up the module output
+        if (changed || !m_warm) {
+          this->broadcast();
+          m_warm = true;
+        }
+        eventloop::make().reschedule(m_timer, next_deadline());
       } catch (const exception& err) {
         CAST_MOD(Impl)->halt(err.what());
       }
     }
 
+    /**
+     * Wait until next full interval to avoid drifting clocks
+     *
+     * The event loop never fires a timer before its deadline, the
+     * deadline is rounded up to the end of its slack window instead.
+     */
+    eventloop::clock::time_point next_deadline() const {
+      using clock = eventloop::clock;
+      using sys_duration_t = clock::time_point::duration;
+
+      auto sys_interval = chrono::duration_cast<sys_duration_t>(m_interval);
+      clock::time_point now = clock::now();
+      sys_duration_t adjusted = sys_interval - (now.time_since_epoch() % sys_interval);
+
+      return now + adjusted;
+    }
+
    protected:
     interval_t m_interval{1.0};
+
+   private:
+    atomic<eventloop::handle_t> m_timer{0};
+    bool m_warm{false};
+
+    /**
+     * Set by the timer if the update thread has to run update()
+     */
+    std::mutex m_duelock;
+    std::condition_variable m_due_cond;
+    bool m_due{false};
   };
 }  // namespace modules
 
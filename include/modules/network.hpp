@@ -14,6 +14,7 @@ namespace modules {
     explicit network_module(const bar_settings&, string);
 
     void teardown();
+    bool blocking_update() const;
     bool update();
     string get_format() const;
     bool build(builder* builder, const string& tag) const;
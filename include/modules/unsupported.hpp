@@ -30,6 +30,9 @@ namespace modules {
     bool visible() const override {                                                     \
       return false;                                                                     \
     }                                                                                   \
+    bool changed() const override {                                                     \
+      return false;                                                                     \
+    }                                                                                   \
     void start() override {}                                                            \
     void stop() override {}                                                             \
     void halt(string) override {}                                                       \
@@ -39,6 +42,12 @@ namespace modules {
     bool input(const string&, const string&) override {                                 \
       return false;                                                                     \
     }                                                                                   \
+    const module_metrics& metrics() const override {                                    \
+      return m_metrics;                                                                 \
+    }                                                                                   \
+                                                                                        \
+   private:                                                                             \
+    module_metrics m_metrics;                                                           \
   }
 
 #if not ENABLE_I3
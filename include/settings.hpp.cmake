@@ -20,6 +20,7 @@ extern const char* const APP_VERSION;
 #cmakedefine01 WITH_XKB
 #cmakedefine01 WITH_XRM
 #cmakedefine01 WITH_XCURSOR
+#cmakedefine01 WITH_XPRESENT
 
 #if WITH_XRANDR
 #cmakedefine01 WITH_XRANDR_MONITORS
@@ -29,8 +29,8 @@ namespace tags {
    * An action block is an area on the bar that executes some command when clicked.
    */
   struct action_block {
-    action_block(const string&& cmd, mousebtn button, alignment align, bool is_open)
-        : cmd(std::move(cmd)), button(button), align(align), is_open(is_open){};
+    action_block(const string& cmd, mousebtn button, alignment align, bool is_open)
+        : cmd(cmd), button(button), align(align), is_open(is_open){};
 
     string cmd;
     /**
@@ -77,7 +77,7 @@ namespace tags {
    public:
     void reset();
 
-    action_t action_open(mousebtn btn, const string&& cmd, alignment align, double x);
+    action_t action_open(mousebtn btn, const string& cmd, alignment align, double x);
     std::pair<action_t, mousebtn> action_close(mousebtn btn, alignment align, double x);
 
     void set_alignmnent_start(const alignment a, const double x);
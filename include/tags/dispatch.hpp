@@ -3,6 +3,7 @@
 #include "common.hpp"
 #include "components/renderer_interface.hpp"
 #include "errors.hpp"
+#include "tags/types.hpp"
 
 POLYBAR_NS
 
@@ -19,6 +20,8 @@ namespace tags {
   /**
    * Calls into the tag parser to parse the given formatting string and then
    * sends the right signals for each tag.
+   *
+   * Already parsed elements can be dispatched directly.
    */
   class dispatch {
    public:
@@ -27,11 +30,16 @@ namespace tags {
 
     explicit dispatch(const logger& logger, action_context& action_ctxt);
     void parse(const bar_settings& bar, renderer_interface&, const string&& data);
+    void parse(const bar_settings& bar, renderer_interface&, const format_string& elements);
+    void parse(const bar_settings& bar, renderer_interface&, const format_blocks& blocks);
 
    protected:
-    void handle_text(renderer_interface& renderer, string&& data);
-    void handle_action(renderer_interface& renderer, mousebtn btn, bool closing, const string&& cmd);
-    void handle_control(controltag ctrl);
+    void begin(const bar_settings& bar);
+    void end(renderer_interface& renderer);
+    void handle_element(renderer_interface& renderer, const element& el);
+    void handle_text(renderer_interface& renderer, const string& data);
+    void handle_action(renderer_interface& renderer, mousebtn btn, bool closing, const string& cmd);
+    void handle_control(renderer_interface& renderer, controltag ctrl, const string& data);
 
    private:
     const logger& m_log;
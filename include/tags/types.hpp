@@ -32,10 +32,15 @@ namespace tags {
    *
    * %{P...} tags are tags for internal polybar control commands, they are not
    * part of the public interface
+   *
+   * S and E have no tag representation, they are only ever inserted into
+   * already parsed elements.
    */
   enum class controltag {
     NONE = 0,
     R,  // Reset all open tags (B, F, T, o, u). Used at module edges
+    S,  // Start of the output of a single module, element data holds the whole output
+    E,  // End of the output of a single module
   };
 
   enum class color_type { RESET = 0, COLOR };
@@ -113,6 +118,12 @@ namespace tags {
 
   using format_string = vector<element>;
 
+  /**
+   * Parsed contents of the whole bar, split up into parts that are shared
+   * and never modified, like the alignment blocks
+   */
+  using format_blocks = vector<shared_ptr<const format_string>>;
+
 }  // namespace tags
 
 POLYBAR_NS_END
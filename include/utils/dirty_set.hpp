@@ -0,0 +1,40 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+#include "common.hpp"
+#include "utils/mixins.hpp"
+
+POLYBAR_NS
+
+/**
+ * Lock-free set of changed indices shared between many producers and a
+ * single consumer
+ *
+ * Producers mark an index as changed by setting its bit. Only the producer
+ * that marks the first index after the consumer took the set is told to wake
+ * up the consumer, all further marks are merged into the pending set until
+ * the consumer takes it.
+ */
+class dirty_set : non_copyable_mixin<dirty_set> {
+ public:
+  explicit dirty_set(size_t size);
+
+  size_t size() const;
+  bool pending() const;
+
+  bool mark(size_t index);
+  vector<bool> take();
+
+ private:
+  static constexpr size_t WORD_BITS{64};
+
+  const size_t m_size;
+  const size_t m_words;
+  std::unique_ptr<std::atomic<uint64_t>[]> m_bits;
+  std::atomic<bool> m_pending{false};
+};
+
+POLYBAR_NS_END
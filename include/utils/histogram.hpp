@@ -0,0 +1,66 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+#include "common.hpp"
+#include "utils/mixins.hpp"
+
+POLYBAR_NS
+
+namespace chrono = std::chrono;
+
+/**
+ * Lock-free histogram of durations
+ *
+ * The durations are counted in buckets of exponentially growing size, the
+ * first bucket holds everything below 1µs and bucket i everything in
+ * [2^(i-1), 2^i) µs. Recording only does relaxed atomic increments, so it
+ * can be done from any thread without synchronization. Reading while other
+ * threads record gives a consistent enough view for monitoring purposes.
+ */
+class histogram : non_copyable_mixin<histogram> {
+ public:
+  using clock = chrono::steady_clock;
+  static constexpr size_t BUCKETS{32};
+
+  /**
+   * Records the time between its construction and its destruction
+   */
+  class scope {
+   public:
+    explicit scope(histogram& h);
+    scope(scope&& other);
+    ~scope();
+
+   private:
+    histogram* m_histogram;
+    clock::time_point m_start;
+  };
+
+  void record(clock::duration d);
+  scope measure();
+  void reset();
+
+  uint64_t count() const;
+  clock::duration sum() const;
+  clock::duration max() const;
+  clock::duration mean() const;
+  clock::duration percentile(double p) const;
+  uint64_t bucket(size_t index) const;
+
+  static size_t bucket_index(clock::duration d);
+  static clock::duration bucket_limit(size_t index);
+
+  string to_json() const;
+
+ private:
+  std::array<std::atomic<uint64_t>, BUCKETS> m_buckets{};
+  std::atomic<uint64_t> m_count{0};
+  std::atomic<uint64_t> m_sum{0};
+  std::atomic<uint64_t> m_max{0};
+};
+
+POLYBAR_NS_END
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <algorithm>
+#include <list>
+#include <unordered_map>
+
+#include "common.hpp"
+
+POLYBAR_NS
+
+/**
+ * Cache with a fixed number of entries
+ *
+ * Once full, inserting a new entry evicts the least recently used one.
+ */
+template <typename Key, typename Value, typename Hash = std::hash<Key>>
+class lru_cache {
+ public:
+  explicit lru_cache(size_t capacity) : m_capacity(std::max<size_t>(capacity, 1)) {}
+
+  /**
+   * Get the cached value for the given key and mark it as most recently used
+   *
+   * \returns nullptr if the key is not cached
+   */
+  Value* get(const Key& key) {
+    auto it = m_index.find(key);
+    if (it == m_index.end()) {
+      return nullptr;
+    }
+    m_entries.splice(m_entries.begin(), m_entries, it->second);
+    return &it->second->second;
+  }
+
+  /**
+   * Insert or replace the value for the given key
+   *
+   * \returns Reference to the cached value, valid until it gets evicted
+   */
+  Value& put(const Key& key, Value value) {
+    auto it = m_index.find(key);
+    if (it != m_index.end()) {
+      it->second->second = move(value);
+      m_entries.splice(m_entries.begin(), m_entries, it->second);
+      return it->second->second;
+    }
+
+    if (m_entries.size() >= m_capacity) {
+      m_index.erase(m_entries.back().first);
+      m_entries.pop_back();
+    }
+
+    m_entries.emplace_front(key, move(value));
+    m_index.emplace(key, m_entries.begin());
+    return m_entries.front().second;
+  }
+
+  void clear() {
+    m_index.clear();
+    m_entries.clear();
+  }
+
+  size_t size() const {
+    return m_entries.size();
+  }
+
+  size_t capacity() const {
+    return m_capacity;
+  }
+
+ private:
+  using entry = std::pair<Key, Value>;
+
+  size_t m_capacity;
+  std::list<entry> m_entries;
+  std::unordered_map<Key, typename std::list<entry>::iterator, Hash> m_index;
+};
+
+POLYBAR_NS_END
@@ -25,6 +25,8 @@ namespace socket_util {
     bool peek(const size_t peek_bytes);
     bool poll(short int events = POLLIN, int timeout_ms = -1);
 
+    int get_file_descriptor() const;
+
    protected:
     int m_fd = -1;
     string m_socketpath;
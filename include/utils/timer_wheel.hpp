@@ -0,0 +1,68 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <unordered_map>
+
+#include "common.hpp"
+
+POLYBAR_NS
+
+namespace chrono = std::chrono;
+
+/**
+ * Hierarchical timer wheel
+ *
+ * Deadlines are rounded up to the wheel resolution, so all timers
+ * falling into the same slack window expire together. Each level
+ * has 64 slots and covers 64 times the range of the level below.
+ *
+ * The wheel only keeps track of deadlines, it is up to the caller
+ * to map the expired ids back to callbacks.
+ */
+class timer_wheel {
+ public:
+  using clock = chrono::system_clock;
+  using id_t = unsigned int;
+
+  explicit timer_wheel(clock::duration resolution, clock::time_point now = clock::now());
+
+  void schedule(id_t id, clock::time_point deadline);
+  bool cancel(id_t id);
+
+  bool empty() const;
+  size_t size() const;
+  clock::duration resolution() const;
+  clock::time_point next_expiry() const;
+
+  vector<id_t> expire(clock::time_point now);
+
+ protected:
+  static constexpr unsigned int LEVEL_BITS{6};
+  static constexpr unsigned int SLOTS{1 << LEVEL_BITS};
+  static constexpr unsigned int LEVELS{(64 + LEVEL_BITS - 1) / LEVEL_BITS};
+
+  struct entry {
+    uint64_t tick;
+    unsigned int level;
+    unsigned int slot;
+  };
+
+  uint64_t floor_tick(clock::time_point point) const;
+  uint64_t ceil_tick(clock::time_point point) const;
+  uint64_t next_tick() const;
+
+  void insert(id_t id, uint64_t tick);
+  void unlink(id_t id, const entry& e);
+  void advance(uint64_t tick);
+
+ private:
+  clock::duration m_resolution;
+  uint64_t m_current;
+
+  std::unordered_map<id_t, entry> m_entries;
+  std::array<std::array<vector<id_t>, SLOTS>, LEVELS> m_slots;
+};
+
+POLYBAR_NS_END
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <typeinfo>
+
+#include "common.hpp"
+
+POLYBAR_NS
+
+/**
+ * \brief Whether a trace is being recorded
+ */
+extern std::atomic<bool> g_tracing;
+
+/**
+ * Recording of the event and render pipeline in the Chrome trace event
+ * format, which can be loaded into chrome://tracing or Perfetto.
+ *
+ * Every thread records into its own ring buffer, a background thread
+ * regularly writes the buffers to the trace file. If a buffer runs full
+ * before it was written out, new events are dropped. While no trace is
+ * recorded, a span only costs checking an atomic flag.
+ */
+namespace trace_util {
+  inline bool enabled() {
+    return g_tracing.load(std::memory_order_relaxed);
+  }
+
+  uint64_t now();
+
+  void start(const string& path);
+  void stop();
+
+  void thread_name(const string& name);
+  void record(const char* name, const string* arg, uint64_t start, uint64_t end);
+
+  string demangle(const char* name);
+
+  /**
+   * Readable name of the given type
+   */
+  template <typename T>
+  const string& type_name() {
+    static const string name{demangle(typeid(T).name())};
+    return name;
+  }
+
+  /**
+   * Records the time between its construction and its destruction
+   *
+   * The argument is shown as detail of the span, it has to outlive the span.
+   */
+  class span {
+   public:
+    explicit span(const char* name) : span(name, nullptr) {}
+    explicit span(const char* name, const string& arg) : span(name, &arg) {}
+
+    ~span() {
+      if (m_start != 0) {
+        record(m_name, m_arg, m_start, now());
+      }
+    }
+
+    span(const span&) = delete;
+    span& operator=(const span&) = delete;
+
+   private:
+    span(const char* name, const string* arg) : m_name(name), m_arg(arg), m_start(enabled() ? now() : 0) {}
+
+    const char* m_name;
+    const string* m_arg;
+    uint64_t m_start;
+  };
+}  // namespace trace_util
+
+POLYBAR_NS_END
@@ -11,3 +11,6 @@
 #if WITH_XKB
 #include "x11/extensions/xkb.hpp"
 #endif
+#if WITH_XPRESENT
+#include "x11/extensions/present.hpp"
+#endif
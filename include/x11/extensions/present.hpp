@@ -0,0 +1,69 @@
+#pragma once
+
+#include "settings.hpp"
+
+#if not WITH_XPRESENT
+#error "X Present extension is disabled..."
+#endif
+
+#include <xcb/present.h>
+
+#include <unordered_map>
+
+#include "common.hpp"
+#include "utils/mixins.hpp"
+#include "x11/types.hpp"
+
+POLYBAR_NS
+
+// fwd
+class connection;
+
+namespace present_util {
+  bool query_extension(connection& conn);
+}
+
+/**
+ * \brief Presents pixmaps on a window through the X Present extension
+ *
+ * The pixmaps are shown in sync with the vertical blank of the monitor. The
+ * server reports when a presentation was executed and when a pixmap is no
+ * longer needed by it, which lets the caller only draw into pixmaps that are
+ * idle and keep at most one frame in flight. Nothing here blocks waiting for
+ * the server, the events are only polled.
+ *
+ * The notifications are delivered through their own event queue, all methods
+ * have to be called from the same thread.
+ */
+class present_window : non_copyable_mixin<present_window> {
+ public:
+  explicit present_window(connection& conn, xcb_window_t window);
+  ~present_window();
+
+  void present(xcb_pixmap_t pixmap);
+  bool done();
+  bool idle(xcb_pixmap_t pixmap);
+
+ protected:
+  bool process();
+  void handle(const xcb_generic_event_t* evt);
+
+ private:
+  connection& m_connection;
+  xcb_window_t m_window;
+  uint32_t m_eid;
+  xcb_special_event_t* m_events{nullptr};
+
+  /**
+   * Serial of the newest presentation and of the newest one that was executed
+   */
+  uint32_t m_serial{0};
+  uint32_t m_completed{0};
+
+  /**
+   * Number of presentations still holding on to each pixmap
+   */
+  std::unordered_map<xcb_pixmap_t, size_t> m_busy;
+};
+
+POLYBAR_NS_END
@@ -6,6 +6,7 @@
 #include "cairo/context.hpp"
 #include "cairo/surface.hpp"
 #include "common.hpp"
+#include "components/eventloop.hpp"
 #include "components/logger.hpp"
 #include "components/types.hpp"
 #include "events/signal_fwd.hpp"
@@ -71,9 +72,10 @@ class tray_manager : public xpp::event::sink<evt::expose, evt::visibility_notify
                          signals::ui::update_background> {
  public:
   using make_type = unique_ptr<tray_manager>;
-  static make_type make();
+  static make_type make(eventloop& loop);
 
-  explicit tray_manager(connection& conn, signal_emitter& emitter, const logger& logger, background_manager& back);
+  explicit tray_manager(connection& conn, signal_emitter& emitter, const logger& logger, background_manager& back,
+      eventloop& loop);
 
   ~tray_manager();
 
@@ -163,7 +165,15 @@ class tray_manager : public xpp::event::sink<evt::expose, evt::visibility_notify
   atomic<bool> m_hidden{false};
   atomic<bool> m_acquired_selection{false};
 
-  thread m_delaythread;
+  /**
+   * \brief Main thread event loop, the X events are handled on
+   */
+  eventloop& m_loop;
+
+  /**
+   * \brief Timer for notifying clients some time after activating
+   */
+  eventloop::handle_t m_notify_timer{0};
 
   mutex m_mtx{};
 
@@ -10,7 +10,7 @@
 
 POLYBAR_NS
 
-#define TRACE_BOOL(mode) m_log.trace("mpdconnection.%s: %s", __func__, mode ? "true" : "false");
+#define TRACE_BOOL(mode) POLYBAR_LOG_TRACE(m_log, "mpdconnection.%s: %s", __func__, mode ? "true" : "false");
 
 namespace mpd {
   sig_atomic_t g_connection_closed = 0;
@@ -142,7 +142,8 @@ namespace mpd {
 
   void mpdconnection::connect() {
     try {
-      m_log.trace("mpdconnection.connect: %s, %i, \"%s\", timeout: %i", m_host, m_port, m_password, m_timeout);
+      POLYBAR_LOG_TRACE(m_log, "mpdconnection.connect: %s, %i, \"%s\", timeout: %i", m_host, m_port, m_password,
+          m_timeout);
       m_connection.reset(mpd_connection_new(m_host.c_str(), m_port, m_timeout * 1000));
       check_errors(m_connection.get());
 
@@ -246,7 +247,7 @@ namespace mpd {
       mpd_run_play(m_connection.get());
       check_errors(m_connection.get());
     } catch (const mpd_exception& e) {
-      m_log.err("mpdconnection.play: %s", e.what());
+      POLYBAR_LOG_ERR(m_log, "mpdconnection.play: %s", e.what());
     }
   }
 
@@ -257,7 +258,7 @@ namespace mpd {
       mpd_run_pause(m_connection.get(), state);
       check_errors(m_connection.get());
     } catch (const mpd_exception& e) {
-      m_log.err("mpdconnection.pause: %s", e.what());
+      POLYBAR_LOG_ERR(m_log, "mpdconnection.pause: %s", e.what());
     }
   }
 
@@ -267,7 +268,7 @@ namespace mpd {
       mpd_run_toggle_pause(m_connection.get());
       check_errors(m_connection.get());
     } catch (const mpd_exception& e) {
-      m_log.err("mpdconnection.toggle: %s", e.what());
+      POLYBAR_LOG_ERR(m_log, "mpdconnection.toggle: %s", e.what());
     }
   }
 
@@ -277,7 +278,7 @@ namespace mpd {
       mpd_run_stop(m_connection.get());
       check_errors(m_connection.get());
     } catch (const mpd_exception& e) {
-      m_log.err("mpdconnection.stop: %s", e.what());
+      POLYBAR_LOG_ERR(m_log, "mpdconnection.stop: %s", e.what());
     }
   }
 
@@ -287,7 +288,7 @@ namespace mpd {
       mpd_run_previous(m_connection.get());
       check_errors(m_connection.get());
     } catch (const mpd_exception& e) {
-      m_log.err("mpdconnection.prev: %s", e.what());
+      POLYBAR_LOG_ERR(m_log, "mpdconnection.prev: %s", e.what());
     }
   }
 
@@ -297,7 +298,7 @@ namespace mpd {
       mpd_run_next(m_connection.get());
       check_errors(m_connection.get());
     } catch (const mpd_exception& e) {
-      m_log.err("mpdconnection.next: %s", e.what());
+      POLYBAR_LOG_ERR(m_log, "mpdconnection.next: %s", e.what());
     }
   }
 
@@ -307,7 +308,7 @@ namespace mpd {
       mpd_run_seek_id(m_connection.get(), songid, pos);
       check_errors(m_connection.get());
     } catch (const mpd_exception& e) {
-      m_log.err("mpdconnection.seek: %s", e.what());
+      POLYBAR_LOG_ERR(m_log, "mpdconnection.seek: %s", e.what());
     }
   }
 
@@ -318,7 +319,7 @@ namespace mpd {
       mpd_run_repeat(m_connection.get(), mode);
       check_errors(m_connection.get());
     } catch (const mpd_exception& e) {
-      m_log.err("mpdconnection.set_repeat: %s", e.what());
+      POLYBAR_LOG_ERR(m_log, "mpdconnection.set_repeat: %s", e.what());
     }
   }
 
@@ -329,7 +330,7 @@ namespace mpd {
       mpd_run_random(m_connection.get(), mode);
       check_errors(m_connection.get());
     } catch (const mpd_exception& e) {
-      m_log.err("mpdconnection.set_random: %s", e.what());
+      POLYBAR_LOG_ERR(m_log, "mpdconnection.set_random: %s", e.what());
     }
   }
 
@@ -340,7 +341,7 @@ namespace mpd {
       mpd_run_single(m_connection.get(), mode);
       check_errors(m_connection.get());
     } catch (const mpd_exception& e) {
-      m_log.err("mpdconnection.set_single: %s", e.what());
+      POLYBAR_LOG_ERR(m_log, "mpdconnection.set_single: %s", e.what());
     }
   }
 
@@ -351,7 +352,7 @@ namespace mpd {
       mpd_run_consume(m_connection.get(), mode);
       check_errors(m_connection.get());
     } catch (const mpd_exception& e) {
-      m_log.err("mpdconnection.set_consume: %s", e.what());
+      POLYBAR_LOG_ERR(m_log, "mpdconnection.set_consume: %s", e.what());
     }
   }
 
@@ -153,7 +153,7 @@ namespace net {
             continue;
           }
           if (inet_ntop(AF_INET6, &sa6->sin6_addr, ip6_buffer, INET6_ADDRSTRLEN) == 0) {
-            m_log.warn("inet_ntop() " + string(strerror(errno)));
+            POLYBAR_LOG_WARN(m_log, "inet_ntop() %s", strerror(errno));
             continue;
           }
           m_status.ip6 = string{ip6_buffer};
@@ -38,7 +38,7 @@ pulseaudio::pulseaudio(const logger& logger, string&& sink_name, bool max_volume
     throw pulseaudio_error("Could not start pulseaudio mainloop.");
   }
 
-  m_log.trace("pulseaudio: started mainloop");
+  POLYBAR_LOG_TRACE(m_log, "pulseaudio: started mainloop");
 
   pa_threaded_mainloop_wait(m_mainloop);
   if (pa_context_get_state(m_context) != PA_CONTEXT_READY) {
@@ -59,9 +59,9 @@ pulseaudio::pulseaudio(const logger& logger, string&& sink_name, bool max_volume
     // get the sink index
     op = pa_context_get_sink_info_by_name(m_context, DEFAULT_SINK, sink_info_callback, this);
     wait_loop(op, m_mainloop);
-    m_log.notice("pulseaudio: using default sink %s", s_name);
+    POLYBAR_LOG_NOTICE(m_log, "pulseaudio: using default sink %s", s_name);
   } else {
-    m_log.trace("pulseaudio: using sink %s", s_name);
+    POLYBAR_LOG_TRACE(m_log, "pulseaudio: using sink %s", s_name);
   }
 
   m_max_volume = max_volume ? PA_VOLUME_UI_MAX : PA_VOLUME_NORM;
@@ -134,7 +134,7 @@ int pulseaudio::process_events() {
         o = pa_context_get_sink_info_by_name(m_context, DEFAULT_SINK, sink_info_callback, this);
         wait_loop(o, m_mainloop);
         if (spec_s_name != s_name)
-          m_log.notice("pulseaudio: using default sink %s", s_name);
+          POLYBAR_LOG_NOTICE(m_log, "pulseaudio: using default sink %s", s_name);
         break;
       default:
         break;
@@ -189,7 +189,7 @@ void pulseaudio::inc_volume(int delta_perc) {
       // avoid rounding errors and set to m_max_volume directly
       pa_cvolume_scale(&cv, m_max_volume);
     } else {
-      m_log.notice("pulseaudio: maximum volume reached");
+      POLYBAR_LOG_NOTICE(m_log, "pulseaudio: maximum volume reached");
     }
   } else
     pa_cvolume_dec(&cv, vol);
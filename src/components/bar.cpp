@@ -3,7 +3,7 @@
 #include <algorithm>
 
 #include "components/config.hpp"
-#include "components/renderer.hpp"
+#include "components/window_renderer.hpp"
 #include "components/screen.hpp"
 #include "components/taskqueue.hpp"
 #include "components/types.hpp"
@@ -16,6 +16,7 @@
 #include "utils/factory.hpp"
 #include "utils/math.hpp"
 #include "utils/string.hpp"
+#include "utils/trace.hpp"
 #include "x11/atoms.hpp"
 #include "x11/connection.hpp"
 #include "x11/ewmh.hpp"
@@ -38,7 +39,7 @@ using namespace signals::ui;
 /**
  * Create instance
  */
-bar::make_type bar::make(bool only_initialize_values) {
+bar::make_type bar::make(eventloop& loop, bool only_initialize_values) {
   auto action_ctxt = make_unique<tags::action_context>();
 
   // clang-format off
@@ -48,7 +49,7 @@ bar::make_type bar::make(bool only_initialize_values) {
         config::make(),
         logger::make(),
         screen::make(),
-        tray_manager::make(),
+        tray_manager::make(loop),
         tags::dispatch::make(*action_ctxt),
         std::move(action_ctxt),
         taskqueue::make(),
@@ -101,14 +102,14 @@ bar::bar(connection& conn, signal_emitter& emitter, const config& config, const
     auto connected_monitors = randr_util::get_monitors(m_connection, m_connection.screen()->root, true, false);
     if (!connected_monitors.empty()) {
       monitor_name = connected_monitors[0]->name;
-      m_log.warn("No monitor specified, using \"%s\"", monitor_name);
+      POLYBAR_LOG_WARN(m_log, "No monitor specified, using \"%s\"", monitor_name);
     }
   }
 
   // if still not found, get first monitor
   if (monitor_name.empty()) {
     monitor_name = monitors[0]->name;
-    m_log.warn("No monitor specified, using \"%s\"", monitor_name);
+    POLYBAR_LOG_WARN(m_log, "No monitor specified, using \"%s\"", monitor_name);
   }
 
   // get the monitor data based on the name
@@ -122,13 +123,14 @@ bar::bar(connection& conn, signal_emitter& emitter, const config& config, const
   if (!m_opts.monitor) {
     if (fallback) {
       m_opts.monitor = move(fallback);
-      m_log.warn("Monitor \"%s\" not found, reverting to fallback \"%s\"", monitor_name, m_opts.monitor->name);
+      POLYBAR_LOG_WARN(m_log, "Monitor \"%s\" not found, reverting to fallback \"%s\"", monitor_name,
+          m_opts.monitor->name);
     } else {
       throw application_error("Monitor \"" + monitor_name + "\" not found or disconnected");
     }
   }
 
-  m_log.info("Loaded monitor %s (%ix%i+%i+%i)", m_opts.monitor->name, m_opts.monitor->w, m_opts.monitor->h,
+  POLYBAR_LOG_INFO(m_log, "Loaded monitor %s (%ix%i+%i+%i)", m_opts.monitor->name, m_opts.monitor->w, m_opts.monitor->h,
       m_opts.monitor->x, m_opts.monitor->y);
 
   try {
@@ -145,11 +147,11 @@ bar::bar(connection& conn, signal_emitter& emitter, const config& config, const
   m_opts.cursor_scroll = m_conf.get(bs, "cursor-scroll", ""s);
 #if WITH_XCURSOR
   if (!m_opts.cursor_click.empty() && !cursor_util::valid(m_opts.cursor_click)) {
-    m_log.warn("Ignoring unsupported cursor-click option '%s'", m_opts.cursor_click);
+    POLYBAR_LOG_WARN(m_log, "Ignoring unsupported cursor-click option '%s'", m_opts.cursor_click);
     m_opts.cursor_click.clear();
   }
   if (!m_opts.cursor_scroll.empty() && !cursor_util::valid(m_opts.cursor_scroll)) {
-    m_log.warn("Ignoring unsupported cursor-scroll option '%s'", m_opts.cursor_scroll);
+    POLYBAR_LOG_WARN(m_log, "Ignoring unsupported cursor-scroll option '%s'", m_opts.cursor_scroll);
     m_opts.cursor_scroll.clear();
   }
 #endif
@@ -228,7 +230,7 @@ bar::bar(connection& conn, signal_emitter& emitter, const config& config, const
     m_opts.background = m_opts.background_steps[0];
 
     if (m_conf.has(bs, "background")) {
-      m_log.warn("Ignoring `%s.background` (overridden by gradient background)", bs);
+      POLYBAR_LOG_WARN(m_log, "Ignoring `%s.background` (overridden by gradient background)", bs);
     }
   } else {
     m_opts.background = parse_or_throw_color("background", m_opts.background);
@@ -294,14 +296,14 @@ bar::bar(connection& conn, signal_emitter& emitter, const config& config, const
     throw application_error("Resulting bar height is out of bounds (" + to_string(m_opts.size.h) + ")");
   }
 
-  m_log.info("Bar geometry: %ix%i+%i+%i; Borders: %d,%d,%d,%d", m_opts.size.w, m_opts.size.h, m_opts.pos.x,
+  POLYBAR_LOG_INFO(m_log, "Bar geometry: %ix%i+%i+%i; Borders: %d,%d,%d,%d", m_opts.size.w, m_opts.size.h, m_opts.pos.x,
       m_opts.pos.y, m_opts.borders[edge::TOP].size, m_opts.borders[edge::RIGHT].size, m_opts.borders[edge::BOTTOM].size,
       m_opts.borders[edge::LEFT].size);
 
-  m_log.trace("bar: Attach X event sink");
+  POLYBAR_LOG_TRACE(m_log, "bar: Attach X event sink");
   m_connection.attach_sink(this, SINK_PRIORITY_BAR);
 
-  m_log.trace("bar: Attach signal receiver");
+  POLYBAR_LOG_TRACE(m_log, "bar: Attach signal receiver");
   m_sig.attach(this);
 }
 
@@ -309,6 +311,9 @@ bar::bar(connection& conn, signal_emitter& emitter, const config& config, const
  * Cleanup signal handlers and destroy the bar window
  */
 bar::~bar() {
+  // Stop the render thread first, draw() uses members declared after it
+  m_render_thread.reset();
+
   std::lock_guard<std::mutex> guard(m_mutex);
   m_connection.detach_sink(this, SINK_PRIORITY_BAR);
   m_sig.detach(this);
@@ -322,30 +327,45 @@ const bar_settings bar::settings() const {
 }
 
 /**
- * Parse input string and redraw the bar window
+ * Timings of the drawn frames, nullptr until the bar window is created
+ */
+frame_metrics* bar::metrics() {
+  return m_renderer ? &m_renderer->metrics() : nullptr;
+}
+
+/**
+ * Redraw the bar window from already parsed contents
  *
- * \param data Input string
- * \param force Unless true, do not parse unchanged data
+ * The caller only passes contents that changed since the last call,
+ * they are kept to redraw the bar when it gets shown again.
+ *
+ * \param data Parsed input string, in shared parts that are drawn in order
+ * \param force Unless true, do not redraw an invisible or shaded bar
  */
-void bar::parse(string&& data, bool force) {
-  if (!m_mutex.try_lock()) {
-    return;
+void bar::parse(tags::format_blocks&& data, bool force) {
+  trace_util::span span{"bar::parse"};
+  {
+    std::lock_guard<std::mutex> guard(m_mutex);
+    m_lastinput = std::move(data);
   }
 
-  std::lock_guard<std::mutex> guard(m_mutex, std::adopt_lock);
-
-  bool unchanged = data == m_lastinput;
-
-  m_lastinput = data;
+  redraw(force);
+}
 
+/**
+ * Hand the last contents to the render thread
+ *
+ * Returns right away, the frame is drawn in the background.
+ */
+void bar::redraw(bool force) {
   if (force) {
-    m_log.trace("bar: Force update");
+    POLYBAR_LOG_TRACE(m_log, "bar: Force update");
   } else if (!m_visible) {
-    return m_log.trace("bar: Ignoring update (invisible)");
+    POLYBAR_LOG_TRACE(m_log, "bar: Ignoring update (invisible)");
+    return;
   } else if (m_opts.shaded) {
-    return m_log.trace("bar: Ignoring update (shaded)");
-  } else if (unchanged) {
-    return m_log.trace("bar: Ignoring update (unchanged)");
+    POLYBAR_LOG_TRACE(m_log, "bar: Ignoring update (shaded)");
+    return;
   }
 
   auto rect = m_opts.inner_area();
@@ -361,23 +381,47 @@ void bar::parse(string&& data, bool force) {
     }
   }
 
-  m_log.info("Redrawing bar window");
-  m_renderer->begin(rect);
+  std::unique_lock<std::mutex> guard(m_mutex);
+  auto elements = m_lastinput;
+  guard.unlock();
+
+  m_render_thread->submit(render_thread::frame{settings(), move(elements), rect, force});
+}
+
+/**
+ * Draw a single frame, called on the render thread
+ *
+ * Afterwards the action blocks of the frame replace the ones used for
+ * input handling.
+ */
+void bar::draw(const render_thread::frame& frame) {
+  POLYBAR_LOG_INFO(m_log, "Redrawing bar window");
+  trace_util::span span{"bar::draw"};
+
+  if (frame.force) {
+    m_renderer->invalidate();
+  }
+
+  m_renderer->begin(frame.rect);
 
   try {
-    m_dispatch->parse(settings(), *m_renderer, std::move(data));
+    trace_util::span layout{"layout"};
+    auto timer = m_renderer->metrics().layout.measure();
+    m_dispatch->parse(frame.settings, *m_renderer, frame.elements);
   } catch (const exception& err) {
-    m_log.err("Failed to parse contents (reason: %s)", err.what());
+    POLYBAR_LOG_ERR(m_log, "Failed to parse contents (reason: %s)", err.what());
   }
 
   m_renderer->end();
 
+  std::atomic_store(&m_actions, std::make_shared<const tags::action_context>(*m_action_ctxt));
+
   const auto check_dblclicks = [&]() -> bool {
     if (m_action_ctxt->has_double_click()) {
       return true;
     }
 
-    for (auto&& action : m_opts.actions) {
+    for (auto&& action : frame.settings.actions) {
       if (static_cast<int>(action.button) >= static_cast<int>(mousebtn::DOUBLE_LEFT)) {
         return true;
       }
@@ -396,13 +440,13 @@ void bar::hide() {
   }
 
   try {
-    m_log.info("Hiding bar window");
+    POLYBAR_LOG_INFO(m_log, "Hiding bar window");
     m_sig.emit(visibility_change{false});
     m_connection.unmap_window_checked(m_opts.window);
     m_connection.flush();
     m_visible = false;
   } catch (const exception& err) {
-    m_log.err("Failed to unmap bar window (err=%s", err.what());
+    POLYBAR_LOG_ERR(m_log, "Failed to unmap bar window (err=%s", err.what());
   }
 }
 
@@ -416,7 +460,7 @@ void bar::show() {
   }
 
   try {
-    m_log.info("Showing bar window");
+    POLYBAR_LOG_INFO(m_log, "Showing bar window");
     m_sig.emit(visibility_change{true});
     /**
      * First reconfigures the window so that WMs that discard some information
@@ -426,9 +470,9 @@ void bar::show() {
     m_connection.map_window_checked(m_opts.window);
     m_connection.flush();
     m_visible = true;
-    parse(string{m_lastinput}, true);
+    redraw(true);
   } catch (const exception& err) {
-    m_log.err("Failed to map bar window (err=%s", err.what());
+    POLYBAR_LOG_ERR(m_log, "Failed to map bar window (err=%s", err.what());
   }
 }
 
@@ -468,7 +512,7 @@ void bar::restack_window() {
       }
       restacked = true;
     } catch (const exception& err) {
-      m_log.err("Failed to restack bar window (err=%s)", err.what());
+      POLYBAR_LOG_ERR(m_log, "Failed to restack bar window (err=%s)", err.what());
     }
   } else if (wm_restack == "bspwm") {
     restacked = bspwm_util::restack_to_root(m_connection, m_opts.monitor, m_opts.window);
@@ -476,23 +520,23 @@ void bar::restack_window() {
   } else if (wm_restack == "i3" && m_opts.override_redirect) {
     restacked = i3_util::restack_to_root(m_connection, m_opts.window);
   } else if (wm_restack == "i3" && !m_opts.override_redirect) {
-    m_log.warn("Ignoring restack of i3 window (not needed when `override-redirect = false`)");
+    POLYBAR_LOG_WARN(m_log, "Ignoring restack of i3 window (not needed when `override-redirect = false`)");
     wm_restack.clear();
 #endif
   } else {
-    m_log.warn("Ignoring unsupported wm-restack option '%s'", wm_restack);
+    POLYBAR_LOG_WARN(m_log, "Ignoring unsupported wm-restack option '%s'", wm_restack);
     wm_restack.clear();
   }
 
   if (restacked) {
-    m_log.info("Successfully restacked bar window");
+    POLYBAR_LOG_INFO(m_log, "Successfully restacked bar window");
   } else if (!wm_restack.empty()) {
-    m_log.err("Failed to restack bar window");
+    POLYBAR_LOG_ERR(m_log, "Failed to restack bar window");
   }
 }
 
 void bar::reconfigue_window() {
-  m_log.trace("bar: Reconfigure window");
+  POLYBAR_LOG_TRACE(m_log, "bar: Reconfigure window");
   restack_window();
   reconfigure_geom();
   reconfigure_struts();
@@ -545,19 +589,19 @@ void bar::reconfigure_struts() {
 void bar::reconfigure_wm_hints() {
   const auto& win = m_opts.window;
 
-  m_log.trace("bar: Set window WM_NAME");
+  POLYBAR_LOG_TRACE(m_log, "bar: Set window WM_NAME");
   icccm_util::set_wm_name(m_connection, win, m_opts.wmname.c_str(), m_opts.wmname.size(), "polybar\0Polybar", 15_z);
 
-  m_log.trace("bar: Set window _NET_WM_WINDOW_TYPE");
+  POLYBAR_LOG_TRACE(m_log, "bar: Set window _NET_WM_WINDOW_TYPE");
   ewmh_util::set_wm_window_type(win, {_NET_WM_WINDOW_TYPE_DOCK});
 
-  m_log.trace("bar: Set window _NET_WM_STATE");
+  POLYBAR_LOG_TRACE(m_log, "bar: Set window _NET_WM_STATE");
   ewmh_util::set_wm_state(win, {_NET_WM_STATE_STICKY, _NET_WM_STATE_ABOVE});
 
-  m_log.trace("bar: Set window _NET_WM_DESKTOP");
+  POLYBAR_LOG_TRACE(m_log, "bar: Set window _NET_WM_DESKTOP");
   ewmh_util::set_wm_desktop(win, 0xFFFFFFFF);
 
-  m_log.trace("bar: Set window _NET_WM_PID");
+  POLYBAR_LOG_TRACE(m_log, "bar: Set window _NET_WM_PID");
   ewmh_util::set_wm_pid(win);
 }
 
@@ -581,7 +625,7 @@ void bar::broadcast_visibility() {
  */
 void bar::handle(const evt::client_message& evt) {
   if (evt->type == WM_PROTOCOLS && evt->data.data32[0] == WM_DELETE_WINDOW && evt->window == m_opts.window) {
-    m_log.err("Bar window has been destroyed, shutting down...");
+    POLYBAR_LOG_ERR(m_log, "Bar window has been destroyed, shutting down...");
     m_connection.disconnect();
   }
 }
@@ -649,21 +693,18 @@ void bar::handle(const evt::leave_notify&) {
  * Used to change the cursor depending on the module
  */
 void bar::handle(const evt::motion_notify& evt) {
-  if (!m_mutex.try_lock()) {
-    return;
-  }
-
-  std::lock_guard<std::mutex> guard(m_mutex, std::adopt_lock);
+  std::lock_guard<std::mutex> guard(m_mutex);
 
-  m_log.trace("bar: Detected motion: %i at pos(%i, %i)", evt->detail, evt->event_x, evt->event_y);
+  POLYBAR_LOG_TRACE(m_log, "bar: Detected motion: %i at pos(%i, %i)", evt->detail, evt->event_x, evt->event_y);
 #if WITH_XCURSOR
   m_motion_pos = evt->event_x;
   // scroll cursor is less important than click cursor, so we shouldn't return until we are sure there is no click
   // action
   bool found_scroll = false;
+  auto actions = std::atomic_load(&m_actions);
   const auto has_action = [&](const vector<mousebtn>& buttons) -> bool {
     for (auto btn : buttons) {
-      if (m_action_ctxt->has_action(btn, m_motion_pos) != tags::NO_ACTION) {
+      if (actions->has_action(btn, m_motion_pos) != tags::NO_ACTION) {
         return true;
       }
     }
@@ -709,7 +750,7 @@ void bar::handle(const evt::motion_notify& evt) {
 
   for (auto&& action : m_opts.actions) {
     if (!action.command.empty()) {
-      m_log.trace("Found matching fallback handler");
+      POLYBAR_LOG_TRACE(m_log, "Found matching fallback handler");
       if (find_click_area(action))
         return;
     }
@@ -722,7 +763,7 @@ void bar::handle(const evt::motion_notify& evt) {
     return;
   }
   if (!string_util::compare(m_opts.cursor, "default")) {
-    m_log.trace("No matching cursor area found");
+    POLYBAR_LOG_TRACE(m_log, "No matching cursor area found");
     m_opts.cursor = "default";
     m_sig.emit(cursor_change{string{m_opts.cursor}});
     return;
@@ -736,38 +777,36 @@ void bar::handle(const evt::motion_notify& evt) {
  * Used to map mouse clicks to bar actions
  */
 void bar::handle(const evt::button_press& evt) {
-  if (!m_mutex.try_lock()) {
-    return;
-  }
-
-  std::lock_guard<std::mutex> guard(m_mutex, std::adopt_lock);
+  std::lock_guard<std::mutex> guard(m_mutex);
 
   if (m_buttonpress.deny(evt->time)) {
-    return m_log.trace_x("bar: Ignoring button press (throttled)...");
+    POLYBAR_LOG_TRACE_X(m_log, "bar: Ignoring button press (throttled)...");
+    return;
   }
 
-  m_log.trace("bar: Received button press: %i at pos(%i, %i)", evt->detail, evt->event_x, evt->event_y);
+  POLYBAR_LOG_TRACE(m_log, "bar: Received button press: %i at pos(%i, %i)", evt->detail, evt->event_x, evt->event_y);
 
   m_buttonpress_btn = static_cast<mousebtn>(evt->detail);
   m_buttonpress_pos = evt->event_x;
 
   const auto deferred_fn = [&](size_t) {
-    tags::action_t action = m_action_ctxt->has_action(m_buttonpress_btn, m_buttonpress_pos);
+    auto actions = std::atomic_load(&m_actions);
+    tags::action_t action = actions->has_action(m_buttonpress_btn, m_buttonpress_pos);
 
     if (action != tags::NO_ACTION) {
-      m_log.trace("Found matching input area");
-      m_sig.emit(button_press{m_action_ctxt->get_action(action)});
+      POLYBAR_LOG_TRACE(m_log, "Found matching input area");
+      m_sig.emit(button_press{actions->get_action(action)});
       return;
     }
 
     for (auto&& action : m_opts.actions) {
       if (action.button == m_buttonpress_btn && !action.command.empty()) {
-        m_log.trace("Found matching fallback handler");
+        POLYBAR_LOG_TRACE(m_log, "Found matching fallback handler");
         m_sig.emit(button_press{string{action.command}});
         return;
       }
     }
-    m_log.info("No matching input area found (btn=%i)", static_cast<int>(m_buttonpress_btn));
+    POLYBAR_LOG_INFO(m_log, "No matching input area found (btn=%i)", static_cast<int>(m_buttonpress_btn));
   };
 
   const auto check_double = [&](string&& id, mousebtn&& btn) {
@@ -807,8 +846,10 @@ void bar::handle(const evt::expose& evt) {
       broadcast_visibility();
     }
 
-    m_log.trace("bar: Received expose event");
-    m_renderer->flush();
+    POLYBAR_LOG_TRACE(m_log, "bar: Received expose event");
+    if (m_render_thread) {
+      m_render_thread->post([this] { m_renderer->flush(); });
+    }
   }
 }
 
@@ -824,7 +865,7 @@ void bar::handle(const evt::expose& evt) {
 void bar::handle(const evt::property_notify& evt) {
 #ifdef DEBUG_LOGGER_VERBOSE
   string atom_name = m_connection.get_atom_name(evt->atom).name();
-  m_log.trace_x("bar: property_notify(%s)", atom_name);
+  POLYBAR_LOG_TRACE_X(m_log, "bar: property_notify(%s)", atom_name);
 #endif
 
   if (evt->window == m_opts.window && evt->atom == WM_STATE) {
@@ -840,8 +881,8 @@ void bar::handle(const evt::configure_notify&) {
 }
 
 bool bar::on(const signals::eventqueue::start&) {
-  m_log.trace("bar: Create renderer");
-  m_renderer = renderer::make(m_opts, *m_action_ctxt);
+  POLYBAR_LOG_TRACE(m_log, "bar: Create renderer");
+  m_renderer = window_renderer::make(m_opts, *m_action_ctxt);
   m_opts.window = m_renderer->window();
 
   // Subscribe to window enter and leave events
@@ -854,10 +895,10 @@ bool bar::on(const signals::eventqueue::start&) {
   }
   m_connection.ensure_event_mask(m_opts.window, XCB_EVENT_MASK_STRUCTURE_NOTIFY);
 
-  m_log.info("Bar window: %s", m_connection.id(m_opts.window));
+  POLYBAR_LOG_INFO(m_log, "Bar window: %s", m_connection.id(m_opts.window));
   reconfigue_window();
 
-  m_log.trace("bar: Map window");
+  POLYBAR_LOG_TRACE(m_log, "bar: Map window");
   m_connection.map_window_checked(m_opts.window);
 
   // With the mapping, the absolute position of our window may have changed (due to re-parenting for example).
@@ -867,14 +908,18 @@ bool bar::on(const signals::eventqueue::start&) {
   // Reconfigure window position after mapping (required by Openbox)
   reconfigure_pos();
 
-  m_log.trace("bar: Draw empty bar");
+  POLYBAR_LOG_TRACE(m_log, "bar: Draw empty bar");
   m_renderer->begin(m_opts.inner_area());
   m_renderer->end();
 
+  POLYBAR_LOG_TRACE(m_log, "bar: Start render thread");
+  m_render_thread = make_unique<render_thread>(
+      m_log, [this](const render_thread::frame& frame) { draw(frame); }, [this] { return m_renderer->ready(); });
+
   m_sig.emit(signals::ui::ready{});
 
   // TODO: tray manager could run this internally on ready event
-  m_log.trace("bar: Setup tray manager");
+  POLYBAR_LOG_TRACE(m_log, "bar: Setup tray manager");
   m_tray->setup(static_cast<const bar_settings&>(m_opts));
 
   broadcast_visibility();
@@ -900,7 +945,7 @@ bool bar::on(const signals::ui::unshade_window&) {
           m_sig.emit(signals::ui::tick{});
         }
         if (!remaining) {
-          m_renderer->flush();
+          m_render_thread->post([this] { m_renderer->flush(); });
         }
         if (m_opts.dimmed) {
           m_opts.dimmed = false;
@@ -940,7 +985,7 @@ bool bar::on(const signals::ui::shade_window&) {
           m_sig.emit(signals::ui::tick{});
         }
         if (!remaining) {
-          m_renderer->flush();
+          m_render_thread->post([this] { m_renderer->flush(); });
         }
         if (!m_opts.dimmed) {
           m_opts.dimmed = true;
@@ -995,7 +1040,7 @@ bool bar::on(const signals::ui::dim_window& sig) {
 #if WITH_XCURSOR
 bool bar::on(const signals::ui::cursor_change& sig) {
   if (!cursor_util::set_cursor(m_connection, m_connection.screen(), m_opts.window, sig.cast())) {
-    m_log.warn("Failed to create cursor context");
+    POLYBAR_LOG_WARN(m_log, "Failed to create cursor context");
   }
   m_connection.flush();
   return false;
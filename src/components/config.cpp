@@ -41,7 +41,7 @@ void config::use_xrm() {
    * present in the configuration
    */
   if (!m_xrm) {
-    m_log.info("Enabling xresource manager");
+    POLYBAR_LOG_INFO(m_log, "Enabling xresource manager");
     m_xrm.reset(new xresource_manager{connection::make()});
   }
 #endif
@@ -62,7 +62,7 @@ void config::set_included(file_list included) {
 void config::warn_deprecated(const string& section, const string& key, string replacement) const {
   try {
     auto value = get<string>(section, key);
-    m_log.warn(
+    POLYBAR_LOG_WARN(m_log,
         "The config parameter `%s.%s` is deprecated, use `%s.%s` instead.", section, key, section, move(replacement));
   } catch (const key_error& err) {
   }
@@ -94,7 +94,7 @@ void config::copy_inherited() {
 
       } else if (key_name.find("inherit") == 0) {
         // Legacy support for keys that just start with 'inherit'
-        m_log.warn(
+        POLYBAR_LOG_WARN(m_log,
             "\"%s.%s\": Using anything other than 'inherit' for inheriting section keys is deprecated. "
             "The 'inherit' key supports multiple section names separated by a space.",
             section.first, key_name);
@@ -116,7 +116,7 @@ void config::copy_inherited() {
         throw value_error("Invalid section \"" + base_name + "\" defined for \"" + section.first + ".inherit\"");
       }
 
-      m_log.trace("config: Inheriting keys from \"%s\" in \"%s\"", base_name, section.first);
+      POLYBAR_LOG_TRACE(m_log, "config: Inheriting keys from \"%s\" in \"%s\"", base_name, section.first);
 
       /*
        * Iterate the base and copy the parameters that haven't been defined
@@ -14,7 +14,7 @@ config_parser::config_parser(const logger& logger, string&& file, string&& bar)
     : m_log(logger), m_config(file_util::expand(file)), m_barname(move(bar)) {}
 
 config::make_type config_parser::parse() {
-  m_log.notice("Parsing config file: %s", m_config);
+  POLYBAR_LOG_NOTICE(m_log, "Parsing config file: %s", m_config);
 
   parse_file(m_config, {});
 
@@ -102,7 +102,7 @@ void config_parser::parse_file(const string& file, file_list path) {
     throw application_error("Config file " + file + " is not a file");
   }
 
-  m_log.trace("config_parser: Parsing %s", file);
+  POLYBAR_LOG_TRACE(m_log, "config_parser: Parsing %s", file);
 
   int file_index;
 
@@ -308,7 +308,7 @@ string config_parser::parse_escaped_value(string&& value, const string& key) {
   }
   if (log) {
     // TODO Log filename, and line number
-    m_log.err(
+    POLYBAR_LOG_ERR(m_log,
         "Value '%s' of key '%s' contains one or more unescaped backslashes, please prepend them with the backslash "
         "escape character.",
         cfg_value, key);
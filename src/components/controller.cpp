@@ -1,31 +1,41 @@
 #include "components/controller.hpp"
 
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include <algorithm>
 #include <csignal>
 #include <utility>
 
 #include "components/bar.hpp"
 #include "components/builder.hpp"
 #include "components/config.hpp"
+#include "components/eventloop.hpp"
+#include "components/frame_scheduler.hpp"
 #include "components/ipc.hpp"
 #include "components/logger.hpp"
 #include "components/types.hpp"
+#include "components/worker_pool.hpp"
 #include "events/signal.hpp"
 #include "events/signal_emitter.hpp"
 #include "modules/meta/base.hpp"
 #include "modules/meta/event_handler.hpp"
 #include "modules/meta/factory.hpp"
+#include "tags/parser.hpp"
 #include "utils/actions.hpp"
+#include "utils/dirty_set.hpp"
 #include "utils/factory.hpp"
 #include "utils/inotify.hpp"
 #include "utils/process.hpp"
 #include "utils/string.hpp"
 #include "utils/time.hpp"
+#include "utils/trace.hpp"
 #include "x11/connection.hpp"
 #include "x11/extensions/all.hpp"
 
 POLYBAR_NS
 
-array<int, 2> g_eventpipe{{-1, -1}};
+int g_eventfd{-1};
 sig_atomic_t g_reload{0};
 sig_atomic_t g_terminate{0};
 
@@ -36,48 +46,57 @@ void interrupt_handler(int signum) {
 
   g_terminate = 1;
   g_reload = (signum == SIGUSR1);
-  if (write(g_eventpipe[PIPE_WRITE], &g_terminate, 1) == -1) {
-    throw system_error("Failed to write to eventpipe");
+
+  uint64_t value{1};
+  if (write(g_eventfd, &value, sizeof(value)) == -1) {
+    throw system_error("Failed to write to eventfd");
   }
 }
 
 /**
  * Build controller instance
  */
-controller::make_type controller::make(unique_ptr<ipc>&& ipc, unique_ptr<inotify_watch>&& config_watch) {
+controller::make_type controller::make(
+    eventloop& loop, unique_ptr<ipc>&& ipc, unique_ptr<inotify_watch>&& config_watch) {
   return factory_util::unique<controller>(connection::make(), signal_emitter::make(), logger::make(), config::make(),
-      bar::make(), forward<decltype(ipc)>(ipc), forward<decltype(config_watch)>(config_watch));
+      loop, bar::make(loop), forward<decltype(ipc)>(ipc), forward<decltype(config_watch)>(config_watch));
 }
 
 /**
  * Construct controller
  */
 controller::controller(connection& conn, signal_emitter& emitter, const logger& logger, const config& config,
-    unique_ptr<bar>&& bar, unique_ptr<ipc>&& ipc, unique_ptr<inotify_watch>&& confwatch)
+    eventloop& loop, unique_ptr<bar>&& bar, unique_ptr<ipc>&& ipc, unique_ptr<inotify_watch>&& confwatch)
     : m_connection(conn)
     , m_sig(emitter)
     , m_log(logger)
     , m_conf(config)
     , m_bar(forward<decltype(bar)>(bar))
     , m_ipc(forward<decltype(ipc)>(ipc))
-    , m_confwatch(forward<decltype(confwatch)>(confwatch)) {
+    , m_confwatch(forward<decltype(confwatch)>(confwatch))
+    , m_loop(loop) {
   if (m_conf.has("settings", "throttle-input-for")) {
-    m_log.warn(
+    POLYBAR_LOG_WARN(m_log,
         "The config parameter 'settings.throttle-input-for' is deprecated, it will be removed in the future. Please "
         "remove it from your config");
   }
 
-  m_swallow_limit = m_conf.deprecated("settings", "eventqueue-swallow", "throttle-output", m_swallow_limit);
-  m_swallow_update = m_conf.deprecated("settings", "eventqueue-swallow-time", "throttle-output-for", m_swallow_update);
+  for (auto&& key : {"throttle-output", "throttle-output-for", "eventqueue-swallow", "eventqueue-swallow-time"}) {
+    if (m_conf.has("settings", key)) {
+      POLYBAR_LOG_WARN(m_log,
+          "The config parameter 'settings.%s' is deprecated and has no effect, use 'settings.max-fps' instead", key);
+    }
+  }
 
-  if (pipe(g_eventpipe.data()) == 0) {
-    m_queuefd[PIPE_READ] = make_unique<file_descriptor>(g_eventpipe[PIPE_READ]);
-    m_queuefd[PIPE_WRITE] = make_unique<file_descriptor>(g_eventpipe[PIPE_WRITE]);
+  m_frames = make_unique<frame_scheduler>(m_conf.get("settings", "max-fps", 60U));
+
+  if ((g_eventfd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC)) != -1) {
+    m_eventfd = make_unique<file_descriptor>(g_eventfd);
   } else {
-    throw system_error("Failed to create event channel pipes");
+    throw system_error("Failed to create event channel");
   }
 
-  m_log.trace("controller: Install signal handler");
+  POLYBAR_LOG_TRACE(m_log, "controller: Install signal handler");
   struct sigaction act {};
   memset(&act, 0, sizeof(act));
   act.sa_handler = &interrupt_handler;
@@ -87,7 +106,7 @@ controller::controller(connection& conn, signal_emitter& emitter, const logger&
   sigaction(SIGUSR1, &act, nullptr);
   sigaction(SIGALRM, &act, nullptr);
 
-  m_log.trace("controller: Setup user-defined modules");
+  POLYBAR_LOG_TRACE(m_log, "controller: Setup user-defined modules");
   size_t created_modules{0};
   created_modules += setup_modules(alignment::LEFT);
   created_modules += setup_modules(alignment::CENTER);
@@ -96,13 +115,29 @@ controller::controller(connection& conn, signal_emitter& emitter, const logger&
   if (!created_modules) {
     throw application_error("No modules created");
   }
+
+  m_changes = make_unique<dirty_set>(m_modules.size());
+  for (size_t i = 0; i < m_modules.size(); i++) {
+    m_modules[i]->set_change_handler([this, i] { notify_change(i); });
+  }
+
+  // The eventqueue thread works on the updates as well
+  size_t threads = std::max(1U, std::thread::hardware_concurrency());
+  threads = std::min(threads, m_modules.size());
+  m_workers = make_unique<worker_pool>(std::min(threads, size_t{MAX_UPDATE_THREADS}) - 1);
+
+  const bar_settings& bar{m_bar->settings()};
+  builder build{bar};
+  build.node(bar.separator);
+  m_separator = build.flush();
+  m_separator_elements = parse_contents(m_separator);
 }
 
 /**
  * Deconstruct controller
  */
 controller::~controller() {
-  m_log.trace("controller: Uninstall sighandler");
+  POLYBAR_LOG_TRACE(m_log, "controller: Uninstall sighandler");
   signal(SIGINT, SIG_DFL);
   signal(SIGQUIT, SIG_DFL);
   signal(SIGTERM, SIG_DFL);
@@ -113,17 +148,20 @@ controller::~controller() {
     signal(SIGUSR1, SIG_IGN);
   }
 
-  m_log.trace("controller: Detach signal receiver");
+  POLYBAR_LOG_TRACE(m_log, "controller: Detach signal receiver");
   m_sig.detach(this);
 
-  m_log.trace("controller: Stop modules");
+  POLYBAR_LOG_TRACE(m_log, "controller: Stop modules");
   for (auto&& module : m_modules) {
     auto module_name = module->name();
     auto cleanup_ms = time_util::measure([&module] { module->stop(); });
-    m_log.info("Deconstruction of %s took %lu ms.", module_name, cleanup_ms);
+    POLYBAR_LOG_INFO(m_log, "Deconstruction of %s took %lu ms.", module_name, cleanup_ms);
   }
 
-  m_log.trace("controller: Joining threads");
+  POLYBAR_LOG_TRACE(m_log, "controller: Stop module event loop");
+  eventloop::make().stop();
+
+  POLYBAR_LOG_TRACE(m_log, "controller: Joining threads");
   for (auto&& t : m_threads) {
     if (t.joinable()) {
       t.join();
@@ -135,8 +173,8 @@ controller::~controller() {
  * Run the main loop
  */
 bool controller::run(bool writeback, string snapshot_dst) {
-  m_log.info("Starting application");
-  m_log.trace("controller: Main thread id = %i", concurrency_util::thread_id(this_thread::get_id()));
+  POLYBAR_LOG_INFO(m_log, "Starting application");
+  POLYBAR_LOG_TRACE(m_log, "controller: Main thread id = %i", concurrency_util::thread_id(this_thread::get_id()));
 
   assert(!m_connection.connection_has_error());
 
@@ -154,11 +192,11 @@ bool controller::run(bool writeback, string snapshot_dst) {
     }
 
     try {
-      m_log.info("Starting %s", module->name());
+      POLYBAR_LOG_INFO(m_log, "Starting %s", module->name());
       module->start();
       started_modules++;
     } catch (const application_error& err) {
-      m_log.err("Failed to start '%s' (reason: %s)", module->name(), err.what());
+      POLYBAR_LOG_ERR(m_log, "Failed to start '%s' (reason: %s)", module->name(), err.what());
     }
   }
 
@@ -176,7 +214,7 @@ bool controller::run(bool writeback, string snapshot_dst) {
     m_event_thread.join();
   }
 
-  m_log.notice("Termination signal received, shutting down...");
+  POLYBAR_LOG_NOTICE(m_log, "Termination signal received, shutting down...");
 
   return !g_reload;
 }
@@ -189,11 +227,11 @@ bool controller::enqueue(event&& evt) {
     return false;
   }
   if (!m_queue.enqueue(forward<decltype(evt)>(evt))) {
-    m_log.warn("Failed to enqueue event");
+    POLYBAR_LOG_WARN(m_log, "Failed to enqueue event");
     return false;
   }
   // if (write(g_eventpipe[PIPE_WRITE], " ", 1) == -1) {
-  //   m_log.err("Failed to write to eventpipe (reason: %s)", strerror(errno));
+  //   POLYBAR_LOG_ERR(m_log, "Failed to write to eventpipe (reason: %s)", strerror(errno));
   // }
   return true;
 }
@@ -203,7 +241,7 @@ bool controller::enqueue(event&& evt) {
  */
 bool controller::enqueue(string&& input_data) {
   if (!m_inputdata.empty()) {
-    m_log.trace("controller: Swallowing input event (pending data)");
+    POLYBAR_LOG_TRACE(m_log, "controller: Swallowing input event (pending data)");
   } else {
     m_inputdata = forward<string>(input_data);
     return enqueue(make_input_evt());
@@ -215,115 +253,90 @@ bool controller::enqueue(string&& input_data) {
  * Read events from configured file descriptors
  */
 void controller::read_events() {
-  m_log.info("Entering event loop (thread-id=%lu)", this_thread::get_id());
+  POLYBAR_LOG_INFO(m_log, "Entering event loop (thread-id=%lu)", this_thread::get_id());
 
-  int fd_connection{-1};
-  int fd_confwatch{-1};
-  int fd_ipc{-1};
-
-  vector<int> fds;
-  fds.emplace_back(*m_queuefd[PIPE_READ]);
-  fds.emplace_back((fd_connection = m_connection.get_file_descriptor()));
-
-  if (m_confwatch) {
-    m_log.trace("controller: Attach config watch");
-    m_confwatch->attach(IN_MODIFY | IN_IGNORED);
-    fds.emplace_back((fd_confwatch = m_confwatch->get_file_descriptor()));
-  }
-
-  if (m_ipc) {
-    fds.emplace_back((fd_ipc = m_ipc->get_file_descriptor()));
+  if (g_terminate) {
+    return;
   }
 
-  while (!g_terminate) {
-    fd_set readfds{};
-    FD_ZERO(&readfds);
-
-    int maxfd{0};
-    for (auto&& fd : fds) {
-      FD_SET(fd, &readfds);
-      maxfd = std::max(maxfd, fd);
-    }
-
-    // Wait until event is ready on one of the configured streams
-    int events = select(maxfd + 1, &readfds, nullptr, nullptr, nullptr);
-
-    // Check for errors
-    if (events == -1) {
-      /*
-       * The Interrupt errno is generated when polybar is stopped, so it
-       * shouldn't generate an error message
-       */
-      if (errno != EINTR) {
-        m_log.err("select failed in event loop: %s", strerror(errno));
-      }
-
-      break;
+  // Process event on the internal fd
+  m_loop.add_fd(*m_eventfd, EPOLLIN, [&](int fd, unsigned int) {
+    uint64_t value;
+    if (read(fd, &value, sizeof(value)) == -1 && errno != EAGAIN) {
+      POLYBAR_LOG_ERR(m_log, "Failed to read from eventfd (err: %s)", strerror(errno));
     }
-
-    if (g_terminate || m_connection.connection_has_error()) {
-      break;
+    if (g_terminate) {
+      m_loop.stop();
     }
+  });
 
-    // Process event on the internal fd
-    if (m_queuefd[PIPE_READ] && FD_ISSET(static_cast<int>(*m_queuefd[PIPE_READ]), &readfds)) {
-      char buffer[BUFSIZ];
-      if (read(static_cast<int>(*m_queuefd[PIPE_READ]), &buffer, BUFSIZ) == -1) {
-        m_log.err("Failed to read from eventpipe (err: %s)", strerror(errno));
+  // Process event on the xcb connection fd
+  m_loop.add_fd(m_connection.get_file_descriptor(), EPOLLIN, [&](int, unsigned int) {
+    shared_ptr<xcb_generic_event_t> evt{};
+    while ((evt = shared_ptr<xcb_generic_event_t>(xcb_poll_for_event(m_connection), free)) != nullptr) {
+      try {
+        trace_util::span span{"dispatch_event"};
+        m_connection.dispatch_event(evt);
+      } catch (xpp::connection_error& err) {
+        POLYBAR_LOG_ERR(m_log, "X connection error, terminating... (what: %s)", m_connection.error_str(err.code()));
+      } catch (const exception& err) {
+        POLYBAR_LOG_ERR(m_log, "Error in X event loop: %s", err.what());
       }
     }
+    if (m_connection.connection_has_error()) {
+      m_loop.stop();
+    }
+  });
+
+  if (m_confwatch) {
+    POLYBAR_LOG_TRACE(m_log, "controller: Attach config watch");
+    m_confwatch->attach(IN_MODIFY | IN_IGNORED);
+    watch_config();
+  }
+
+  try {
+    m_loop.run();
+  } catch (const system_error& err) {
+    POLYBAR_LOG_ERR(m_log, "Failure in event loop: %s", err.what());
+  }
+}
 
-    // Process event on the config inotify watch fd
+/**
+ * Register the config inotify watch fd with the event loop
+ */
+void controller::watch_config() {
+  m_confwatch_handle = m_loop.add_fd(m_confwatch->get_file_descriptor(), EPOLLIN, [&](int, unsigned int) {
     unique_ptr<inotify_event> confevent;
-    if (fd_confwatch > -1 && FD_ISSET(fd_confwatch, &readfds) && (confevent = m_confwatch->await_match())) {
-      if (confevent->mask & IN_IGNORED) {
-        // IN_IGNORED: file was deleted or filesystem was unmounted
-        //
-        // This happens in some configurations of vim when a file is saved,
-        // since it is not actually issuing calls to write() but rather
-        // moves a file into the original's place after moving the original
-        // file to a different location (and subsequently deleting it).
-        //
-        // We need to re-attach the watch to the new file in this case.
-        fds.erase(
-            std::remove_if(fds.begin(), fds.end(), [fd_confwatch](int fd) { return fd == fd_confwatch; }), fds.end());
-        m_confwatch = inotify_util::make_watch(m_confwatch->path());
-        m_confwatch->attach(IN_MODIFY | IN_IGNORED);
-        fds.emplace_back((fd_confwatch = m_confwatch->get_file_descriptor()));
-      }
-      m_log.info("Configuration file changed");
-      g_terminate = 1;
-      g_reload = 1;
-    }
-
-    // Process event on the xcb connection fd
-    if (fd_connection > -1 && FD_ISSET(fd_connection, &readfds)) {
-      shared_ptr<xcb_generic_event_t> evt{};
-      while ((evt = shared_ptr<xcb_generic_event_t>(xcb_poll_for_event(m_connection), free)) != nullptr) {
-        try {
-          m_connection.dispatch_event(evt);
-        } catch (xpp::connection_error& err) {
-          m_log.err("X connection error, terminating... (what: %s)", m_connection.error_str(err.code()));
-        } catch (const exception& err) {
-          m_log.err("Error in X event loop: %s", err.what());
-        }
-      }
+    if (!(confevent = m_confwatch->await_match())) {
+      return;
     }
-
-    // Process event on the ipc fd
-    if (fd_ipc > -1 && FD_ISSET(fd_ipc, &readfds)) {
-      m_ipc->receive_message();
-      fds.erase(std::remove_if(fds.begin(), fds.end(), [fd_ipc](int fd) { return fd == fd_ipc; }), fds.end());
-      fds.emplace_back((fd_ipc = m_ipc->get_file_descriptor()));
+    if (confevent->mask & IN_IGNORED) {
+      // IN_IGNORED: file was deleted or filesystem was unmounted
+      //
+      // This happens in some configurations of vim when a file is saved,
+      // since it is not actually issuing calls to write() but rather
+      // moves a file into the original's place after moving the original
+      // file to a different location (and subsequently deleting it).
+      //
+      // We need to re-attach the watch to the new file in this case.
+      m_loop.remove(m_confwatch_handle);
+      m_confwatch = inotify_util::make_watch(m_confwatch->path());
+      m_confwatch->attach(IN_MODIFY | IN_IGNORED);
+      watch_config();
     }
-  }
+    POLYBAR_LOG_INFO(m_log, "Configuration file changed");
+    g_terminate = 1;
+    g_reload = 1;
+    m_loop.stop();
+  });
 }
 
 /**
  * Eventqueue worker loop
  */
 void controller::process_eventqueue() {
-  m_log.info("Eventqueue worker (thread-id=%lu)", this_thread::get_id());
+  POLYBAR_LOG_INFO(m_log, "Eventqueue worker (thread-id=%lu)", this_thread::get_id());
+  trace_util::thread_name("eventqueue");
   if (!m_writeback) {
     m_sig.emit(signals::eventqueue::start{});
   } else {
@@ -333,7 +346,18 @@ void controller::process_eventqueue() {
 
   while (!g_terminate) {
     event evt{};
-    m_queue.wait_dequeue(evt);
+
+    if (m_frames->pending()) {
+      auto now = frame_scheduler::clock::now();
+      if (now >= m_frames->deadline()) {
+        process_update(m_frames->begin_frame(now));
+        continue;
+      } else if (!m_queue.wait_dequeue_timed(evt, m_frames->deadline() - now)) {
+        continue;
+      }
+    } else {
+      m_queue.wait_dequeue(evt);
+    }
 
     if (g_terminate) {
       break;
@@ -345,44 +369,19 @@ void controller::process_eventqueue() {
       }
     } else if (evt.type == event_type::INPUT) {
       process_inputdata();
-    } else if (evt.type == event_type::UPDATE && evt.flag) {
-      process_update(true);
+    } else if (evt.type == event_type::UPDATE) {
+      // Updates arriving while a frame is pending are merged into that frame
+      m_frames->request(evt.flag);
+    } else if (evt.type == event_type::CHECK) {
+      on(signals::eventqueue::check_state{});
     } else {
-      event next{};
-      size_t swallowed{0};
-      while (swallowed++ < m_swallow_limit && m_queue.wait_dequeue_timed(next, m_swallow_update)) {
-        if (next.type == event_type::QUIT) {
-          evt = next;
-          break;
-        } else if (next.type == event_type::INPUT) {
-          evt = next;
-          break;
-        } else if (evt.type != next.type) {
-          enqueue(move(next));
-          break;
-        } else {
-          m_log.trace_x("controller: Swallowing event within timeframe");
-          evt = next;
-        }
-      }
-
-      if (evt.type == event_type::UPDATE) {
-        process_update(evt.flag);
-      } else if (evt.type == event_type::INPUT) {
-        process_inputdata();
-      } else if (evt.type == event_type::QUIT) {
-        if (evt.flag) {
-          on(signals::eventqueue::exit_reload{});
-        } else {
-          on(signals::eventqueue::exit_terminate{});
-        }
-      } else if (evt.type == event_type::CHECK) {
-        on(signals::eventqueue::check_state{});
-      } else {
-        m_log.warn("Unknown event type for enqueued event (%d)", evt.type);
-      }
+      POLYBAR_LOG_WARN(m_log, "Unknown event type for enqueued event (%d)", evt.type);
     }
   }
+
+  const auto& stats = m_frames->get_stats();
+  POLYBAR_LOG_INFO(m_log, "Eventqueue: Rendered %lu frames (merged=%lu, dropped=%lu)", stats.rendered, stats.merged,
+      stats.dropped);
 }
 
 /**
@@ -473,15 +472,16 @@ bool controller::try_forward_legacy_action(const string& cmd) {
         if (module->type() == type) {
           auto module_name = module->name_raw();
           if (data.empty()) {
-            m_log.warn("The action '%s' is deprecated, use '#%s.%s' instead!", cmd, module_name, action);
+            POLYBAR_LOG_WARN(m_log, "The action '%s' is deprecated, use '#%s.%s' instead!", cmd, module_name, action);
           } else {
-            m_log.warn("The action '%s' is deprecated, use '#%s.%s.%s' instead!", cmd, module_name, action, data);
+            POLYBAR_LOG_WARN(m_log, "The action '%s' is deprecated, use '#%s.%s.%s' instead!", cmd, module_name, action,
+                data);
           }
-          m_log.warn("Consult the 'Actions' page in the polybar documentation for more information.");
-          m_log.info(
+          POLYBAR_LOG_WARN(m_log, "Consult the 'Actions' page in the polybar documentation for more information.");
+          POLYBAR_LOG_INFO(m_log,
               "Forwarding legacy action '%s' to module '%s' as '%s' with data '%s'", cmd, module_name, action, data);
           if (!module->input(action, data)) {
-            m_log.err("Failed to forward deprecated action to %s module", type);
+            POLYBAR_LOG_ERR(m_log, "Failed to forward deprecated action to %s module", type);
             // Forward to shell if the module cannot accept the action to not break existing behavior.
             return false;
           }
@@ -504,7 +504,8 @@ bool controller::forward_action(const actions_util::action& action_triple) {
   string action = std::get<1>(action_triple);
   string data = std::get<2>(action_triple);
 
-  m_log.info("Forwarding action to modules (module: '%s', action: '%s', data: '%s')", module_name, action, data);
+  POLYBAR_LOG_INFO(m_log, "Forwarding action to modules (module: '%s', action: '%s', data: '%s')", module_name, action,
+      data);
 
   int num_delivered = 0;
 
@@ -512,7 +513,7 @@ bool controller::forward_action(const actions_util::action& action_triple) {
   for (auto&& module : m_modules) {
     if (module->name_raw() == module_name) {
       if (!module->input(action, data)) {
-        m_log.err("The '%s' module does not support the '%s' action.", module_name, action);
+        POLYBAR_LOG_ERR(m_log, "The '%s' module does not support the '%s' action.", module_name, action);
       }
 
       num_delivered++;
@@ -520,10 +521,10 @@ bool controller::forward_action(const actions_util::action& action_triple) {
   }
 
   if (num_delivered == 0) {
-    m_log.err("Could not forward action to module: No module named '%s' (action: '%s', data: '%s')", module_name,
-        action, data);
+    POLYBAR_LOG_ERR(m_log, "Could not forward action to module: No module named '%s' (action: '%s', data: '%s')",
+        module_name, action, data);
   } else {
-    m_log.info("Delivered action to %d module%s", num_delivered, num_delivered > 1 ? "s" : "");
+    POLYBAR_LOG_INFO(m_log, "Delivered action to %d module%s", num_delivered, num_delivered > 1 ? "s" : "");
   }
   return true;
 }
@@ -539,14 +540,14 @@ void controller::process_inputdata() {
   const string cmd = std::move(m_inputdata);
   m_inputdata = string{};
 
-  m_log.trace("controller: Processing inputdata: %s", cmd);
+  POLYBAR_LOG_TRACE(m_log, "controller: Processing inputdata: %s", cmd);
 
   // Every command that starts with '#' is considered an action string.
   if (cmd.front() == '#') {
     try {
       this->forward_action(actions_util::parse_action_string(cmd));
     } catch (runtime_error& e) {
-      m_log.err("Invalid action string (action: %s, reason: %s)", cmd, e.what());
+      POLYBAR_LOG_ERR(m_log, "Invalid action string (action: %s, reason: %s)", cmd, e.what());
     }
 
     return;
@@ -558,106 +559,313 @@ void controller::process_inputdata() {
 
   try {
     // Run input as command if it's not an input for a module
-    m_log.info("Forwarding command to shell... (input: %s)", cmd);
-    m_log.info("Executing shell command: %s", cmd);
+    POLYBAR_LOG_INFO(m_log, "Forwarding command to shell... (input: %s)", cmd);
+    POLYBAR_LOG_INFO(m_log, "Executing shell command: %s", cmd);
     process_util::fork_detached([cmd] { process_util::exec_sh(cmd.c_str()); });
     process_update(true);
   } catch (const application_error& err) {
-    m_log.err("controller: Error while forwarding input to shell -> %s", err.what());
+    POLYBAR_LOG_ERR(m_log, "controller: Error while forwarding input to shell -> %s", err.what());
   }
 }
 
 /**
  * Process eventqueue update event
+ *
+ * Only the modules that reported a change since the last update are
+ * checked, unless the update is forced. Their output is fetched in parallel
+ * on the worker pool, afterwards the blocks with changed modules are
+ * recomposed in order. The bar is handed the parsed blocks directly, the
+ * formatting string is only assembled in writeback mode.
  */
 bool controller::process_update(bool force) {
-  const bar_settings& bar{m_bar->settings()};
-  string contents;
-  string padding_left(bar.padding.left, ' ');
-  string padding_right(bar.padding.right, ' ');
-  string margin_left(bar.module_margin.left, ' ');
-  string margin_right(bar.module_margin.right, ' ');
+  trace_util::span span{"process_update"};
+  auto start = histogram::clock::now();
+  auto changed = m_changes->take();
+  bool dirty{false};
 
-  builder build{bar};
-  build.node(bar.separator);
-  string separator{build.flush()};
+  vector<block_cache*> targets;
+  vector<worker_pool::task_fn> tasks;
+  // Written by the tasks, one byte per task so that they do not share a word
+  vector<char> updated;
 
   for (const auto& block : m_blocks) {
-    string block_contents;
-    bool is_left = false;
-    bool is_center = false;
-    bool is_right = false;
-    bool is_first = true;
-
-    if (block.first == alignment::LEFT) {
-      is_left = true;
-    } else if (block.first == alignment::CENTER) {
-      is_center = true;
-    } else if (block.first == alignment::RIGHT) {
-      is_right = true;
-    }
-
-    for (const auto& module : block.second) {
-      if (!module->running() || !module->visible()) {
+    auto& cache = m_block_cache[block.first];
+
+    for (size_t i = 0; i < block.second.size(); i++) {
+      auto& entry = cache.modules[i];
+      if (!force && !changed[entry.index]) {
         continue;
       }
+      auto n = tasks.size();
+      targets.emplace_back(&cache);
+      tasks.emplace_back([this, &module = block.second[i], &entry, &updated, n] {
+        updated[n] = update_module_cache(module, entry);
+      });
+    }
+  }
 
-      string module_contents;
+  updated.assign(tasks.size(), 0);
 
-      try {
-        module_contents = module->contents();
-      } catch (const exception& err) {
-        m_log.err("Failed to get contents for \"%s\" (err: %s)", module->name(), err.what());
-      }
+  try {
+    m_workers->run(tasks);
+  } catch (const exception& err) {
+    POLYBAR_LOG_ERR(m_log, "Failed to update module contents (reason: %s)", err.what());
+  }
 
-      if (module_contents.empty()) {
-        continue;
-      }
+  for (size_t i = 0; i < targets.size(); i++) {
+    if (updated[i]) {
+      targets[i]->dirty = true;
+    }
+  }
 
-      if (!block_contents.empty() && !margin_right.empty()) {
-        block_contents += margin_right;
-      }
+  for (const auto& block : m_blocks) {
+    auto& cache = m_block_cache[block.first];
+
+    if (cache.dirty) {
+      POLYBAR_LOG_TRACE(m_log, "controller: Recompose block %i", static_cast<int>(block.first));
+      compose_block(block.first, cache);
+      cache.dirty = false;
+      m_bar_outdated = true;
+      dirty = true;
+    }
+  }
 
-      if (!block_contents.empty() && !separator.empty()) {
-        block_contents += separator;
-      }
+  auto metrics = m_bar->metrics();
+  if (dirty && metrics != nullptr) {
+    metrics->parse.record(histogram::clock::now() - start);
+  }
 
-      if (!block_contents.empty() && !margin_left.empty() && !(is_left && is_first)) {
-        block_contents += margin_left;
+  try {
+    if (m_writeback) {
+      string contents;
+      for (const auto& block : m_block_cache) {
+        contents += block.second.contents;
+      }
+      std::cout << contents << std::endl;
+    } else if (m_bar_outdated || force) {
+      // Unchanged blocks are shared with the previous frame
+      tags::format_blocks elements;
+      for (const auto& block : m_block_cache) {
+        elements.emplace_back(block.second.elements);
       }
+      m_bar->parse(move(elements), force);
+      m_bar_outdated = false;
+    } else {
+      POLYBAR_LOG_TRACE(m_log, "controller: Ignoring update (unchanged)");
+    }
+  } catch (const exception& err) {
+    POLYBAR_LOG_ERR(m_log, "Failed to update bar contents (reason: %s)", err.what());
+  }
 
-      block_contents.reserve(module_contents.size());
-      block_contents += module_contents;
+  return true;
+}
 
-      is_first = false;
+/**
+ * Refresh the cached output of a single module
+ *
+ * The module output is only fetched if the module reports a change
+ * or has just become visible. Changed output is parsed right away so
+ * that redrawing the bar does not have to parse it again.
+ *
+ * Runs on the worker pool, concurrently with the updates of other modules.
+ *
+ * \returns true if the cached output changed
+ */
+bool controller::update_module_cache(const module_t& module, module_cache& cache) {
+  if (!module->running() || !module->visible()) {
+    if (!cache.shown) {
+      return false;
     }
+    cache.shown = false;
+    cache.contents.clear();
+    cache.elements.clear();
+    return true;
+  }
 
-    if (block_contents.empty()) {
-      continue;
-    } else if (is_left) {
-      contents += "%{l}";
-      contents += padding_left;
-    } else if (is_center) {
-      contents += "%{c}";
-    } else if (is_right) {
-      contents += "%{r}";
-      block_contents += padding_right;
+  if (cache.shown && !module->changed()) {
+    return false;
+  }
+
+  cache.shown = true;
+
+  string module_contents;
+
+  try {
+    module_contents = module->contents();
+  } catch (const exception& err) {
+    POLYBAR_LOG_ERR(m_log, "Failed to get contents for \"%s\" (err: %s)", module->name(), err.what());
+  }
+
+  if (module_contents == cache.contents) {
+    return false;
+  }
+
+  cache.contents = move(module_contents);
+
+  if (!m_writeback) {
+    cache.elements = parse_contents(cache.contents);
+  }
+
+  return true;
+}
+
+/**
+ * Assemble the contents of a block from the cached module outputs
+ *
+ * In writeback mode the formatting string is assembled, otherwise
+ * the parsed elements.
+ */
+void controller::compose_block(alignment align, block_cache& cache) const {
+  const bar_settings& bar{m_bar->settings()};
+  bool is_first = true;
+
+  cache.contents.clear();
+  cache.elements = make_shared<const tags::format_string>();
+
+  const auto is_empty = [](const module_cache& module) { return module.contents.empty(); };
+  if (std::all_of(cache.modules.begin(), cache.modules.end(), is_empty)) {
+    return;
+  }
+
+  tags::format_string elements;
+
+  const auto append_tag = [&](tags::syntaxtag tag, const string& text) {
+    if (m_writeback) {
+      cache.contents += text;
+    } else {
+      tags::element el;
+      el.is_tag = true;
+      el.tag_data.type = tags::tag_type::FORMAT;
+      el.tag_data.subtype.format = tag;
+      elements.emplace_back(move(el));
+    }
+  };
+
+  const auto append_control = [&](tags::controltag ctrl, string data) {
+    tags::element el{move(data)};
+    el.is_tag = true;
+    el.tag_data.type = tags::tag_type::FORMAT;
+    el.tag_data.subtype.format = tags::syntaxtag::P;
+    el.tag_data.ctrl = ctrl;
+    elements.emplace_back(move(el));
+  };
+
+  const auto append_spaces = [&](size_t count) {
+    if (count == 0) {
+      return;
+    } else if (m_writeback) {
+      cache.contents.append(count, ' ');
+    } else {
+      elements.emplace_back(string(count, ' '));
     }
+  };
 
-    contents += block_contents;
+  if (align == alignment::LEFT) {
+    append_tag(tags::syntaxtag::l, "%{l}");
+    append_spaces(bar.padding.left);
+  } else if (align == alignment::CENTER) {
+    append_tag(tags::syntaxtag::c, "%{c}");
+  } else if (align == alignment::RIGHT) {
+    append_tag(tags::syntaxtag::r, "%{r}");
   }
 
-  try {
-    if (!m_writeback) {
-      m_bar->parse(move(contents), force);
+  for (const auto& module : cache.modules) {
+    if (module.contents.empty()) {
+      continue;
+    }
+
+    if (!is_first) {
+      append_spaces(bar.module_margin.right);
+
+      if (m_writeback) {
+        cache.contents += m_separator;
+      } else {
+        elements.insert(elements.end(), m_separator_elements.begin(), m_separator_elements.end());
+      }
+
+      append_spaces(bar.module_margin.left);
+    }
+
+    if (m_writeback) {
+      cache.contents += module.contents;
     } else {
-      std::cout << contents << std::endl;
+      // Mark the module output so that the renderer can reuse it while it doesn't change
+      append_control(tags::controltag::S, module.contents);
+      elements.insert(elements.end(), module.elements.begin(), module.elements.end());
+      append_control(tags::controltag::E, {});
     }
-  } catch (const exception& err) {
-    m_log.err("Failed to update bar contents (reason: %s)", err.what());
+
+    is_first = false;
   }
 
-  return true;
+  if (align == alignment::RIGHT) {
+    append_spaces(bar.padding.right);
+  }
+
+  if (!m_writeback) {
+    cache.elements = make_shared<const tags::format_string>(move(elements));
+  }
+}
+
+/**
+ * Parse a formatting string into elements
+ *
+ * Invalid tags are logged and skipped, just like the bar would when
+ * parsing the whole string.
+ */
+tags::format_string controller::parse_contents(string contents) const {
+  tags::parser parser;
+  tags::format_string elements;
+
+  parser.set(move(contents));
+
+  while (parser.has_next_element()) {
+    try {
+      elements.emplace_back(parser.next_element());
+    } catch (const tags::error& err) {
+      POLYBAR_LOG_ERR(m_log, "Parser error (reason: %s)", err.what());
+    }
+  }
+
+  return elements;
+}
+
+/**
+ * Timings of the bar and all modules as a JSON object
+ */
+string controller::stats() const {
+  const auto quote = [](const string& value) {
+    string quoted{"\""};
+    for (auto&& c : value) {
+      if (c == '"' || c == '\\') {
+        quoted += '\\';
+      }
+      quoted += c;
+    }
+    return quoted + '"';
+  };
+
+  auto metrics = m_bar->metrics();
+  string modules;
+
+  for (const auto& module : m_modules) {
+    if (!modules.empty()) {
+      modules += ",";
+    }
+    // clang-format off
+    modules += "{\"name\":" + quote(module->name_raw()) +
+      ",\"type\":" + quote(module->type()) +
+      ",\"running\":" + (module->running() ? "true" : "false") +
+      ",\"metrics\":" + module->metrics().to_json() + "}";
+    // clang-format on
+  }
+
+  // clang-format off
+  return "{\"pid\":" + to_string(getpid()) +
+    ",\"bar\":" + quote(m_bar->settings().wmname) +
+    ",\"frame\":" + (metrics != nullptr ? metrics->to_json() : "null"s) +
+    ",\"modules\":[" + modules + "]}";
+  // clang-format on
 }
 
 /**
@@ -680,7 +888,7 @@ size_t controller::setup_modules(alignment align) {
       break;
 
     case alignment::NONE:
-      m_log.err("controller: Tried to setup modules for alignment NONE");
+      POLYBAR_LOG_ERR(m_log, "controller: Tried to setup modules for alignment NONE");
       break;
   }
 
@@ -707,19 +915,47 @@ size_t controller::setup_modules(alignment align) {
 
       m_modules.push_back(module);
       m_blocks[align].push_back(module);
+      m_block_cache[align].modules.emplace_back();
+      m_block_cache[align].modules.back().index = m_modules.size() - 1;
     } catch (const std::exception& err) {
-      m_log.err("Disabling module \"%s\" (reason: %s)", module_name, err.what());
+      POLYBAR_LOG_ERR(m_log, "Disabling module \"%s\" (reason: %s)", module_name, err.what());
     }
   }
 
   return m_modules.size();
 }
 
+/**
+ * Mark the output of the module at the given index as changed
+ *
+ * Only the first change after an update wakes up the eventqueue, all
+ * further changes are picked up by the update it schedules.
+ *
+ * Changes made on the module event loop only wake up the eventqueue once
+ * the current round of the loop is done, so that all modules updated in
+ * the same round end up in the same update.
+ */
+void controller::notify_change(size_t index) {
+  if (!m_changes->mark(index)) {
+    return;
+  }
+
+  auto& loop = eventloop::make();
+  if (loop.in_loop_thread()) {
+    loop.defer_unique("notify_change", [this] { enqueue(make_update_evt(false)); });
+  } else {
+    enqueue(make_update_evt(false));
+  }
+}
+
 /**
  * Process broadcast events
+ *
+ * Only sent by modules without change handler, it is not known which of
+ * them changed so all modules are checked.
  */
 bool controller::on(const signals::eventqueue::notify_change&) {
-  return enqueue(make_update_evt(false));
+  return enqueue(make_update_evt(true));
 }
 
 /**
@@ -754,7 +990,7 @@ bool controller::on(const signals::eventqueue::check_state&) {
       return true;
     }
   }
-  m_log.warn("No running modules...");
+  POLYBAR_LOG_WARN(m_log, "No running modules...");
   on(signals::eventqueue::exit_terminate{});
   return true;
 }
@@ -785,7 +1021,7 @@ bool controller::on(const signals::ui::button_press& evt) {
   string input{evt.cast()};
 
   if (input.empty()) {
-    m_log.err("Cannot enqueue empty input");
+    POLYBAR_LOG_ERR(m_log, "Cannot enqueue empty input");
     return false;
   }
 
@@ -800,11 +1036,11 @@ bool controller::on(const signals::ipc::action& evt) {
   string action{evt.cast()};
 
   if (action.empty()) {
-    m_log.err("Cannot enqueue empty ipc action");
+    POLYBAR_LOG_ERR(m_log, "Cannot enqueue empty ipc action");
     return false;
   }
 
-  m_log.info("Enqueuing ipc action: %s", action);
+  POLYBAR_LOG_INFO(m_log, "Enqueuing ipc action: %s", action);
   enqueue(move(action));
   return true;
 }
@@ -829,8 +1065,20 @@ bool controller::on(const signals::ipc::command& evt) {
     m_bar->show();
   } else if (command == "toggle") {
     m_bar->toggle();
+  } else if (command == "stats" || command.compare(0, 6, "stats ") == 0) {
+    // polybar-msg passes the fifo it expects the reply in
+    auto reply_path = string_util::trim(command.substr(5), ' ');
+    if (reply_path.empty()) {
+      POLYBAR_LOG_NOTICE(m_log, "Stats: %s", stats());
+    } else {
+      try {
+        m_ipc->reply(reply_path, stats());
+      } catch (const exception& err) {
+        POLYBAR_LOG_ERR(m_log, "Failed to send stats (err: %s)", err.what());
+      }
+    }
   } else {
-    m_log.warn("\"%s\" is not a valid ipc command", command);
+    POLYBAR_LOG_WARN(m_log, "\"%s\" is not a valid ipc command", command);
   }
 
   return true;
@@ -0,0 +1,411 @@
+#include "components/eventloop.hpp"
+
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <limits>
+
+#include "utils/factory.hpp"
+#include "utils/trace.hpp"
+
+POLYBAR_NS
+
+namespace {
+  /**
+   * Epoll keys reserved for the internal wakeup eventfd and timerfd
+   */
+  constexpr uint64_t WAKEUP_KEY{0};
+  constexpr uint64_t TIMER_KEY{std::numeric_limits<uint64_t>::max()};
+
+  /**
+   * Maximum number of events fetched per epoll_wait
+   */
+  constexpr int MAX_EVENTS{32};
+
+  struct itimerspec make_itimerspec(eventloop::clock::time_point when) {
+    auto since_epoch = when.time_since_epoch();
+    auto secs = chrono::duration_cast<chrono::seconds>(since_epoch);
+    auto nsecs = chrono::duration_cast<chrono::nanoseconds>(since_epoch - secs);
+
+    struct itimerspec spec {};
+    spec.it_value.tv_sec = secs.count();
+    spec.it_value.tv_nsec = nsecs.count();
+
+    // A zero it_value disarms the timer, make sure past deadlines still fire
+    if (spec.it_value.tv_sec <= 0 && spec.it_value.tv_nsec <= 0) {
+      spec.it_value.tv_nsec = 1;
+    }
+    return spec;
+  }
+
+  void add_internal(int epollfd, int fd, uint64_t key) {
+    struct epoll_event ev {};
+    ev.events = EPOLLIN;
+    ev.data.u64 = key;
+
+    if (epoll_ctl(epollfd, EPOLL_CTL_ADD, fd, &ev) == -1) {
+      throw system_error("Failed to add internal fd to epoll set");
+    }
+  }
+}  // namespace
+
+/**
+ * Get the shared event loop used by the modules
+ *
+ * Module timers are coalesced into 50ms slack windows so that
+ * modules which are due at about the same time update together
+ */
+eventloop::make_type eventloop::make() {
+  return *factory_util::singleton<eventloop>(chrono::milliseconds{50});
+}
+
+/**
+ * Construct event loop
+ */
+eventloop::eventloop(clock::duration resolution) : m_wheel(resolution) {
+  try {
+    if ((m_epollfd = epoll_create1(EPOLL_CLOEXEC)) == -1) {
+      throw system_error("Failed to create epoll instance");
+    }
+    if ((m_wakeupfd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC)) == -1) {
+      throw system_error("Failed to create wakeup eventfd");
+    }
+    if ((m_timerfd = timerfd_create(CLOCK_REALTIME, TFD_NONBLOCK | TFD_CLOEXEC)) == -1) {
+      throw system_error("Failed to create timerfd");
+    }
+    add_internal(m_epollfd, m_wakeupfd, WAKEUP_KEY);
+    add_internal(m_epollfd, m_timerfd, TIMER_KEY);
+  } catch (const system_error&) {
+    for (auto fd : {m_timerfd, m_wakeupfd, m_epollfd}) {
+      if (fd != -1) {
+        close(fd);
+      }
+    }
+    throw;
+  }
+}
+
+/**
+ * Deconstruct event loop
+ */
+eventloop::~eventloop() {
+  stop();
+
+  if (m_thread.joinable()) {
+    m_thread.detach();
+  }
+
+  close(m_timerfd);
+  close(m_wakeupfd);
+  close(m_epollfd);
+}
+
+/**
+ * Register a file descriptor
+ *
+ * The descriptor is not owned by the loop and needs
+ * to be removed before it gets closed by its owner
+ */
+eventloop::handle_t eventloop::add_fd(int fd, unsigned int events, fd_callback cb) {
+  std::lock_guard<std::mutex> guard(m_lock);
+
+  handle_t handle{++m_nexthandle};
+
+  struct epoll_event ev {};
+  ev.events = events;
+  ev.data.u64 = handle;
+
+  if (epoll_ctl(m_epollfd, EPOLL_CTL_ADD, fd, &ev) == -1) {
+    throw system_error("Failed to add fd " + to_string(fd) + " to epoll set");
+  }
+
+  auto h = make_shared<handler>();
+  h->fd = fd;
+  h->func = move(cb);
+  m_handlers.emplace(handle, move(h));
+
+  return handle;
+}
+
+/**
+ * Register a one-shot timer firing at the given wall clock time
+ *
+ * The timer can be re-armed using reschedule() and needs
+ * to be released using remove()
+ */
+eventloop::handle_t eventloop::add_timer(clock::time_point when, callback cb) {
+  std::lock_guard<std::mutex> guard(m_lock);
+
+  handle_t handle{++m_nexthandle};
+
+  auto h = make_shared<handler>();
+  h->func = [cb](int, unsigned int) { cb(); };
+  m_handlers.emplace(handle, move(h));
+
+  m_wheel.schedule(handle, when);
+  arm_timer();
+
+  return handle;
+}
+
+/**
+ * Re-arm a timer created with add_timer()
+ */
+void eventloop::reschedule(handle_t handle, clock::time_point when) {
+  std::lock_guard<std::mutex> guard(m_lock);
+  auto it = m_handlers.find(handle);
+
+  if (it == m_handlers.end() || it->second->fd != -1) {
+    return;
+  }
+
+  m_wheel.schedule(handle, when);
+  arm_timer();
+}
+
+/**
+ * Remove a previously registered handler
+ *
+ * Blocks until any in-flight invocation of the handler
+ * has returned, unless called from the loop thread
+ */
+void eventloop::remove(handle_t handle) {
+  std::unique_lock<std::mutex> guard(m_lock);
+  auto it = m_handlers.find(handle);
+
+  if (it == m_handlers.end()) {
+    return;
+  }
+
+  if (it->second->fd != -1) {
+    epoll_ctl(m_epollfd, EPOLL_CTL_DEL, it->second->fd, nullptr);
+  } else if (m_wheel.cancel(handle)) {
+    arm_timer();
+  }
+
+  m_handlers.erase(it);
+
+  if (m_loop_thread != std::this_thread::get_id()) {
+    m_dispatched.wait(guard, [&] { return m_dispatching != handle; });
+  }
+}
+
+/**
+ * Queue a callback to be run on the loop thread
+ */
+void eventloop::post(callback cb) {
+  {
+    std::lock_guard<std::mutex> guard(m_lock);
+    m_posted.emplace_back(move(cb));
+  }
+  wakeup();
+}
+
+/**
+ * Queue a callback to be run on the loop thread once the
+ * current round of events has been dispatched
+ *
+ * Callbacks deferred with the same id during a round are merged
+ */
+void eventloop::defer_unique(string id, callback cb) {
+  std::unique_lock<std::mutex> guard(m_lock);
+
+  for (auto&& d : m_deferred) {
+    if (d.first == id) {
+      return;
+    }
+  }
+
+  m_deferred.emplace_back(move(id), move(cb));
+
+  if (m_loop_thread != std::this_thread::get_id()) {
+    guard.unlock();
+    wakeup();
+  }
+}
+
+/**
+ * Interrupt a blocking epoll_wait
+ */
+void eventloop::wakeup() {
+  uint64_t value{1};
+  if (::write(m_wakeupfd, &value, sizeof(value)) == -1 && errno != EAGAIN) {
+    throw system_error("Failed to write to wakeup eventfd");
+  }
+}
+
+/**
+ * Run the loop on the calling thread until stop() is called
+ */
+void eventloop::run() {
+  if (m_running.exchange(true)) {
+    throw eventloop_error("Event loop is already running");
+  }
+  loop();
+}
+
+/**
+ * Start the loop on a background thread, unless it is already running
+ */
+void eventloop::start() {
+  if (m_running.exchange(true)) {
+    return;
+  }
+  m_thread = std::thread(&eventloop::loop, this);
+}
+
+/**
+ * Stop the loop and join the background thread
+ */
+void eventloop::stop() {
+  if (m_running.exchange(false)) {
+    wakeup();
+  }
+
+  if (m_thread.joinable() && m_thread.get_id() != std::this_thread::get_id()) {
+    m_thread.join();
+  }
+}
+
+bool eventloop::running() const {
+  return m_running;
+}
+
+bool eventloop::in_loop_thread() {
+  std::lock_guard<std::mutex> guard(m_lock);
+  return m_loop_thread == std::this_thread::get_id();
+}
+
+void eventloop::loop() {
+  struct epoll_event events[MAX_EVENTS];
+  trace_util::thread_name("eventloop");
+
+  {
+    std::lock_guard<std::mutex> guard(m_lock);
+    m_loop_thread = std::this_thread::get_id();
+  }
+
+  while (m_running) {
+    int count{epoll_wait(m_epollfd, events, MAX_EVENTS, -1)};
+
+    if (count == -1) {
+      if (errno == EINTR) {
+        continue;
+      }
+      throw system_error("Failed to wait for events");
+    }
+
+    for (int i = 0; i < count && m_running; i++) {
+      if (events[i].data.u64 == WAKEUP_KEY) {
+        uint64_t value;
+        while (::read(m_wakeupfd, &value, sizeof(value)) > 0) {
+        }
+        drain_posted();
+      } else if (events[i].data.u64 == TIMER_KEY) {
+        expire_timers();
+      } else {
+        dispatch(static_cast<handle_t>(events[i].data.u64), events[i].events);
+      }
+    }
+
+    if (m_running) {
+      run_deferred();
+    }
+  }
+
+  std::lock_guard<std::mutex> guard(m_lock);
+  m_loop_thread = std::thread::id{};
+}
+
+void eventloop::dispatch(handle_t handle, unsigned int events) {
+  std::unique_lock<std::mutex> guard(m_lock);
+  auto it = m_handlers.find(handle);
+
+  if (it == m_handlers.end()) {
+    return;
+  }
+
+  auto h = it->second;
+  m_dispatching = handle;
+  guard.unlock();
+
+  h->func(h->fd, events);
+
+  guard.lock();
+  m_dispatching = 0;
+  guard.unlock();
+  m_dispatched.notify_all();
+}
+
+/**
+ * Dispatch all timers that are due, as one round
+ */
+void eventloop::expire_timers() {
+  uint64_t expirations;
+  while (::read(m_timerfd, &expirations, sizeof(expirations)) > 0) {
+  }
+
+  vector<timer_wheel::id_t> expired;
+  {
+    std::lock_guard<std::mutex> guard(m_lock);
+    m_armed = clock::time_point{};
+    expired = m_wheel.expire(clock::now());
+  }
+
+  for (auto&& handle : expired) {
+    dispatch(handle, EPOLLIN);
+  }
+
+  std::lock_guard<std::mutex> guard(m_lock);
+  arm_timer();
+}
+
+/**
+ * Arm the timerfd for the earliest deadline in the wheel,
+ * expects m_lock to be held
+ */
+void eventloop::arm_timer() {
+  struct itimerspec spec {};
+  clock::time_point when{};
+
+  if (!m_wheel.empty()) {
+    when = m_wheel.next_expiry();
+    spec = make_itimerspec(when);
+  }
+
+  if (when == m_armed) {
+    return;
+  }
+
+  if (timerfd_settime(m_timerfd, TFD_TIMER_ABSTIME, &spec, nullptr) == -1) {
+    throw system_error("Failed to arm timerfd");
+  }
+
+  m_armed = when;
+}
+
+void eventloop::drain_posted() {
+  vector<callback> posted;
+  {
+    std::lock_guard<std::mutex> guard(m_lock);
+    std::swap(posted, m_posted);
+  }
+  for (auto&& cb : posted) {
+    cb();
+  }
+}
+
+void eventloop::run_deferred() {
+  vector<pair<string, callback>> deferred;
+  {
+    std::lock_guard<std::mutex> guard(m_lock);
+    std::swap(deferred, m_deferred);
+  }
+  for (auto&& d : deferred) {
+    d.second();
+  }
+}
+
+POLYBAR_NS_END
@@ -0,0 +1,74 @@
+#include "components/frame_scheduler.hpp"
+
+#include <algorithm>
+
+POLYBAR_NS
+
+/**
+ * Construct scheduler, a max_fps of 0 disables the frame budget
+ */
+frame_scheduler::frame_scheduler(unsigned int max_fps)
+    : m_budget(max_fps ? chrono::duration_cast<clock::duration>(chrono::seconds{1}) / max_fps : clock::duration{0}) {}
+
+/**
+ * Request a new frame
+ *
+ * If a frame is already pending the request is merged into it,
+ * otherwise a frame is scheduled as soon as the budget allows.
+ */
+void frame_scheduler::request(bool force, clock::time_point now) {
+  if (m_pending) {
+    m_stats.merged++;
+    m_force = m_force || force;
+    return;
+  }
+
+  m_pending = true;
+  m_force = force;
+  m_deadline = m_rendered_once ? std::max(now, m_last_frame + m_budget) : now;
+}
+
+/**
+ * Mark the pending frame as rendered
+ *
+ * Budget slots that passed while the frame was overdue are counted
+ * as dropped frames.
+ *
+ * \returns true if the frame has to be forced
+ */
+bool frame_scheduler::begin_frame(clock::time_point now) {
+  bool force{m_force};
+
+  if (m_pending && m_budget.count() > 0 && now > m_deadline + m_budget) {
+    m_stats.dropped += (now - m_deadline) / m_budget;
+  }
+
+  m_pending = false;
+  m_force = false;
+  m_last_frame = now;
+  m_rendered_once = true;
+  m_stats.rendered++;
+
+  return force;
+}
+
+bool frame_scheduler::pending() const {
+  return m_pending;
+}
+
+/**
+ * Time at which the pending frame is due
+ */
+frame_scheduler::clock::time_point frame_scheduler::deadline() const {
+  return m_deadline;
+}
+
+frame_scheduler::clock::duration frame_scheduler::budget() const {
+  return m_budget;
+}
+
+const frame_scheduler::stats& frame_scheduler::get_stats() const {
+  return m_stats;
+}
+
+POLYBAR_NS_END
@@ -0,0 +1,62 @@
+#include "components/headless_renderer.hpp"
+
+#include "cairo/surface.hpp"
+#include "components/config.hpp"
+#include "components/logger.hpp"
+#include "utils/factory.hpp"
+
+POLYBAR_NS
+
+/**
+ * Dpi used if the config doesn't set one, there is no screen to take it from
+ */
+static constexpr double DEFAULT_DPI{96.0};
+
+/**
+ * Create instance
+ */
+headless_renderer::make_type headless_renderer::make(const bar_settings& bar, tags::action_context& action_ctxt) {
+  return factory_util::unique<headless_renderer>(config::make(), logger::make(), bar, action_ctxt);
+}
+
+/**
+ * Construct renderer drawing into an image of the size of the bar
+ */
+headless_renderer::headless_renderer(
+    const config& conf, const logger& logger, const bar_settings& bar, tags::action_context& action_ctxt)
+    : renderer(conf, logger, bar, action_ctxt) {
+  auto surface = make_unique<cairo::image_surface>(m_bar.size.w, m_bar.size.h);
+  m_image = surface.get();
+  init(move(surface), DEFAULT_DPI, DEFAULT_DPI);
+}
+
+headless_renderer::~headless_renderer() {}
+
+/**
+ * Image holding the newest frame
+ */
+const cairo::image_surface& headless_renderer::image() const {
+  return *m_image;
+}
+
+void headless_renderer::write_png(const string& dst) {
+  m_image->write_png(dst);
+}
+
+const vector<xcb_rectangle_t>& headless_renderer::damage() const {
+  return m_damage;
+}
+
+size_t headless_renderer::frames() const {
+  return m_frames;
+}
+
+void headless_renderer::present(const vector<xcb_rectangle_t>& areas) {
+  m_damage = areas;
+
+  if (!areas.empty()) {
+    m_frames++;
+  }
+}
+
+POLYBAR_NS_END
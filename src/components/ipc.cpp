@@ -1,8 +1,11 @@
 #include "components/ipc.hpp"
 
 #include <fcntl.h>
+#include <poll.h>
 #include <sys/stat.h>
 
+#include <csignal>
+
 #include "components/logger.hpp"
 #include "errors.hpp"
 #include "events/signal.hpp"
@@ -16,14 +19,15 @@ POLYBAR_NS
 /**
  * Create instance
  */
-ipc::make_type ipc::make() {
-  return factory_util::unique<ipc>(signal_emitter::make(), logger::make());
+ipc::make_type ipc::make(eventloop& loop) {
+  return factory_util::unique<ipc>(signal_emitter::make(), logger::make(), loop);
 }
 
 /**
  * Construct ipc handler
  */
-ipc::ipc(signal_emitter& emitter, const logger& logger) : m_sig(emitter), m_log(logger) {
+ipc::ipc(signal_emitter& emitter, const logger& logger, eventloop& loop)
+    : m_sig(emitter), m_log(logger), m_loop(loop) {
   m_path = string_util::replace(PATH_MESSAGING_FIFO, "%pid%", to_string(getpid()));
 
   if (file_util::exists(m_path) && unlink(m_path.c_str()) == -1) {
@@ -33,18 +37,20 @@ ipc::ipc(signal_emitter& emitter, const logger& logger) : m_sig(emitter), m_log(
     throw system_error("Failed to create ipc channel");
   }
 
-  m_log.info("Created ipc channel at: %s", m_path);
+  POLYBAR_LOG_INFO(m_log, "Created ipc channel at: %s", m_path);
   m_fd = file_util::make_file_descriptor(m_path, O_RDONLY | O_NONBLOCK);
+  watch();
 }
 
 /**
  * Deconstruct ipc handler
  */
 ipc::~ipc() {
+  m_loop.remove(m_handle);
   m_fd.reset();
 
   if (!m_path.empty()) {
-    m_log.trace("ipc: Removing file handle");
+    POLYBAR_LOG_TRACE(m_log, "ipc: Removing file handle");
     unlink(m_path.c_str());
   }
 }
@@ -53,13 +59,13 @@ ipc::~ipc() {
  * Receive available ipc messages and delegate valid events
  */
 void ipc::receive_message() {
-  m_log.info("Receiving ipc message");
+  POLYBAR_LOG_INFO(m_log, "Receiving ipc message");
 
   char buffer[BUFSIZ]{'\0'};
   ssize_t bytes_read{0};
 
   if ((bytes_read = read(*m_fd, &buffer, BUFSIZ)) == -1) {
-    m_log.err("Failed to read from ipc channel (err: %s)", strerror(errno));
+    POLYBAR_LOG_ERR(m_log, "Failed to read from ipc channel (err: %s)", strerror(errno));
   } else if (bytes_read > 0) {
     string payload{string_util::trim(string{buffer}, '\n')};
 
@@ -70,13 +76,27 @@ void ipc::receive_message() {
     } else if (payload.find(ipc_action_prefix) == 0) {
       m_sig.emit(signals::ipc::action{payload.substr(strlen(ipc_action_prefix))});
     } else if (!payload.empty()) {
-      m_log.warn("Received unknown ipc message: (payload=%s)", payload);
+      POLYBAR_LOG_WARN(m_log, "Received unknown ipc message: (payload=%s)", payload);
     }
   }
 
   m_fd = file_util::make_file_descriptor(m_path, O_RDONLY | O_NONBLOCK);
 }
 
+/**
+ * Register the channel with the event loop
+ *
+ * The fifo is reopened after each message, so the handler replaces
+ * itself with one for the new fd
+ */
+void ipc::watch() {
+  m_handle = m_loop.add_fd(*m_fd, EPOLLIN, [this](int, unsigned int) {
+    m_loop.remove(m_handle);
+    receive_message();
+    watch();
+  });
+}
+
 /**
  * Get the file descriptor to the ipc channel
  */
@@ -84,4 +104,63 @@ int ipc::get_file_descriptor() const {
   return *m_fd;
 }
 
+/**
+ * Send a reply to the sender of a message
+ *
+ * The sender passes the path of a fifo it reads the reply from. Nothing but
+ * fifos is written to, so that messages can't be used to overwrite files.
+ * Gives up if the sender doesn't read the reply within a second.
+ */
+void ipc::reply(const string& path, const string& payload) const {
+  file_descriptor fd(path, O_WRONLY | O_NONBLOCK);
+
+  struct stat st {};
+  if (fstat(fd, &st) == -1 || !S_ISFIFO(st.st_mode)) {
+    throw application_error("Reply channel is not a fifo: " + path);
+  }
+
+  // A sender that goes away would otherwise kill us with SIGPIPE
+  sigset_t pipe_mask;
+  sigset_t old_mask;
+  sigset_t pending;
+  sigemptyset(&pipe_mask);
+  sigaddset(&pipe_mask, SIGPIPE);
+  pthread_sigmask(SIG_BLOCK, &pipe_mask, &old_mask);
+  sigpending(&pending);
+  bool was_pending = sigismember(&pending, SIGPIPE);
+
+  size_t written{0};
+  int error{0};
+
+  while (written < payload.size()) {
+    auto bytes = write(fd, payload.data() + written, payload.size() - written);
+    if (bytes >= 0) {
+      written += bytes;
+      continue;
+    } else if (errno != EAGAIN) {
+      error = errno;
+      break;
+    }
+
+    struct pollfd pfd {
+      fd, POLLOUT, 0
+    };
+    if (poll(&pfd, 1, 1000) != 1) {
+      error = ETIMEDOUT;
+      break;
+    }
+  }
+
+  if (error == EPIPE && !was_pending) {
+    struct timespec timeout {};
+    sigtimedwait(&pipe_mask, nullptr, &timeout);
+  }
+  pthread_sigmask(SIG_SETMASK, &old_mask, nullptr);
+
+  if (error != 0) {
+    errno = error;
+    throw system_error("Failed to write reply to " + path);
+  }
+}
+
 POLYBAR_NS_END
@@ -1,7 +1,18 @@
 #include "components/logger.hpp"
 
+#include <pthread.h>
+#include <semaphore.h>
+#include <sys/uio.h>
 #include <unistd.h>
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cerrno>
+#include <condition_variable>
+#include <cstdarg>
+#include <mutex>
+
 #include "errors.hpp"
 #include "settings.hpp"
 #include "utils/concurrency.hpp"
@@ -10,6 +21,306 @@
 
 POLYBAR_NS
 
+namespace {
+  /**
+   * Writes the log messages of all logger instances to stderr
+   *
+   * Messages are formatted into the slots of a bounded lock-free queue by the
+   * thread that logs them. A background thread adds the prefixes and does the
+   * actual writing, so logging never waits on stderr. If the queue is full,
+   * the message is dropped and counted instead.
+   *
+   * In forked children and while the process exits, messages are written
+   * directly since the writer thread is not around anymore.
+   */
+  class log_writer {
+   public:
+    static log_writer& instance() {
+      // Never destroyed, loggers may still be used by other static objects
+      static log_writer* writer{new log_writer()};
+      return *writer;
+    }
+
+    void push(loglevel level, const char* format, va_list args) {
+      if (!m_async) {
+        write_direct(level, format, args);
+        return;
+      }
+
+      size_t pos = m_head.load(std::memory_order_relaxed);
+      slot* s{nullptr};
+
+      while (true) {
+        s = &m_slots[pos % SLOTS];
+        auto seq = s->seq.load(std::memory_order_acquire);
+        auto diff = static_cast<ptrdiff_t>(seq) - static_cast<ptrdiff_t>(pos);
+
+        if (diff == 0) {
+          if (m_head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+            break;
+          }
+        } else if (diff < 0) {
+          m_dropped.fetch_add(1, std::memory_order_relaxed);
+          return;
+        } else {
+          pos = m_head.load(std::memory_order_relaxed);
+        }
+      }
+
+      s->level = level;
+      s->length = format_into(s->text, s->overflow, format, args);
+      s->seq.store(pos + 1, std::memory_order_release);
+
+      sem_post(&m_ready);
+    }
+
+    /**
+     * Wait until all messages queued so far are written
+     */
+    void flush() {
+      if (!m_async) {
+        return;
+      }
+
+      auto target = m_head.load(std::memory_order_acquire);
+      std::unique_lock<std::mutex> guard(m_lock);
+      sem_post(&m_ready);
+      m_written.wait(guard, [&] { return m_tail >= target || !m_async; });
+    }
+
+   private:
+    static constexpr size_t SLOTS{512};
+    static constexpr size_t LINE{512};
+
+    /**
+     * Number of messages that are handed to a single writev() call
+     */
+    static constexpr size_t BATCH{16};
+
+    struct slot {
+      std::atomic<size_t> seq;
+      loglevel level{loglevel::NONE};
+      size_t length{0};
+      char text[LINE];
+
+      /**
+       * Used instead of the text for messages that don't fit into it
+       */
+      string overflow;
+    };
+
+    log_writer() {
+      bool tty = isatty(STDERR_FILENO);
+
+      // clang-format off
+      if (tty) {
+        m_prefixes[static_cast<size_t>(loglevel::TRACE)]   = "\r\033[0;32m- \033[0m";
+        m_prefixes[static_cast<size_t>(loglevel::INFO)]    = "\r\033[1;32m* \033[0m";
+        m_prefixes[static_cast<size_t>(loglevel::NOTICE)]  = "\r\033[1;34mnotice: \033[0m";
+        m_prefixes[static_cast<size_t>(loglevel::WARNING)] = "\r\033[1;33mwarn: \033[0m";
+        m_prefixes[static_cast<size_t>(loglevel::ERROR)]   = "\r\033[1;31merror: \033[0m";
+      } else {
+        m_prefixes[static_cast<size_t>(loglevel::TRACE)]   = "polybar|trace: ";
+        m_prefixes[static_cast<size_t>(loglevel::INFO)]    = "polybar|info:  ";
+        m_prefixes[static_cast<size_t>(loglevel::NOTICE)]  = "polybar|notice:  ";
+        m_prefixes[static_cast<size_t>(loglevel::WARNING)] = "polybar|warn:  ";
+        m_prefixes[static_cast<size_t>(loglevel::ERROR)]   = "polybar|error: ";
+      }
+      // clang-format on
+      m_suffix = tty ? "\033[0m\n" : "\n";
+
+      for (size_t i = 0; i < SLOTS; i++) {
+        m_slots[i].seq.store(i, std::memory_order_relaxed);
+      }
+
+      sem_init(&m_ready, 0, 0);
+      m_thread = std::thread(&log_writer::run, this);
+
+      pthread_atfork(nullptr, nullptr, [] { instance().m_async = false; });
+      std::atexit([] { instance().stop(); });
+    }
+
+    /**
+     * Format the message into the given buffer, or into the overflow string
+     * if it is too long
+     *
+     * \returns Length of the formatted message
+     */
+    static size_t format_into(char* text, string& overflow, const char* format, va_list args) {
+      va_list copy;
+      va_copy(copy, args);
+
+#if defined(__clang__)  // {{{
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wformat-nonliteral"
+#elif defined(__GNUC__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wformat-nonliteral"
+#endif  // }}}
+
+      int length = vsnprintf(text, LINE, format, args);
+      if (length >= static_cast<int>(LINE)) {
+        overflow.resize(length + 1);
+        vsnprintf(&overflow[0], overflow.size(), format, copy);
+        overflow.resize(length);
+      }
+
+#if defined(__clang__)  // {{{
+#pragma clang diagnostic pop
+#elif defined(__GNUC__)
+#pragma GCC diagnostic pop
+#endif  // }}}
+
+      va_end(copy);
+      return std::max(length, 0);
+    }
+
+    void write_direct(loglevel level, const char* format, va_list args) {
+      char text[LINE];
+      string overflow;
+      auto length = format_into(text, overflow, format, args);
+
+      std::array<iovec, 3> iov;
+      fill(&iov[0], level, length < LINE ? text : overflow.data(), length);
+      write_all(iov.data(), iov.size());
+    }
+
+    /**
+     * Point the given three iovecs to the parts of a single line
+     */
+    void fill(iovec* iov, loglevel level, const char* text, size_t length) {
+      const auto& prefix = m_prefixes[static_cast<size_t>(level)];
+      iov[0] = {const_cast<char*>(prefix.data()), prefix.size()};
+      iov[1] = {const_cast<char*>(text), length};
+      iov[2] = {const_cast<char*>(m_suffix.data()), m_suffix.size()};
+    }
+
+    static void write_all(iovec* iov, size_t count) {
+      while (count > 0) {
+        auto written = writev(STDERR_FILENO, iov, static_cast<int>(count));
+        if (written == -1) {
+          if (errno == EINTR) {
+            continue;
+          }
+          return;
+        }
+
+        // Skip what was written, the next call picks up in the middle of a partial iovec
+        auto n = static_cast<size_t>(written);
+        while (count > 0 && n >= iov->iov_len) {
+          n -= iov->iov_len;
+          iov++;
+          count--;
+        }
+        if (count > 0) {
+          iov->iov_base = static_cast<char*>(iov->iov_base) + n;
+          iov->iov_len -= n;
+        }
+      }
+    }
+
+    /**
+     * Write out all queued messages
+     *
+     * Only called from the writer thread, or while it is not running.
+     */
+    void drain() {
+      std::array<iovec, BATCH * 3 + 3> iov;
+      char notice[64];
+
+      while (true) {
+        size_t count{0};
+        size_t lines{0};
+
+        auto dropped = m_dropped.exchange(0, std::memory_order_relaxed);
+        if (dropped > 0) {
+          auto length = snprintf(notice, sizeof(notice), "Dropped %zu log messages", dropped);
+          fill(&iov[count], loglevel::WARNING, notice, std::min<size_t>(length, sizeof(notice) - 1));
+          count += 3;
+        }
+
+        size_t tail = m_tail;
+        while (lines < BATCH) {
+          auto& s = m_slots[(tail + lines) % SLOTS];
+          if (s.seq.load(std::memory_order_acquire) != tail + lines + 1) {
+            break;
+          }
+          fill(&iov[count], s.level, s.length < LINE ? s.text : s.overflow.data(), s.length);
+          count += 3;
+          lines++;
+        }
+
+        if (count == 0) {
+          return;
+        }
+
+        write_all(iov.data(), count);
+
+        for (size_t i = 0; i < lines; i++) {
+          auto& s = m_slots[(tail + i) % SLOTS];
+          if (!s.overflow.empty()) {
+            string().swap(s.overflow);
+          }
+          s.seq.store(tail + i + SLOTS, std::memory_order_release);
+        }
+
+        std::lock_guard<std::mutex> guard(m_lock);
+        m_tail = tail + lines;
+        m_written.notify_all();
+      }
+    }
+
+    void run() {
+      while (!m_stopping.load(std::memory_order_acquire)) {
+        if (sem_wait(&m_ready) == -1) {
+          continue;
+        }
+        drain();
+      }
+    }
+
+    /**
+     * Write out the remaining messages and stop the writer thread
+     *
+     * Messages logged afterwards are written directly.
+     */
+    void stop() {
+      if (!m_async) {
+        return;
+      }
+
+      m_stopping.store(true, std::memory_order_release);
+      sem_post(&m_ready);
+      m_thread.join();
+
+      drain();
+
+      std::lock_guard<std::mutex> guard(m_lock);
+      m_async = false;
+      m_written.notify_all();
+    }
+
+    std::array<slot, SLOTS> m_slots;
+    std::atomic<size_t> m_head{0};
+    std::atomic<size_t> m_dropped{0};
+
+    /**
+     * First slot that was not written out yet, guarded by m_lock
+     */
+    size_t m_tail{0};
+    std::mutex m_lock;
+    std::condition_variable m_written;
+
+    sem_t m_ready;
+    std::atomic<bool> m_async{true};
+    std::atomic<bool> m_stopping{false};
+    std::thread m_thread;
+
+    std::array<string, static_cast<size_t>(loglevel::TRACE) + 1> m_prefixes;
+    string m_suffix;
+  };
+}  // namespace
+
 /**
  * Convert string
  */
@@ -38,32 +349,20 @@ logger::make_type logger::make(loglevel level) {
 /**
  * Construct logger
  */
-logger::logger(loglevel level) : m_level(level) {
-  // clang-format off
-  if (isatty(m_fd)) {
-    m_prefixes[loglevel::TRACE]   = "\r\033[0;32m- \033[0m";
-    m_prefixes[loglevel::INFO]    = "\r\033[1;32m* \033[0m";
-    m_prefixes[loglevel::NOTICE]  = "\r\033[1;34mnotice: \033[0m";
-    m_prefixes[loglevel::WARNING] = "\r\033[1;33mwarn: \033[0m";
-    m_prefixes[loglevel::ERROR]   = "\r\033[1;31merror: \033[0m";
-    m_suffixes[loglevel::TRACE]   = "\033[0m";
-    m_suffixes[loglevel::INFO]    = "\033[0m";
-    m_suffixes[loglevel::NOTICE]  = "\033[0m";
-    m_suffixes[loglevel::WARNING] = "\033[0m";
-    m_suffixes[loglevel::ERROR]   = "\033[0m";
-  } else {
-    m_prefixes.emplace(make_pair(loglevel::TRACE,   "polybar|trace: "));
-    m_prefixes.emplace(make_pair(loglevel::INFO,    "polybar|info:  "));
-    m_prefixes.emplace(make_pair(loglevel::NOTICE,  "polybar|notice:  "));
-    m_prefixes.emplace(make_pair(loglevel::WARNING, "polybar|warn:  "));
-    m_prefixes.emplace(make_pair(loglevel::ERROR,   "polybar|error: "));
-    m_suffixes.emplace(make_pair(loglevel::TRACE,   ""));
-    m_suffixes.emplace(make_pair(loglevel::INFO,    ""));
-    m_suffixes.emplace(make_pair(loglevel::NOTICE,  ""));
-    m_suffixes.emplace(make_pair(loglevel::WARNING, ""));
-    m_suffixes.emplace(make_pair(loglevel::ERROR,   ""));
-  }
-  // clang-format on
+logger::logger(loglevel level) : m_level(level) {}
+
+/**
+ * Wait until all messages logged so far are written out
+ */
+void logger::flush() {
+  log_writer::instance().flush();
+}
+
+void logger::write(loglevel level, const char* format, ...) const {
+  va_list args;
+  va_start(args, format);
+  log_writer::instance().push(level, format, args);
+  va_end(args);
 }
 
 /**
@@ -0,0 +1,38 @@
+#include "components/metrics.hpp"
+
+POLYBAR_NS
+
+/**
+ * Module timings as a JSON object
+ *
+ * The broadcast rate is the average number of broadcasts per second since
+ * the module was created.
+ */
+string module_metrics::to_json() const {
+  auto uptime = chrono::duration_cast<chrono::milliseconds>(histogram::clock::now() - since).count();
+  auto n = broadcasts.load(std::memory_order_relaxed);
+  auto rate = uptime > 0 ? n * 1000.0 / uptime : 0.0;
+
+  // clang-format off
+  return "{\"broadcasts\":" + to_string(n) +
+    ",\"broadcasts_per_second\":" + to_string(rate) +
+    ",\"update\":" + update.to_json() +
+    ",\"build\":" + build.to_json() +
+    ",\"update_lock_wait\":" + update_lock.to_json() +
+    ",\"build_lock_wait\":" + build_lock.to_json() + "}";
+  // clang-format on
+}
+
+/**
+ * Frame timings as a JSON object
+ */
+string frame_metrics::to_json() const {
+  // clang-format off
+  return "{\"parse\":" + parse.to_json() +
+    ",\"layout\":" + layout.to_json() +
+    ",\"raster\":" + raster.to_json() +
+    ",\"present\":" + present.to_json() + "}";
+  // clang-format on
+}
+
+POLYBAR_NS_END
@@ -0,0 +1,129 @@
+#include "components/render_thread.hpp"
+
+#include "components/logger.hpp"
+#include "errors.hpp"
+#include "utils/trace.hpp"
+
+POLYBAR_NS
+
+constexpr std::chrono::milliseconds render_thread::RETRY_INTERVAL;
+
+/**
+ * Construct instance and start the rendering thread
+ */
+render_thread::render_thread(const logger& logger, render_fn render, ready_fn ready)
+    : m_log(logger), m_render(move(render)), m_ready(move(ready)) {
+  m_thread = std::thread(&render_thread::run, this);
+}
+
+/**
+ * Stop the rendering thread
+ *
+ * Frames and tasks that did not run yet are discarded.
+ */
+render_thread::~render_thread() {
+  {
+    std::lock_guard<std::mutex> guard(m_lock);
+    m_active = false;
+  }
+  m_cond.notify_one();
+
+  if (m_thread.joinable()) {
+    m_thread.join();
+  }
+}
+
+/**
+ * Queue a frame, replacing any frame that was not drawn yet
+ *
+ * A replaced frame that forced a full redraw passes that on to the new frame.
+ */
+void render_thread::submit(frame&& f) {
+  {
+    std::lock_guard<std::mutex> guard(m_lock);
+    if (m_pending) {
+      m_stats.replaced++;
+      f.force = f.force || m_pending->force;
+    }
+    m_pending = make_unique<frame>(move(f));
+  }
+  m_cond.notify_one();
+}
+
+/**
+ * Run a task on the rendering thread
+ */
+void render_thread::post(task_fn task) {
+  {
+    std::lock_guard<std::mutex> guard(m_lock);
+    m_tasks.emplace_back(move(task));
+  }
+  m_cond.notify_one();
+}
+
+render_thread::stats render_thread::get_stats() const {
+  std::lock_guard<std::mutex> guard(m_lock);
+  return m_stats;
+}
+
+void render_thread::run() {
+  trace_util::thread_name("render");
+
+  // Set while the pending frame is held back, the thread then only wakes up
+  // for tasks or to check again after RETRY_INTERVAL
+  bool holding{false};
+
+  while (true) {
+    unique_ptr<frame> next;
+    vector<task_fn> tasks;
+
+    {
+      std::unique_lock<std::mutex> guard(m_lock);
+      auto wake = [&] { return !m_active || (m_pending && !holding) || !m_tasks.empty(); };
+      if (holding) {
+        m_cond.wait_for(guard, RETRY_INTERVAL, wake);
+      } else {
+        m_cond.wait(guard, wake);
+      }
+
+      if (!m_active) {
+        break;
+      }
+
+      tasks.swap(m_tasks);
+      holding = m_pending != nullptr;
+    }
+
+    if (holding && (!m_ready || m_ready())) {
+      std::lock_guard<std::mutex> guard(m_lock);
+      next = move(m_pending);
+      holding = false;
+    } else if (holding) {
+      std::lock_guard<std::mutex> guard(m_lock);
+      m_stats.held++;
+    }
+
+    if (next) {
+      try {
+        m_render(*next);
+      } catch (const exception& err) {
+        POLYBAR_LOG_ERR(m_log, "Failed to render frame (reason: %s)", err.what());
+      }
+
+      std::lock_guard<std::mutex> guard(m_lock);
+      m_stats.rendered++;
+    }
+
+    for (auto&& task : tasks) {
+      try {
+        task();
+      } catch (const exception& err) {
+        POLYBAR_LOG_ERR(m_log, "Failed to run render task (reason: %s)", err.what());
+      }
+    }
+  }
+
+  POLYBAR_LOG_TRACE(m_log, "render_thread: Stopped");
+}
+
+POLYBAR_NS_END
@@ -1,127 +1,84 @@
 #include "components/renderer.hpp"
 
+#include <algorithm>
 #include <cassert>
+#include <cmath>
 
 #include "cairo/context.hpp"
 #include "components/config.hpp"
-#include "events/signal.hpp"
-#include "events/signal_emitter.hpp"
-#include "events/signal_receiver.hpp"
-#include "utils/factory.hpp"
 #include "utils/math.hpp"
-#include "x11/atoms.hpp"
-#include "x11/background_manager.hpp"
-#include "x11/connection.hpp"
-#include "x11/winspec.hpp"
+#include "utils/trace.hpp"
 
 POLYBAR_NS
 
 static constexpr double BLOCK_GAP{20.0};
 
 /**
- * Create instance
+ * Number of subpixel positions a cached module output can be drawn at
  */
-renderer::make_type renderer::make(const bar_settings& bar, tags::action_context& action_ctxt) {
-  // clang-format off
-  return factory_util::unique<renderer>(
-      connection::make(),
-      signal_emitter::make(),
-      config::make(),
-      logger::make(),
-      forward<decltype(bar)>(bar),
-      background_manager::make(),
-      action_ctxt);
-  // clang-format on
-}
+static constexpr int SLICE_PHASES{4};
+
+namespace {
+  /**
+   * Append the raw bytes of the given value to a block signature
+   */
+  template <typename T>
+  void sign(string& signature, const T& value) {
+    signature.append(reinterpret_cast<const char*>(&value), sizeof(value));
+  }
+}  // namespace
 
 /**
  * Construct renderer instance
+ *
+ * Nothing can be drawn until the subclass passes the surface to draw on to init()
  */
-renderer::renderer(connection& conn, signal_emitter& sig, const config& conf, const logger& logger,
-    const bar_settings& bar, background_manager& background, tags::action_context& action_ctxt)
+renderer::renderer(const config& conf, const logger& logger, const bar_settings& bar, tags::action_context& action_ctxt)
     : renderer_interface(action_ctxt)
-    , m_connection(conn)
-    , m_sig(sig)
     , m_conf(conf)
     , m_log(logger)
     , m_bar(forward<const bar_settings&>(bar))
     , m_rect(m_bar.inner_area()) {
-  m_sig.attach(this);
-  m_log.trace("renderer: Get TrueColor visual");
+  POLYBAR_LOG_TRACE(m_log, "renderer: Allocate alignment blocks");
   {
-    if ((m_visual = m_connection.visual_type(m_connection.screen(), 32)) == nullptr) {
-      m_log.err("No 32-bit TrueColor visual found...");
-
-      if ((m_visual = m_connection.visual_type(m_connection.screen(), 24)) == nullptr) {
-        m_log.err("No 24-bit TrueColor visual found...");
-      } else {
-        m_depth = 24;
-      }
-    }
-    if (m_visual == nullptr) {
-      throw application_error("No matching TrueColor");
-    }
+    m_blocks.emplace(alignment::LEFT, alignment_block{nullptr, 0.0, 0.0});
+    m_blocks.emplace(alignment::CENTER, alignment_block{nullptr, 0.0, 0.0});
+    m_blocks.emplace(alignment::RIGHT, alignment_block{nullptr, 0.0, 0.0});
   }
 
-  m_log.trace("renderer: Allocate colormap");
-  {
-    m_colormap = m_connection.generate_id();
-    m_connection.create_colormap(XCB_COLORMAP_ALLOC_NONE, m_colormap, m_connection.screen()->root, m_visual->visual_id);
-  }
+  m_pseudo_transparency = m_conf.get<bool>("settings", "pseudo-transparency", m_pseudo_transparency);
 
-  m_log.trace("renderer: Allocate output window");
-  {
-    // clang-format off
-    m_window = winspec(m_connection)
-      << cw_size(m_bar.size)
-      << cw_pos(m_bar.pos)
-      << cw_depth(m_depth)
-      << cw_visual(m_visual->visual_id)
-      << cw_class(XCB_WINDOW_CLASS_INPUT_OUTPUT)
-      << cw_params_back_pixel(0)
-      << cw_params_border_pixel(0)
-      << cw_params_backing_store(XCB_BACKING_STORE_WHEN_MAPPED)
-      << cw_params_colormap(m_colormap)
-      << cw_params_event_mask(XCB_EVENT_MASK_PROPERTY_CHANGE
-                             |XCB_EVENT_MASK_EXPOSURE
-                             |XCB_EVENT_MASK_BUTTON_PRESS)
-      << cw_params_override_redirect(m_bar.override_redirect)
-      << cw_flush(true);
-    // clang-format on
-  }
+  m_comp_bg = m_conf.get<cairo_operator_t>("settings", "compositing-background", m_comp_bg);
+  m_comp_fg = m_conf.get<cairo_operator_t>("settings", "compositing-foreground", m_comp_fg);
+  m_comp_ol = m_conf.get<cairo_operator_t>("settings", "compositing-overline", m_comp_ol);
+  m_comp_ul = m_conf.get<cairo_operator_t>("settings", "compositing-underline", m_comp_ul);
+  m_comp_border = m_conf.get<cairo_operator_t>("settings", "compositing-border", m_comp_border);
 
-  m_log.trace("renderer: Allocate window pixmaps");
-  {
-    m_pixmap = m_connection.generate_id();
-    m_connection.create_pixmap(m_depth, m_pixmap, m_window, m_bar.size.w, m_bar.size.h);
-  }
+  m_direct_transparency = (m_comp_bg == CAIRO_OPERATOR_OVER || m_comp_bg == CAIRO_OPERATOR_SOURCE) &&
+                          (m_comp_border == CAIRO_OPERATOR_OVER || m_comp_border == CAIRO_OPERATOR_SOURCE);
 
-  m_log.trace("renderer: Allocate graphic contexts");
-  {
-    unsigned int mask{0};
-    unsigned int value_list[32]{0};
-    xcb_params_gc_t params{};
-    XCB_AUX_ADD_PARAM(&mask, &params, foreground, m_bar.foreground);
-    XCB_AUX_ADD_PARAM(&mask, &params, graphics_exposures, 0);
-    connection::pack_values(mask, &params, value_list);
-    m_gcontext = m_connection.generate_id();
-    m_connection.create_gc(m_gcontext, m_pixmap, mask, value_list);
-  }
+  m_slices_enabled = m_comp_fg == CAIRO_OPERATOR_OVER && m_comp_ol == CAIRO_OPERATOR_OVER &&
+                     m_comp_ul == CAIRO_OPERATOR_OVER &&
+                     (m_comp_bg == CAIRO_OPERATOR_OVER || m_comp_bg == CAIRO_OPERATOR_SOURCE);
 
-  m_log.trace("renderer: Allocate alignment blocks");
-  {
-    m_blocks.emplace(alignment::LEFT, alignment_block{nullptr, 0.0, 0.0});
-    m_blocks.emplace(alignment::CENTER, alignment_block{nullptr, 0.0, 0.0});
-    m_blocks.emplace(alignment::RIGHT, alignment_block{nullptr, 0.0, 0.0});
-  }
+  m_fixedcenter = m_conf.get(m_conf.section(), "fixed-center", true);
+}
+
+renderer::~renderer() {}
 
-  m_log.trace("renderer: Allocate cairo components");
+/**
+ * Set up drawing onto the given surface and load the fonts
+ *
+ * The fallback dpi is used if the configured dpi is not positive.
+ */
+void renderer::init(unique_ptr<cairo::surface>&& surface, double fallback_dpi_x, double fallback_dpi_y) {
+  POLYBAR_LOG_TRACE(m_log, "renderer: Allocate cairo components");
   {
-    m_surface = make_unique<cairo::xcb_surface>(m_connection, m_pixmap, m_visual, m_bar.size.w, m_bar.size.h);
+    m_surface = move(surface);
     m_context = make_unique<cairo::context>(*m_surface, m_log);
   }
 
-  m_log.trace("renderer: Load fonts");
+  POLYBAR_LOG_TRACE(m_log, "renderer: Load fonts");
   {
     double dpi_x = 96, dpi_y = 96;
     if (m_conf.has(m_conf.section(), "dpi")) {
@@ -135,22 +92,19 @@ renderer::renderer(connection& conn, signal_emitter& sig, const config& conf, co
       }
     }
 
-    // dpi to be comptued
-    if (dpi_x <= 0 || dpi_y <= 0) {
-      auto screen = m_connection.screen();
-      if (dpi_x <= 0) {
-        dpi_x = screen->width_in_pixels * 25.4 / screen->width_in_millimeters;
-      }
-      if (dpi_y <= 0) {
-        dpi_y = screen->height_in_pixels * 25.4 / screen->height_in_millimeters;
-      }
+    // Use the dpi of the output
+    if (dpi_x <= 0) {
+      dpi_x = fallback_dpi_x;
+    }
+    if (dpi_y <= 0) {
+      dpi_y = fallback_dpi_y;
     }
 
-    m_log.info("Configured DPI = %gx%g", dpi_x, dpi_y);
+    POLYBAR_LOG_INFO(m_log, "Configured DPI = %gx%g", dpi_x, dpi_y);
 
     auto fonts = m_conf.get_list<string>(m_conf.section(), "font", {});
     if (fonts.empty()) {
-      m_log.warn("No fonts specified, using fallback font \"fixed\"");
+      POLYBAR_LOG_WARN(m_log, "No fonts specified, using fallback font \"fixed\"");
       fonts.emplace_back("fixed");
     }
 
@@ -163,60 +117,41 @@ renderer::renderer(connection& conn, signal_emitter& sig, const config& conf, co
         pattern.erase(pos);
       }
       auto font = cairo::make_font(*m_context, string{pattern}, offset, dpi_x, dpi_y);
-      m_log.notice("Loaded font \"%s\" (name=%s, offset=%i, file=%s)", pattern, font->name(), offset, font->file());
+      POLYBAR_LOG_NOTICE(m_log, "Loaded font \"%s\" (name=%s, offset=%i, file=%s)", pattern, font->name(), offset,
+          font->file());
       *m_context << move(font);
     }
   }
-
-  m_pseudo_transparency = m_conf.get<bool>("settings", "pseudo-transparency", m_pseudo_transparency);
-  if (m_pseudo_transparency) {
-    m_log.trace("Activate root background manager");
-    m_background = background.observe(m_bar.outer_area(false), m_window);
-  }
-
-  m_comp_bg = m_conf.get<cairo_operator_t>("settings", "compositing-background", m_comp_bg);
-  m_comp_fg = m_conf.get<cairo_operator_t>("settings", "compositing-foreground", m_comp_fg);
-  m_comp_ol = m_conf.get<cairo_operator_t>("settings", "compositing-overline", m_comp_ol);
-  m_comp_ul = m_conf.get<cairo_operator_t>("settings", "compositing-underline", m_comp_ul);
-  m_comp_border = m_conf.get<cairo_operator_t>("settings", "compositing-border", m_comp_border);
-
-  m_fixedcenter = m_conf.get(m_conf.section(), "fixed-center", true);
-}
-
-/**
- * Deconstruct instance
- */
-renderer::~renderer() {
-  m_sig.detach(this);
-}
-
-/**
- * Get output window
- */
-xcb_window_t renderer::window() const {
-  return m_window;
 }
 
 /**
  * Begin render routine
+ *
+ * The alignment blocks are drawn into their own groups, the canvas
+ * itself is only touched in end() once the damaged areas are known.
  */
 void renderer::begin(xcb_rectangle_t rect) {
-  m_log.trace_x("renderer: begin (geom=%ix%i+%i+%i)", rect.width, rect.height, rect.x, rect.y);
+  POLYBAR_LOG_TRACE_X(m_log, "renderer: begin (geom=%ix%i+%i+%i)", rect.width, rect.height, rect.x, rect.y);
+  trace_util::span span{"renderer::begin"};
+
+  if (rect.x != m_rect.x || rect.y != m_rect.y || rect.width != m_rect.width || rect.height != m_rect.height) {
+    m_damage_all = true;
+    m_slices.clear();
+  }
 
   // Reset state
   m_rect = rect;
   m_align = alignment::NONE;
+  m_slicing = false;
 
-  // Clear canvas
-  m_context->save();
-  m_context->clear();
-
-  // when pseudo-transparency is requested, render the bar into a new layer
-  // that will later be composited against the desktop background
-  if (m_pseudo_transparency) {
-    m_context->push();
+  for (auto&& b : m_blocks) {
+    b.second.x = 0.0;
+    b.second.y = 0.0;
+    b.second.signature.clear();
   }
 
+  m_context->save();
+
   // Create corner mask
   if (m_bar.radius && m_cornermask == nullptr) {
     m_context->save();
@@ -234,8 +169,6 @@ void renderer::begin(xcb_rectangle_t rect) {
     m_context->restore();
   }
 
-  fill_borders();
-
   // clang-format off
   m_context->clip(cairo::rect{
       static_cast<double>(m_rect.x),
@@ -247,52 +180,141 @@ void renderer::begin(xcb_rectangle_t rect) {
 
 /**
  * End render routine
+ *
+ * Only the areas covered by blocks that changed since the last frame
+ * are repainted and passed on to present().
  */
 void renderer::end() {
-  m_log.trace_x("renderer: end");
+  POLYBAR_LOG_TRACE_X(m_log, "renderer: end");
+  trace_util::span span{"renderer::end"};
+
+  auto start = histogram::clock::now();
+
+  if (m_slicing) {
+    m_slice.cacheable = false;
+    finish_slice();
+  }
 
   if (m_align != alignment::NONE) {
-    m_log.trace_x("renderer: pop(%i)", static_cast<int>(m_align));
+    POLYBAR_LOG_TRACE_X(m_log, "renderer: pop(%i)", static_cast<int>(m_align));
     m_context->pop(&m_blocks[m_align].pattern);
+  }
 
+  // Drop the clip set in begin(), the borders are outside of it
+  m_context->restore();
+
+  auto damage = damaged_areas();
+
+  if (damage.empty()) {
+    POLYBAR_LOG_TRACE_X(m_log, "renderer: Nothing to repaint");
+    for (auto&& b : m_blocks) {
+      if (b.second.pattern != nullptr) {
+        m_context->destroy(&b.second.pattern);
+      }
+    }
+    present(damage);
+    return;
+  }
+
+  auto prepare_start = histogram::clock::now();
+  prepare(!m_damage_all);
+  auto waited = histogram::clock::now() - prepare_start;
+
+  m_context->save();
+
+  if (m_damage_all) {
+    m_context->clear();
+  } else {
+    *m_context << cairo::abspos{0.0, 0.0};
+    for (auto&& area : damage) {
+      *m_context << cairo::rect{static_cast<double>(area.x), static_cast<double>(area.y),
+          static_cast<double>(area.width), static_cast<double>(area.height)};
+    }
+    m_context->clip();
+    m_context->clear();
+  }
+
+  /*
+   * The blocks are drawn straight onto the target, unless they have to be
+   * masked with the rounded corners or the bar can't be drawn onto the
+   * desktop background directly.
+   */
+  bool composite = m_cornermask != nullptr || (m_pseudo_transparency && !m_direct_transparency);
+
+  /*
+   * Drawn below the blocks instead of clearing the area they cover
+   */
+  const cairo::surface* backdrop{nullptr};
+
+  if (m_pseudo_transparency) {
+    if (composite) {
+      // Render the bar into a new layer that will later be composited
+      // against the desktop background
+      m_context->push(layer(m_bar_layer));
+    } else if ((backdrop = this->backdrop()) != nullptr) {
+      POLYBAR_LOG_TRACE_X(m_log, "renderer: root background");
+      *m_context << *backdrop;
+      m_context->paint();
+      *m_context << CAIRO_OPERATOR_OVER;
+    }
+  }
+
+  // On top of the desktop background, the bar is drawn as if it
+  // was composited onto it afterwards
+  auto comp_bg = backdrop != nullptr ? CAIRO_OPERATOR_OVER : m_comp_bg;
+  auto comp_border = backdrop != nullptr ? CAIRO_OPERATOR_OVER : m_comp_border;
+
+  if (m_damage_all) {
+    fill_borders(comp_border);
+  }
+
+  // clang-format off
+  m_context->clip(cairo::rect{
+      static_cast<double>(m_rect.x),
+      static_cast<double>(m_rect.y),
+      static_cast<double>(m_rect.width),
+      static_cast<double>(m_rect.height)});
+  // clang-format on
+
+  if (m_align != alignment::NONE && m_cornermask != nullptr) {
     // Capture the concatenated block contents
     // so that it can be masked with the corner pattern
-    m_context->push();
+    m_context->push(layer(m_blocks_layer));
 
     // Draw the background on the new layer to make up for
     // the areas not covered by the alignment blocks
-    fill_background();
+    fill_background(m_comp_bg);
 
     for (auto&& b : m_blocks) {
-      flush(b.first);
+      flush(b.first, nullptr);
     }
 
     cairo_pattern_t* blockcontents{};
     m_context->pop(&blockcontents);
 
-    if (m_cornermask != nullptr) {
-      *m_context << blockcontents;
-      m_context->mask(m_cornermask);
-    } else {
-      *m_context << blockcontents;
-      m_context->paint();
-    }
-
+    *m_context << blockcontents;
+    m_context->mask(m_cornermask);
     m_context->destroy(&blockcontents);
+  } else if (m_align != alignment::NONE) {
+    fill_background(comp_bg);
+
+    for (auto&& b : m_blocks) {
+      flush(b.first, backdrop);
+    }
   } else {
-    fill_background();
+    fill_background(comp_bg);
   }
 
   // For pseudo-transparency, capture the contents of the rendered bar and
   // composite it against the desktop wallpaper. This way transparent parts of
   // the bar will be filled by the wallpaper creating illusion of transparency.
-  if (m_pseudo_transparency) {
+  if (m_pseudo_transparency && composite) {
     cairo_pattern_t* barcontents{};
-    m_context->pop(&barcontents);  // corresponding push is in renderer::begin
+    m_context->pop(&barcontents);  // corresponding push is above
 
-    auto root_bg = m_background->get_surface();
+    auto root_bg = this->backdrop();
     if (root_bg != nullptr) {
-      m_log.trace_x("renderer: root background");
+      POLYBAR_LOG_TRACE_X(m_log, "renderer: root background");
       *m_context << *root_bg;
       m_context->paint();
       *m_context << CAIRO_OPERATOR_OVER;
@@ -305,15 +327,100 @@ void renderer::end() {
   m_context->restore();
   m_surface->flush();
 
-  flush();
+  m_damage_all = false;
 
-  m_sig.emit(signals::ui::changed{});
+  auto drawn = histogram::clock::now();
+  m_metrics.raster.record(drawn - start - waited);
+
+  present(damage);
+  m_metrics.present.record(histogram::clock::now() - drawn + waited);
+}
+
+/**
+ * Repaint the whole bar in the next frame
+ *
+ * Used if something outside of the bar contents changed, like
+ * the desktop background or the visibility of the bar
+ */
+void renderer::invalidate() {
+  m_damage_all = true;
+}
+
+/**
+ * Timings of the drawn frames
+ */
+frame_metrics& renderer::metrics() {
+  return m_metrics;
+}
+
+/**
+ * Find the areas of the bar that changed since the last frame
+ *
+ * A block is damaged if it moved, changed its width or was drawn
+ * differently, both its old and new span have to be repainted.
+ *
+ * \returns Damaged areas in pixmap coordinates, sorted and non-overlapping
+ */
+vector<xcb_rectangle_t> renderer::damaged_areas() {
+  vector<pair<int, int>> spans;
+
+  for (auto a : {alignment::LEFT, alignment::CENTER, alignment::RIGHT}) {
+    drawn_block current{};
+    if (m_blocks[a].pattern != nullptr) {
+      current.x = static_cast<int>(block_x(a) + 0.5);
+      current.w = static_cast<int>(block_w(a) + 0.5);
+      current.signature = m_blocks[a].signature;
+    }
+
+    auto& last = m_drawn[a];
+
+    if (current.x != last.x || current.w != last.w || current.signature != last.signature) {
+      for (const auto& b : {last, current}) {
+        int start = math_util::cap<int>(b.x, 0, m_rect.width);
+        int end = math_util::cap<int>(b.x + b.w, 0, m_rect.width);
+        if (end > start) {
+          spans.emplace_back(start, end);
+        }
+      }
+      last = move(current);
+    }
+  }
+
+#ifdef DEBUG_HINTS
+  m_damage_all = true;
+#endif
+
+  if (m_damage_all || m_align == alignment::NONE) {
+    m_damage_all = true;
+    return {xcb_rectangle_t{0, 0, static_cast<uint16_t>(m_bar.size.w), static_cast<uint16_t>(m_bar.size.h)}};
+  }
+
+  std::sort(spans.begin(), spans.end());
+
+  vector<xcb_rectangle_t> areas;
+  int16_t y = m_rect.y;
+  uint16_t h = m_rect.height;
+
+  for (const auto& span : spans) {
+    if (!areas.empty() && span.first <= areas.back().x + areas.back().width - m_rect.x) {
+      int end = std::max<int>(areas.back().x + areas.back().width, m_rect.x + span.second);
+      areas.back().width = end - areas.back().x;
+    } else {
+      areas.push_back(xcb_rectangle_t{static_cast<int16_t>(m_rect.x + span.first), y,
+          static_cast<uint16_t>(span.second - span.first), h});
+    }
+  }
+
+  return areas;
 }
 
 /**
  * Flush contents of given alignment block
+ *
+ * The block replaces what is below it, if a backdrop is given the
+ * block is drawn on top of it instead.
  */
-void renderer::flush(alignment a) {
+void renderer::flush(alignment a, const cairo::surface* backdrop) {
   if (m_blocks[a].pattern == nullptr) {
     return;
   }
@@ -327,7 +434,7 @@ void renderer::flush(alignment a) {
   double xw = x + w;
   bool fits{xw <= m_rect.width};
 
-  m_log.trace("renderer: flush(%i geom=%gx%g+%g+%g, falloff=%i)", static_cast<int>(a), w, h, x, y, !fits);
+  POLYBAR_LOG_TRACE(m_log, "renderer: flush(%i geom=%gx%g+%g+%g, falloff=%i)", static_cast<int>(a), w, h, x, y, !fits);
 
   // Set block shape
   *m_context << cairo::abspos{0.0, 0.0};
@@ -336,8 +443,15 @@ void renderer::flush(alignment a) {
   // Restrict drawing to the block rectangle
   m_context->clip(true);
 
-  // Clear the area covered by the block
-  m_context->clear();
+  if (backdrop != nullptr) {
+    *m_context << CAIRO_OPERATOR_SOURCE;
+    *m_context << *backdrop;
+    m_context->paint();
+    *m_context << CAIRO_OPERATOR_OVER;
+  } else {
+    // Clear the area covered by the block
+    m_context->clear();
+  }
 
   *m_context << cairo::translate{x, 0.0};
   *m_context << m_blocks[a].pattern;
@@ -361,7 +475,8 @@ void renderer::flush(alignment a) {
      * Width of the falloff gradient. Depends on how much of the block is hidden
      */
     double fsize = std::max(5.0, std::min(std::abs(overflow), 30.0));
-    m_log.trace("renderer: Drawing falloff (pos=%g, size=%g, overflow=%g)", visible_width - fsize, fsize, overflow);
+    POLYBAR_LOG_TRACE(m_log, "renderer: Drawing falloff (pos=%g, size=%g, overflow=%g)", visible_width - fsize, fsize,
+        overflow);
     m_context->save();
     *m_context << cairo::translate{(double)m_rect.x, (double)m_rect.y};
     *m_context << cairo::abspos{0.0, 0.0};
@@ -374,48 +489,6 @@ void renderer::flush(alignment a) {
   }
 }
 
-/**
- * Flush pixmap contents onto the target window
- */
-void renderer::flush() {
-  m_log.trace_x("renderer: flush");
-
-  highlight_clickable_areas();
-
-#if 0
-#ifdef DEBUG_SHADED
-  if (m_bar.shaded && m_bar.origin == edge::TOP) {
-    m_log.trace_x(
-        "renderer: copy pixmap (shaded=1, geom=%dx%d+%d+%d)", m_rect.width, m_rect.height, m_rect.x, m_rect.y);
-    auto geom = m_connection.get_geometry(m_window);
-    auto x1 = 0;
-    auto y1 = m_rect.height - m_bar.shade_size.h - m_rect.y - geom->height;
-    auto x2 = m_rect.x;
-    auto y2 = m_rect.y;
-    auto w = m_rect.width;
-    auto h = m_rect.height - m_bar.shade_size.h + geom->height;
-    m_connection.copy_area(m_pixmap, m_window, m_gcontext, x1, y1, x2, y2, w, h);
-    m_connection.flush();
-    return;
-  }
-#endif
-#endif
-
-  m_surface->flush();
-  m_connection.copy_area(m_pixmap, m_window, m_gcontext, 0, 0, 0, 0, m_bar.size.w, m_bar.size.h);
-  m_connection.flush();
-
-  if (!m_snapshot_dst.empty()) {
-    try {
-      m_surface->write_png(m_snapshot_dst);
-      m_log.info("Successfully wrote %s", m_snapshot_dst);
-    } catch (const exception& err) {
-      m_log.err("Failed to write snapshot (err: %s)", err.what());
-    }
-    m_snapshot_dst.clear();
-  }
-}
-
 /**
  * Get x position of block for given alignment
  *
@@ -524,15 +597,15 @@ double renderer::block_h(alignment) const {
 /**
  * Fill background color
  */
-void renderer::fill_background() {
+void renderer::fill_background(cairo_operator_t op) {
   m_context->save();
-  *m_context << m_comp_bg;
+  *m_context << op;
 
   if (!m_bar.background_steps.empty()) {
-    m_log.trace_x("renderer: gradient background (steps=%lu)", m_bar.background_steps.size());
+    POLYBAR_LOG_TRACE_X(m_log, "renderer: gradient background (steps=%lu)", m_bar.background_steps.size());
     *m_context << cairo::linear_gradient{0.0, 0.0 + m_rect.y, 0.0, 0.0 + m_rect.height, m_bar.background_steps};
   } else {
-    m_log.trace_x("renderer: solid background #%08x", m_bar.background);
+    POLYBAR_LOG_TRACE_X(m_log, "renderer: solid background #%08x", static_cast<uint32_t>(m_bar.background));
     *m_context << m_bar.background;
   }
 
@@ -545,7 +618,7 @@ void renderer::fill_background() {
  */
 void renderer::fill_overline(rgba color, double x, double w) {
   if (m_bar.overline.size) {
-    m_log.trace_x("renderer: overline(x=%f, w=%f)", x, w);
+    POLYBAR_LOG_TRACE_X(m_log, "renderer: overline(x=%f, w=%f)", x, w);
     m_context->save();
     *m_context << m_comp_ol;
     *m_context << color;
@@ -560,7 +633,7 @@ void renderer::fill_overline(rgba color, double x, double w) {
  */
 void renderer::fill_underline(rgba color, double x, double w) {
   if (m_bar.underline.size) {
-    m_log.trace_x("renderer: underline(x=%f, w=%f)", x, w);
+    POLYBAR_LOG_TRACE_X(m_log, "renderer: underline(x=%f, w=%f)", x, w);
     m_context->save();
     *m_context << m_comp_ul;
     *m_context << color;
@@ -574,9 +647,9 @@ void renderer::fill_underline(rgba color, double x, double w) {
 /**
  * Fill border colors
  */
-void renderer::fill_borders() {
+void renderer::fill_borders(cairo_operator_t op) {
   m_context->save();
-  *m_context << m_comp_border;
+  *m_context << op;
 
   // Draw round border corners
 
@@ -641,7 +714,8 @@ void renderer::fill_borders() {
       top.w -= m_bar.radius.top_right;
     }
 
-    m_log.trace_x("renderer: border T(%.0f, #%08x)", top.h, m_bar.borders.at(edge::TOP).color);
+    POLYBAR_LOG_TRACE_X(m_log, "renderer: border T(%.0f, #%08x)", top.h,
+        static_cast<uint32_t>(m_bar.borders.at(edge::TOP).color));
     (*m_context << top << m_bar.borders.at(edge::TOP).color).fill();
   }
 
@@ -661,7 +735,8 @@ void renderer::fill_borders() {
       bottom.w -= m_bar.radius.bottom_right;
     }
 
-    m_log.trace_x("renderer: border B(%.0f, #%08x)", bottom.h, m_bar.borders.at(edge::BOTTOM).color);
+    POLYBAR_LOG_TRACE_X(m_log, "renderer: border B(%.0f, #%08x)", bottom.h,
+        static_cast<uint32_t>(m_bar.borders.at(edge::BOTTOM).color));
     (*m_context << bottom << m_bar.borders.at(edge::BOTTOM).color).fill();
   }
 
@@ -679,7 +754,8 @@ void renderer::fill_borders() {
       left.h -= m_bar.radius.bottom_left + m_bar.borders.at(edge::BOTTOM).size;
     }
 
-    m_log.trace_x("renderer: border L(%.0f, #%08x)", left.w, m_bar.borders.at(edge::LEFT).color);
+    POLYBAR_LOG_TRACE_X(m_log, "renderer: border L(%.0f, #%08x)", left.w,
+        static_cast<uint32_t>(m_bar.borders.at(edge::LEFT).color));
     (*m_context << left << m_bar.borders.at(edge::LEFT).color).fill();
   }
 
@@ -698,7 +774,8 @@ void renderer::fill_borders() {
       right.h -= m_bar.radius.bottom_right + m_bar.borders.at(edge::BOTTOM).size;
     }
 
-    m_log.trace_x("renderer: border R(%.0f, #%08x)", right.w, m_bar.borders.at(edge::RIGHT).color);
+    POLYBAR_LOG_TRACE_X(m_log, "renderer: border R(%.0f, #%08x)", right.w,
+        static_cast<uint32_t>(m_bar.borders.at(edge::RIGHT).color));
     (*m_context << right << m_bar.borders.at(edge::RIGHT).color).fill();
   }
 
@@ -708,8 +785,25 @@ void renderer::fill_borders() {
 /**
  * Draw text contents
  */
-void renderer::render_text(const tags::context& ctxt, const string&& contents) {
-  m_log.trace_x("renderer: text(%s)", contents.c_str());
+void renderer::render_text(const tags::context& ctxt, const string& contents) {
+  POLYBAR_LOG_TRACE_X(m_log, "renderer: text(%s)", contents.c_str());
+
+  auto& signature = m_blocks[m_align].signature;
+  sign(signature, 'T');
+  sign(signature, ctxt.get_font());
+  sign(signature, static_cast<uint32_t>(ctxt.get_fg()));
+  sign(signature, static_cast<uint32_t>(ctxt.get_bg()));
+  sign(signature, ctxt.has_underline());
+  sign(signature, static_cast<uint32_t>(ctxt.get_ul()));
+  sign(signature, ctxt.has_overline());
+  sign(signature, static_cast<uint32_t>(ctxt.get_ol()));
+  sign(signature, contents.size());
+  signature += contents;
+
+  if (replaying()) {
+    advance(m_slice.cached->advances[m_slice.replayed++]);
+    return;
+  }
 
   cairo::abspos origin{};
   origin.x = m_rect.x + m_blocks[m_align].x;
@@ -737,6 +831,10 @@ void renderer::render_text(const tags::context& ctxt, const string&& contents) {
     block.bg_rect.h = m_rect.height;
   }
 
+  // Text backgrounds drawn with the source operator replace the bar background,
+  // which is not part of the slice
+  bool cutout = m_slicing && bg != m_bar.background && m_comp_bg != CAIRO_OPERATOR_OVER;
+
   m_context->save();
   *m_context << origin;
   *m_context << m_comp_fg;
@@ -754,33 +852,222 @@ void renderer::render_text(const tags::context& ctxt, const string&& contents) {
       fill_overline(ctxt.get_ol(), origin.x, dx);
     }
   }
+
+  if (m_slicing) {
+    if (cutout) {
+      m_slice.cutouts.emplace_back(origin.x - m_rect.x - m_slice.x, dx);
+    }
+    m_slice.advances.emplace_back(dx);
+  }
 }
 
 void renderer::render_offset(const tags::context&, int pixels) {
-  m_log.trace_x("renderer: offset_pixel(%f)", pixels);
-  m_blocks[m_align].x += pixels;
+  POLYBAR_LOG_TRACE_X(m_log, "renderer: offset_pixel(%i)", pixels);
+  sign(m_blocks[m_align].signature, 'O');
+  sign(m_blocks[m_align].signature, pixels);
+
+  if (replaying()) {
+    advance(m_slice.cached->advances[m_slice.replayed++]);
+  } else {
+    advance(pixels);
+  }
 }
 
 void renderer::change_alignment(const tags::context& ctxt) {
   auto align = ctxt.get_alignment();
   if (align != m_align) {
-    m_log.trace_x("renderer: change_alignment(%i)", static_cast<int>(align));
+    POLYBAR_LOG_TRACE_X(m_log, "renderer: change_alignment(%i)", static_cast<int>(align));
+
+    if (m_slicing) {
+      // The slice is spread over multiple blocks
+      m_slice.cacheable = false;
+      finish_slice();
+    }
 
     if (m_align != alignment::NONE) {
-      m_log.trace_x("renderer: pop(%i)", static_cast<int>(m_align));
+      POLYBAR_LOG_TRACE_X(m_log, "renderer: pop(%i)", static_cast<int>(m_align));
       m_context->pop(&m_blocks[m_align].pattern);
     }
 
     m_align = align;
     m_blocks[m_align].x = 0.0;
     m_blocks[m_align].y = 0.0;
+    m_blocks[m_align].signature.clear();
+    m_context->push(layer(m_block_layers[m_align]));
+    POLYBAR_LOG_TRACE_X(m_log, "renderer: push(%i)", static_cast<int>(m_align));
+
+    fill_background(m_comp_bg);
+  }
+}
+
+/**
+ * Start drawing the output of a single module
+ *
+ * If the same output was drawn before with the same state, the drawing
+ * operations are skipped and the pre-rendered output is composited
+ * in end_slice(). Otherwise the output is drawn into its own group,
+ * so that it can be kept around.
+ */
+void renderer::begin_slice(const tags::context& ctxt, const string& key) {
+  if (m_slicing) {
+    finish_slice();
+  }
+
+  if (!m_slices_enabled || m_align == alignment::NONE) {
+    return;
+  }
+
+  m_slicing = true;
+  m_slice = active_slice{};
+  m_slice.x = m_blocks[m_align].x;
+  m_slice.state = current_slice_state(ctxt);
+
+  size_t hash = std::hash<string>{}(key);
+  for (auto&& value : m_slice.state) {
+    hash ^= value + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+  }
+  m_slice.key = hash;
+
+  // Different outputs can end up with the same hash
+  auto cached = m_slices.get(m_slice.key);
+  if (cached != nullptr && cached->state == m_slice.state && cached->contents == key) {
+    m_slice.cached = cached;
+  }
+
+  if (m_slice.cached == nullptr) {
+    POLYBAR_LOG_TRACE_X(m_log, "renderer: record slice");
+    m_slice.contents = key;
     m_context->push();
-    m_log.trace_x("renderer: push(%i)", static_cast<int>(m_align));
+  }
+}
 
-    fill_background();
+void renderer::end_slice(const tags::context&) {
+  if (m_slicing) {
+    finish_slice();
   }
 }
 
+/**
+ * All drawing state that can be in effect when a slice begins, together
+ * with the subpixel position it starts at
+ */
+slice_state renderer::current_slice_state(const tags::context& ctxt) const {
+  double x = m_rect.x + m_blocks.at(m_align).x;
+  int phase = static_cast<int>((x - std::floor(x)) * SLICE_PHASES);
+
+  return slice_state{{
+      static_cast<uint32_t>(phase),
+      static_cast<uint32_t>(ctxt.get_font()),
+      static_cast<uint32_t>(ctxt.get_fg()),
+      static_cast<uint32_t>(ctxt.get_bg()),
+      static_cast<uint32_t>(ctxt.has_underline()),
+      static_cast<uint32_t>(ctxt.get_ul()),
+      static_cast<uint32_t>(ctxt.has_overline()),
+      static_cast<uint32_t>(ctxt.get_ol()),
+  }};
+}
+
+/**
+ * Composite the current slice into its alignment block
+ *
+ * A freshly drawn slice is copied to its own surface and cached, unless it
+ * was cut off at the edge of the bar or could not be drawn separately.
+ */
+void renderer::finish_slice() {
+  m_slicing = false;
+
+  double x = m_rect.x + m_slice.x;
+  double y = m_rect.y;
+  double h = m_rect.height;
+  const auto cutout = [&](const vector<pair<double, double>>& cutouts) {
+    if (cutouts.empty()) {
+      return;
+    }
+    m_context->save();
+    *m_context << cairo::abspos{0.0, 0.0};
+    for (auto&& span : cutouts) {
+      *m_context << cairo::rect{x + span.first, y, span.second, h};
+    }
+    m_context->clip();
+    m_context->clear();
+    m_context->restore();
+  };
+
+  if (m_slice.cached != nullptr) {
+    if (m_slice.replayed != m_slice.cached->advances.size()) {
+      POLYBAR_LOG_WARN(m_log, "renderer: Cached slice was replayed with different contents");
+    }
+
+    cutout(m_slice.cached->cutouts);
+
+    m_context->save();
+    *m_context << cairo::translate{std::round(x + m_slice.cached->x), y};
+    *m_context << *m_slice.cached->surface;
+    m_context->paint();
+    m_context->restore();
+    m_slice = active_slice{};
+    return;
+  }
+
+  cairo_pattern_t* contents{};
+  m_context->pop(&contents);
+
+  cutout(m_slice.cutouts);
+  *m_context << contents;
+  m_context->paint();
+
+  /*
+   * Glyphs can extend past the advance of the text,
+   * keep some space around the slice to catch them.
+   */
+  double w = m_blocks[m_align].x - m_slice.x;
+  double left = std::floor(x) - h;
+  double right = std::ceil(x + w) + h;
+
+  if (m_slice.cacheable && w > 0.0 && left >= m_rect.x && right <= m_rect.x + m_rect.width) {
+    auto surface = make_shared<cairo::image_surface>(static_cast<int>(right - left), m_rect.height);
+    cairo::context slice_ctx(*surface, m_log);
+    slice_ctx << cairo::translate{-left, -y};
+    slice_ctx << contents;
+    slice_ctx.paint();
+    surface->flush();
+
+    cached_slice slice{};
+    slice.state = m_slice.state;
+    slice.contents = move(m_slice.contents);
+    slice.surface = move(surface);
+    slice.x = left - x;
+    slice.advances = move(m_slice.advances);
+    slice.cutouts = move(m_slice.cutouts);
+    m_slices.put(m_slice.key, move(slice));
+  }
+
+  m_context->destroy(&contents);
+  m_slice = active_slice{};
+}
+
+/**
+ * Whether the current slice is drawn from the cache
+ */
+bool renderer::replaying() const {
+  return m_slicing && m_slice.cached != nullptr && m_slice.replayed < m_slice.cached->advances.size();
+}
+
+void renderer::advance(double dx) {
+  m_blocks[m_align].x += dx;
+}
+
+/**
+ * Get the offscreen surface in the given slot, allocating it on first use
+ */
+cairo::surface& renderer::layer(unique_ptr<cairo::surface>& slot) {
+  if (slot == nullptr) {
+    POLYBAR_LOG_TRACE(m_log, "renderer: Allocate layer");
+    slot = make_unique<cairo::similar_surface>(*m_surface, m_bar.size.w, m_bar.size.h);
+  }
+  return *slot;
+}
+
 double renderer::get_x(const tags::context& ctxt) const {
   return m_blocks.at(ctxt.get_alignment()).x;
 }
@@ -812,9 +1099,4 @@ void renderer::highlight_clickable_areas() {
 #endif
 }
 
-bool renderer::on(const signals::ui::request_snapshot& evt) {
-  m_snapshot_dst = evt.cast();
-  return true;
-}
-
 POLYBAR_NS_END
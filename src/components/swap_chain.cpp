@@ -0,0 +1,89 @@
+#include "components/swap_chain.hpp"
+
+POLYBAR_NS
+
+swap_chain::swap_chain(size_t count, xcb_rectangle_t full) : m_full(full), m_stale(count) {}
+
+size_t swap_chain::size() const {
+  return m_stale.size();
+}
+
+/**
+ * Buffer holding the newest complete frame
+ */
+size_t swap_chain::front() const {
+  return m_front;
+}
+
+/**
+ * Buffer the current frame is drawn into
+ */
+size_t swap_chain::back() const {
+  return m_back;
+}
+
+/**
+ * Check if there is a buffer the next frame can be drawn into
+ *
+ * \param idle Whether the display server is done reading from a buffer, all
+ *             buffers are idle if not given
+ */
+bool swap_chain::available(const idle_fn& idle) const {
+  return find_idle(idle) != m_front;
+}
+
+/**
+ * Pick the buffer the next frame is drawn into
+ *
+ * \returns false if all buffers are still in use, the back buffer is left
+ *          unchanged then
+ */
+bool swap_chain::acquire(const idle_fn& idle) {
+  auto next = find_idle(idle);
+  if (next == m_front) {
+    return false;
+  }
+  m_back = next;
+  return true;
+}
+
+/**
+ * Take the areas in which the back buffer differs from the front buffer
+ */
+vector<xcb_rectangle_t> swap_chain::take_stale() {
+  vector<xcb_rectangle_t> stale;
+  stale.swap(m_stale[m_back]);
+  return stale;
+}
+
+/**
+ * Make the back buffer the front buffer after the given areas were drawn
+ */
+void swap_chain::present(const vector<xcb_rectangle_t>& areas) {
+  m_front = m_back;
+
+  for (size_t i = 0; i < size(); i++) {
+    if (i == m_front) {
+      continue;
+    }
+    auto& stale = m_stale[i];
+    if (stale.size() + areas.size() > MAX_STALE_AREAS) {
+      stale.assign({m_full});
+    } else {
+      stale.insert(stale.end(), areas.begin(), areas.end());
+    }
+  }
+}
+
+/**
+ * First idle buffer after the front buffer, the front buffer if there is none
+ */
+size_t swap_chain::find_idle(const idle_fn& idle) const {
+  size_t next = (m_front + 1) % size();
+  while (next != m_front && idle && !idle(next)) {
+    next = (next + 1) % size();
+  }
+  return next;
+}
+
+POLYBAR_NS_END
@@ -2,6 +2,7 @@
 
 #include "components/taskqueue.hpp"
 #include "utils/factory.hpp"
+#include "utils/trace.hpp"
 
 POLYBAR_NS
 
@@ -11,6 +12,7 @@ taskqueue::make_type taskqueue::make() {
 
 taskqueue::taskqueue() {
   m_thread = std::thread([&] {
+    trace_util::thread_name("taskqueue");
     while (m_active) {
       std::unique_lock<std::mutex> guard(m_lock);
 
@@ -86,6 +88,7 @@ void taskqueue::tick() {
   }
   guard.unlock();
   for (auto&& p : cbs) {
+    trace_util::span span{"taskqueue"};
     p.first(p.second);
   }
 }
@@ -0,0 +1,300 @@
+#include "components/window_renderer.hpp"
+
+#include "cairo/context.hpp"
+#include "components/config.hpp"
+#include "events/signal.hpp"
+#include "events/signal_emitter.hpp"
+#include "events/signal_receiver.hpp"
+#include "utils/factory.hpp"
+#include "utils/trace.hpp"
+#include "x11/atoms.hpp"
+#include "x11/background_manager.hpp"
+#include "x11/connection.hpp"
+#include "x11/winspec.hpp"
+
+#if WITH_XPRESENT
+#include "x11/extensions/present.hpp"
+#endif
+
+POLYBAR_NS
+
+/**
+ * Create instance
+ */
+window_renderer::make_type window_renderer::make(const bar_settings& bar, tags::action_context& action_ctxt) {
+  // clang-format off
+  return factory_util::unique<window_renderer>(
+      connection::make(),
+      signal_emitter::make(),
+      config::make(),
+      logger::make(),
+      forward<decltype(bar)>(bar),
+      background_manager::make(),
+      action_ctxt);
+  // clang-format on
+}
+
+/**
+ * Construct renderer instance
+ */
+window_renderer::window_renderer(connection& conn, signal_emitter& sig, const config& conf, const logger& logger,
+    const bar_settings& bar, background_manager& background, tags::action_context& action_ctxt)
+    : renderer(conf, logger, bar, action_ctxt)
+    , m_connection(conn)
+    , m_sig(sig)
+    , m_chain(PIXMAP_COUNT, xcb_rectangle_t{0, 0, static_cast<uint16_t>(bar.size.w), static_cast<uint16_t>(bar.size.h)}) {
+  m_sig.attach(this);
+  POLYBAR_LOG_TRACE(m_log, "renderer: Get TrueColor visual");
+  {
+    if ((m_visual = m_connection.visual_type(m_connection.screen(), 32)) == nullptr) {
+      POLYBAR_LOG_ERR(m_log, "No 32-bit TrueColor visual found...");
+
+      if ((m_visual = m_connection.visual_type(m_connection.screen(), 24)) == nullptr) {
+        POLYBAR_LOG_ERR(m_log, "No 24-bit TrueColor visual found...");
+      } else {
+        m_depth = 24;
+      }
+    }
+    if (m_visual == nullptr) {
+      throw application_error("No matching TrueColor");
+    }
+  }
+
+  POLYBAR_LOG_TRACE(m_log, "renderer: Allocate colormap");
+  {
+    m_colormap = m_connection.generate_id();
+    m_connection.create_colormap(XCB_COLORMAP_ALLOC_NONE, m_colormap, m_connection.screen()->root, m_visual->visual_id);
+  }
+
+  POLYBAR_LOG_TRACE(m_log, "renderer: Allocate output window");
+  {
+    // clang-format off
+    m_window = winspec(m_connection)
+      << cw_size(m_bar.size)
+      << cw_pos(m_bar.pos)
+      << cw_depth(m_depth)
+      << cw_visual(m_visual->visual_id)
+      << cw_class(XCB_WINDOW_CLASS_INPUT_OUTPUT)
+      << cw_params_back_pixel(0)
+      << cw_params_border_pixel(0)
+      << cw_params_backing_store(XCB_BACKING_STORE_WHEN_MAPPED)
+      << cw_params_colormap(m_colormap)
+      << cw_params_event_mask(XCB_EVENT_MASK_PROPERTY_CHANGE
+                             |XCB_EVENT_MASK_EXPOSURE
+                             |XCB_EVENT_MASK_BUTTON_PRESS)
+      << cw_params_override_redirect(m_bar.override_redirect)
+      << cw_flush(true);
+    // clang-format on
+  }
+
+  POLYBAR_LOG_TRACE(m_log, "renderer: Allocate window pixmaps");
+  {
+    for (auto&& pixmap : m_pixmaps) {
+      pixmap = m_connection.generate_id();
+      m_connection.create_pixmap(m_depth, pixmap, m_window, m_bar.size.w, m_bar.size.h);
+    }
+  }
+
+#if WITH_XPRESENT
+  POLYBAR_LOG_TRACE(m_log, "renderer: Query Present extension");
+  {
+    if (present_util::query_extension(m_connection)) {
+      m_present = make_unique<present_window>(m_connection, m_window);
+      POLYBAR_LOG_INFO(m_log, "Presenting frames through the X Present extension");
+    } else {
+      POLYBAR_LOG_INFO(m_log, "X Present extension not available, copying frames onto the window");
+    }
+  }
+#endif
+
+  POLYBAR_LOG_TRACE(m_log, "renderer: Allocate graphic contexts");
+  {
+    unsigned int mask{0};
+    unsigned int value_list[32]{0};
+    xcb_params_gc_t params{};
+    XCB_AUX_ADD_PARAM(&mask, &params, foreground, m_bar.foreground);
+    XCB_AUX_ADD_PARAM(&mask, &params, graphics_exposures, 0);
+    connection::pack_values(mask, &params, value_list);
+    m_gcontext = m_connection.generate_id();
+    m_connection.create_gc(m_gcontext, m_pixmaps[m_chain.front()], mask, value_list);
+  }
+
+  {
+    auto surface =
+        make_unique<cairo::xcb_surface>(m_connection, m_pixmaps[m_chain.front()], m_visual, m_bar.size.w, m_bar.size.h);
+    m_xcb_surface = surface.get();
+
+    auto screen = m_connection.screen();
+    double dpi_x = screen->width_in_pixels * 25.4 / screen->width_in_millimeters;
+    double dpi_y = screen->height_in_pixels * 25.4 / screen->height_in_millimeters;
+
+    init(move(surface), dpi_x, dpi_y);
+  }
+
+  if (m_pseudo_transparency) {
+    POLYBAR_LOG_TRACE(m_log, "Activate root background manager");
+    m_background = background.observe(m_bar.outer_area(false), m_window);
+  }
+}
+
+/**
+ * Deconstruct instance
+ */
+window_renderer::~window_renderer() {
+  m_sig.detach(this);
+}
+
+/**
+ * Get output window
+ */
+xcb_window_t window_renderer::window() const {
+  return m_window;
+}
+
+/**
+ * Check if the next frame can be drawn without waiting for the server
+ *
+ * With the Present extension, the previous frame has to be shown and one of
+ * the pixmaps has to be idle. Otherwise a frame can always be drawn.
+ */
+bool window_renderer::ready() {
+#if WITH_XPRESENT
+  if (m_present != nullptr) {
+    return m_present->done() && m_chain.available(idle_check());
+  }
+#endif
+  return true;
+}
+
+/**
+ * Draw into the next pixmap, starting out with the contents of the current one
+ *
+ * Only called once ready() returned true.
+ */
+void window_renderer::prepare(bool keep) {
+  if (!m_chain.acquire(idle_check())) {
+    throw application_error("No idle pixmap to draw into");
+  }
+  auto back = m_chain.back();
+
+  m_xcb_surface->set_drawable(m_pixmaps[back], m_bar.size.w, m_bar.size.h);
+  auto stale = m_chain.take_stale();
+  if (keep && !stale.empty()) {
+    // Bring the pixmap up to date with the newest frame by copying only
+    // what changed since it was last drawn into
+    auto front = m_pixmaps[m_chain.front()];
+    for (auto&& area : stale) {
+      m_connection.copy_area(
+          front, m_pixmaps[back], m_gcontext, area.x, area.y, area.x, area.y, area.width, area.height);
+    }
+    m_surface->dirty();
+  }
+}
+
+/**
+ * Which pixmaps the server no longer reads from, all of them without Present
+ */
+swap_chain::idle_fn window_renderer::idle_check() {
+#if WITH_XPRESENT
+  if (m_present != nullptr) {
+    return [&](size_t i) { return m_present->idle(m_pixmaps[i]); };
+  }
+#endif
+  return nullptr;
+}
+
+/**
+ * Show the newest frame in the window
+ */
+void window_renderer::present(const vector<xcb_rectangle_t>& areas) {
+  if (areas.empty()) {
+    flush(areas);
+    return;
+  }
+
+  m_chain.present(areas);
+  flush(areas);
+
+  m_sig.emit(signals::ui::changed{});
+}
+
+const cairo::surface* window_renderer::backdrop() const {
+  return m_background != nullptr ? m_background->get_surface() : nullptr;
+}
+
+/**
+ * Flush pixmap contents onto the target window
+ */
+void window_renderer::flush() {
+  flush({xcb_rectangle_t{0, 0, static_cast<uint16_t>(m_bar.size.w), static_cast<uint16_t>(m_bar.size.h)}});
+}
+
+/**
+ * Flush the given areas of the newest frame onto the target window
+ */
+void window_renderer::flush(const vector<xcb_rectangle_t>& areas) {
+  POLYBAR_LOG_TRACE_X(m_log, "renderer: flush (areas=%lu)", areas.size());
+  trace_util::span span{"renderer::flush"};
+
+  highlight_clickable_areas();
+
+#if 0
+#ifdef DEBUG_SHADED
+  if (m_bar.shaded && m_bar.origin == edge::TOP) {
+    POLYBAR_LOG_TRACE_X(m_log,
+        "renderer: copy pixmap (shaded=1, geom=%dx%d+%d+%d)", m_rect.width, m_rect.height, m_rect.x, m_rect.y);
+    auto geom = m_connection.get_geometry(m_window);
+    auto x1 = 0;
+    auto y1 = m_rect.height - m_bar.shade_size.h - m_rect.y - geom->height;
+    auto x2 = m_rect.x;
+    auto y2 = m_rect.y;
+    auto w = m_rect.width;
+    auto h = m_rect.height - m_bar.shade_size.h + geom->height;
+    m_connection.copy_area(m_pixmaps[m_chain.front()], m_window, m_gcontext, x1, y1, x2, y2, w, h);
+    m_connection.flush();
+    return;
+  }
+#endif
+#endif
+
+  m_surface->flush();
+
+  bool presented{false};
+#if WITH_XPRESENT
+  if (m_present != nullptr) {
+    // The whole pixmap is presented, the server takes care of only
+    // updating the window at the vertical blank
+    if (!areas.empty()) {
+      m_present->present(m_pixmaps[m_chain.front()]);
+    }
+    presented = true;
+  }
+#endif
+
+  if (!presented) {
+    for (auto&& area : areas) {
+      m_connection.copy_area(
+          m_pixmaps[m_chain.front()], m_window, m_gcontext, area.x, area.y, area.x, area.y, area.width, area.height);
+    }
+  }
+  m_connection.flush();
+
+  std::lock_guard<std::mutex> guard(m_snapshot_lock);
+  if (!m_snapshot_dst.empty()) {
+    try {
+      m_surface->write_png(m_snapshot_dst);
+      POLYBAR_LOG_INFO(m_log, "Successfully wrote %s", m_snapshot_dst);
+    } catch (const exception& err) {
+      POLYBAR_LOG_ERR(m_log, "Failed to write snapshot (err: %s)", err.what());
+    }
+    m_snapshot_dst.clear();
+  }
+}
+
+bool window_renderer::on(const signals::ui::request_snapshot& evt) {
+  std::lock_guard<std::mutex> guard(m_snapshot_lock);
+  m_snapshot_dst = evt.cast();
+  return true;
+}
+
+POLYBAR_NS_END
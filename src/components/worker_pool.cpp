@@ -0,0 +1,161 @@
+#include "components/worker_pool.hpp"
+
+#include "utils/trace.hpp"
+
+POLYBAR_NS
+
+/**
+ * Construct instance and start the worker threads
+ */
+worker_pool::worker_pool(size_t workers) {
+  for (size_t i = 0; i <= workers; i++) {
+    m_queues.emplace_back(make_unique<queue>());
+  }
+  for (size_t i = 0; i < workers; i++) {
+    m_threads.emplace_back(&worker_pool::work, this, i);
+  }
+}
+
+/**
+ * Stop the worker threads
+ */
+worker_pool::~worker_pool() {
+  {
+    std::lock_guard<std::mutex> guard(m_lock);
+    m_active = false;
+  }
+  m_wakeup.notify_all();
+
+  for (auto&& t : m_threads) {
+    if (t.joinable()) {
+      t.join();
+    }
+  }
+}
+
+/**
+ * Number of worker threads, not counting the submitting thread
+ */
+size_t worker_pool::size() const {
+  return m_threads.size();
+}
+
+/**
+ * Run all given tasks and wait until they are done
+ *
+ * If tasks throw, the first exception is rethrown once all tasks are done.
+ */
+void worker_pool::run(vector<task_fn>& tasks) {
+  if (tasks.empty()) {
+    return;
+  }
+
+  if (m_threads.empty() || tasks.size() == 1) {
+    std::exception_ptr error;
+    for (auto&& task : tasks) {
+      try {
+        task();
+      } catch (...) {
+        error = error ? error : std::current_exception();
+      }
+    }
+    if (error) {
+      std::rethrow_exception(error);
+    }
+    return;
+  }
+
+  std::lock_guard<std::mutex> run_guard(m_run_lock);
+
+  for (size_t i = 0; i < tasks.size(); i++) {
+    auto& q = *m_queues[i % m_queues.size()];
+    std::lock_guard<std::mutex> guard(q.lock);
+    q.tasks.push_back(&tasks[i]);
+  }
+
+  {
+    std::lock_guard<std::mutex> guard(m_lock);
+    m_error = nullptr;
+    m_remaining = tasks.size();
+    m_queued = tasks.size();
+  }
+  m_wakeup.notify_all();
+
+  while (run_next(m_queues.size() - 1)) {
+  }
+
+  std::unique_lock<std::mutex> guard(m_lock);
+  m_done.wait(guard, [&] { return m_remaining == 0; });
+
+  if (m_error) {
+    std::rethrow_exception(m_error);
+  }
+}
+
+void worker_pool::work(size_t index) {
+  trace_util::thread_name("worker-" + to_string(index));
+
+  while (true) {
+    {
+      std::unique_lock<std::mutex> guard(m_lock);
+      m_wakeup.wait(guard, [&] { return !m_active || m_queued > 0; });
+      if (!m_active) {
+        break;
+      }
+    }
+
+    while (run_next(index)) {
+    }
+  }
+}
+
+/**
+ * Run a single queued task
+ *
+ * Takes the oldest task of the own queue, or else steals the newest task
+ * of another queue.
+ *
+ * \returns false if all queues are empty
+ */
+bool worker_pool::run_next(size_t index) {
+  task_fn* task{nullptr};
+
+  for (size_t i = 0; i < m_queues.size() && task == nullptr; i++) {
+    auto& q = *m_queues[(index + i) % m_queues.size()];
+    std::lock_guard<std::mutex> guard(q.lock);
+    if (q.tasks.empty()) {
+      continue;
+    }
+    if (i == 0) {
+      task = q.tasks.front();
+      q.tasks.pop_front();
+    } else {
+      task = q.tasks.back();
+      q.tasks.pop_back();
+    }
+  }
+
+  if (task == nullptr) {
+    return false;
+  }
+
+  m_queued--;
+
+  try {
+    (*task)();
+  } catch (...) {
+    std::lock_guard<std::mutex> guard(m_lock);
+    if (!m_error) {
+      m_error = std::current_exception();
+    }
+  }
+
+  if (--m_remaining == 0) {
+    std::lock_guard<std::mutex> guard(m_lock);
+    m_done.notify_all();
+  }
+
+  return true;
+}
+
+POLYBAR_NS_END
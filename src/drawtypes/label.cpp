@@ -9,15 +9,36 @@
 POLYBAR_NS
 
 namespace drawtypes {
+  /**
+   * Split the text up at the given tokens
+   *
+   * The tokens are expected in the order they appear in the text, a token
+   * that is listed more than once fills as many occurrences.
+   */
+  label_template::label_template(const string& text, vector<token>&& tokens) : tokens(move(tokens)) {
+    size_t pos{0};
+    for (size_t i = 0; i < this->tokens.size(); i++) {
+      auto start = text.find(this->tokens[i].token, pos);
+      if (start == string::npos) {
+        continue;
+      }
+      literals.emplace_back(text.substr(pos, start - pos));
+      slots.emplace_back(i);
+      pos = start + this->tokens[i].token.size();
+    }
+    literals.emplace_back(text.substr(pos));
+  }
+
   /**
    * Gets the text from the label as it should be rendered
    *
    * Here tokens are replaced with values and minlen and maxlen properties are applied
    */
   string label::get() const {
-    const size_t len = string_util::char_len(m_tokenized);
+    const auto& tokenized = this->tokenized();
+    const size_t len = string_util::char_len(tokenized);
     if (len >= m_minlen) {
-      string text = m_tokenized;
+      string text = tokenized;
       if (m_maxlen > 0 && len > m_maxlen) {
         if (m_ellipsis) {
           text = string_util::utf8_truncate(std::move(text), m_maxlen - 3) + "...";
@@ -43,59 +64,102 @@ namespace drawtypes {
         --left_fill_len;
       }
     }
-    return string(left_fill_len, ' ') + m_tokenized + string(right_fill_len, ' ');
+    return string(left_fill_len, ' ') + tokenized + string(right_fill_len, ' ');
   }
 
   label::operator bool() {
-    return !m_tokenized.empty();
+    return !tokenized().empty();
   }
 
+  /**
+   * Copy of the label with all tokens reset, sharing the template
+   */
   label_t label::clone() {
-    vector<token> tokens;
-    if (!m_tokens.empty()) {
-      std::back_insert_iterator<decltype(tokens)> back_it(tokens);
-      std::copy(m_tokens.begin(), m_tokens.end(), back_it);
-    }
-    return factory_util::shared<label>(m_text, m_foreground, m_background, m_underline, m_overline, m_font, m_padding,
-        m_margin, m_minlen, m_maxlen, m_alignment, m_ellipsis, move(tokens));
+    // The constructor is private, so make_shared can't be used
+    return label_t{new label(*this, m_template)};
   }
 
   void label::clear() {
-    m_tokenized.clear();
+    m_cleared = true;
+    m_outdated = true;
   }
 
   void label::reset_tokens() {
-    m_tokenized = m_text;
-  }
-
-  void label::reset_tokens(const string& tokenized) {
-    m_tokenized = tokenized;
+    m_filled.assign(m_template->slots.size(), false);
+    m_cleared = false;
+    m_outdated = true;
   }
 
+  /**
+   * Whether the token still has a slot that was not filled
+   */
   bool label::has_token(const string& token) const {
-    return m_tokenized.find(token) != string::npos;
+    if (m_cleared) {
+      return false;
+    }
+    for (size_t i = 0; i < m_template->slots.size(); i++) {
+      if (!m_filled[i] && m_template->tokens[m_template->slots[i]].token == token) {
+        return true;
+      }
+    }
+    return false;
   }
 
-  void label::replace_token(const string& token, string replacement) {
-    if (!has_token(token)) {
+  /**
+   * Fill all slots of the token that were not filled since the tokens were
+   * last reset
+   */
+  void label::replace_token(const string& token, const string& replacement) {
+    if (m_cleared) {
       return;
     }
 
-    for (auto&& tok : m_tokens) {
-      string repl{replacement};
-      if (token == tok.token) {
-        if (tok.max != 0_z && string_util::char_len(repl) > tok.max) {
-          repl = string_util::utf8_truncate(std::move(repl), tok.max) + tok.suffix;
-        } else if (tok.min != 0_z && repl.length() < tok.min) {
-          repl.insert(0_z, tok.min - repl.length(), tok.zpad ? '0' : ' ');
-        }
+    for (size_t i = 0; i < m_template->slots.size(); i++) {
+      const auto& tok = m_template->tokens[m_template->slots[i]];
+      if (m_filled[i] || token != tok.token) {
+        continue;
+      }
+
+      auto& repl = m_values[i];
+      repl = replacement;
+      if (tok.max != 0_z && string_util::char_len(repl) > tok.max) {
+        repl = string_util::utf8_truncate(std::move(repl), tok.max) + tok.suffix;
+      } else if (tok.min != 0_z && repl.length() < tok.min) {
+        repl.insert(0_z, tok.min - repl.length(), tok.zpad ? '0' : ' ');
+      }
 
-        /*
-         * Only replace first occurence, so that the proper token objects can be used
-         */
-        m_tokenized = string_util::replace(m_tokenized, token, move(repl));
+      m_filled[i] = true;
+      m_outdated = true;
+    }
+  }
+
+  void label::set_template(shared_ptr<const label_template> tmpl) {
+    m_template = move(tmpl);
+    m_values.resize(m_template->slots.size());
+    reset_tokens();
+  }
+
+  /**
+   * The text with all filled slots replaced
+   *
+   * Slots that were not filled still show their token.
+   */
+  const string& label::tokenized() const {
+    if (!m_outdated) {
+      return m_tokenized;
+    }
+
+    m_tokenized.clear();
+    if (!m_cleared) {
+      const auto& tmpl = *m_template;
+      for (size_t i = 0; i < tmpl.slots.size(); i++) {
+        m_tokenized += tmpl.literals[i];
+        m_tokenized += m_filled[i] ? m_values[i] : tmpl.tokens[tmpl.slots[i]].token;
       }
+      m_tokenized += tmpl.literals.back();
     }
+    m_outdated = false;
+    return m_tokenized;
   }
 
   void label::replace_defined_values(const label_t& label) {
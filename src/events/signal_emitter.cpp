@@ -1,9 +1,23 @@
 #include "events/signal_emitter.hpp"
+
+#include <algorithm>
+#include <mutex>
+#include <thread>
+
 #include "utils/factory.hpp"
 
 POLYBAR_NS
 
-signal_receivers_t g_signal_receivers;
+std::array<shared_ptr<const signal_sinks>, signals::count()> g_signal_receivers;
+std::array<std::atomic<size_t>, signals::count()> g_signal_readers{};
+thread_local std::array<size_t, signals::count()> g_signal_depth{};
+
+namespace {
+  /**
+   * Serializes the updates of the receiver lists
+   */
+  std::mutex g_signal_lock;
+}  // namespace
 
 /**
  * Create instance
@@ -12,4 +26,51 @@ signal_emitter::make_type signal_emitter::make() {
   return static_cast<signal_emitter&>(*factory_util::singleton<signal_emitter>());
 }
 
+/**
+ * Attach the receiver after all receivers with the same or a lower priority
+ */
+void signal_emitter::attach(size_t index, signal_sink sink) {
+  std::lock_guard<std::mutex> guard(g_signal_lock);
+  auto current = std::atomic_load(&g_signal_receivers[index]);
+  auto sinks = current ? make_shared<signal_sinks>(*current) : make_shared<signal_sinks>();
+
+  auto position = std::upper_bound(sinks->begin(), sinks->end(), sink.priority,
+      [](signal_receiver_interface::prio priority, const signal_sink& other) { return priority < other.priority; });
+  sinks->insert(position, sink);
+
+  std::atomic_store(&g_signal_receivers[index], shared_ptr<const signal_sinks>(move(sinks)));
+}
+
+/**
+ * Detach the receiver and wait for emits that may still deliver to it
+ *
+ * Once this returns the receiver is not called anymore and can be
+ * destroyed. Emits that started before on other threads are waited for.
+ * If this is called from a receiver of the same signal, the emits in flight
+ * on this thread may still call the receiver after it returns.
+ */
+void signal_emitter::detach(size_t index, signal_receiver_interface* s) {
+  {
+    std::lock_guard<std::mutex> guard(g_signal_lock);
+    auto current = std::atomic_load(&g_signal_receivers[index]);
+    if (!current) {
+      return;
+    }
+
+    auto sinks = make_shared<signal_sinks>(*current);
+    sinks->erase(std::remove_if(sinks->begin(), sinks->end(),
+                     [&](const signal_sink& sink) { return sink.receiver == s; }),
+        sinks->end());
+
+    std::atomic_store(
+        &g_signal_receivers[index], sinks->empty() ? nullptr : shared_ptr<const signal_sinks>(move(sinks)));
+  }
+
+  // Emits starting from now on load the new list, wait for the ones that
+  // may still hold an old one
+  while (g_signal_readers[index] > g_signal_depth[index]) {
+    std::this_thread::yield();
+  }
+}
+
 POLYBAR_NS_END
@@ -1,4 +1,8 @@
 #include <fcntl.h>
+#include <poll.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
 #include <algorithm>
 #include <cstdlib>
 #include <cstring>
@@ -14,6 +18,10 @@ using namespace std;
 #define IPC_CHANNEL_PREFIX "/tmp/polybar_mqueue."
 #endif
 
+#ifndef IPC_REPLY_PREFIX
+#define IPC_REPLY_PREFIX "/tmp/polybar_reply."
+#endif
+
 void display(const string& msg) {
   fprintf(stdout, "%s\n", msg.c_str());
 }
@@ -40,12 +48,60 @@ bool validate_type(const string& type) {
   return (type == "action" || type == "cmd" || type == "hook");
 }
 
+/**
+ * Whether polybar answers the message
+ */
+bool expects_reply(const string& type, const string& payload) {
+  return type == "cmd" && payload == "stats";
+}
+
+/**
+ * Create and open the fifo polybar writes its reply to
+ *
+ * \returns -1 on error
+ */
+int open_reply(const string& path) {
+  unlink(path.c_str());
+  if (mkfifo(path.c_str(), 0600) == -1) {
+    return -1;
+  }
+  return open(path.c_str(), O_RDONLY | O_NONBLOCK);
+}
+
+/**
+ * Read the reply until polybar closes the fifo
+ *
+ * \returns false if polybar didn't answer in time
+ */
+bool read_reply(int fd, string& reply) {
+  char buffer[BUFSIZ];
+
+  while (true) {
+    struct pollfd pfd {
+      fd, POLLIN, 0
+    };
+    if (poll(&pfd, 1, 2000) != 1) {
+      return false;
+    }
+
+    ssize_t bytes = read(fd, buffer, sizeof(buffer));
+    if (bytes > 0) {
+      reply.append(buffer, bytes);
+    } else if (bytes == 0) {
+      return true;
+    } else if (errno != EAGAIN && errno != EINTR) {
+      return false;
+    }
+  }
+}
+
 int main(int argc, char** argv) {
   const int E_NO_CHANNELS{2};
   const int E_MESSAGE_TYPE{3};
   const int E_INVALID_PID{4};
   const int E_INVALID_CHANNEL{5};
   const int E_WRITE{6};
+  const int E_REPLY{7};
 
   vector<string> args{argv + 1, argv + argc};
   string::size_type p;
@@ -118,10 +174,36 @@ int main(int argc, char** argv) {
     try {
       file_descriptor fd(channel, O_WRONLY | O_NONBLOCK);
       string payload{ipc_type + ':' + ipc_payload};
+
+      // The reply channel is passed along with the message
+      string reply_path;
+      int reply_fd{-1};
+      if (expects_reply(ipc_type, ipc_payload)) {
+        reply_path = IPC_REPLY_PREFIX + to_string(getpid());
+        if ((reply_fd = open_reply(reply_path)) == -1) {
+          log(E_REPLY, "Failed to create reply channel \"" + reply_path + "\" (err: " + strerror(errno) + ")");
+        }
+        payload += ' ' + reply_path;
+      }
+
       if (write(fd, payload.c_str(), payload.size()) != -1) {
-        display("Successfully wrote \"" + payload + "\" to \"" + channel + "\"");
+        if (reply_fd != -1) {
+          string reply;
+          bool received = read_reply(reply_fd, reply);
+          close(reply_fd);
+          unlink(reply_path.c_str());
+          if (!received) {
+            log(E_REPLY, "No reply from \"" + channel + "\"");
+          }
+          display(reply);
+        } else {
+          display("Successfully wrote \"" + payload + "\" to \"" + channel + "\"");
+        }
         exit_status = 0;
       } else {
+        if (reply_fd != -1) {
+          unlink(reply_path.c_str());
+        }
         log(E_WRITE, "Failed to write \"" + payload + "\" to \"" + channel + "\" (err: " + strerror(errno) + ")");
       }
     } catch (const exception& err) {
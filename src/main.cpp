@@ -1,12 +1,16 @@
+#include <cstdlib>
+
 #include "components/bar.hpp"
 #include "components/command_line.hpp"
 #include "components/config.hpp"
 #include "components/config_parser.hpp"
 #include "components/controller.hpp"
+#include "components/eventloop.hpp"
 #include "components/ipc.hpp"
 #include "utils/env.hpp"
 #include "utils/inotify.hpp"
 #include "utils/process.hpp"
+#include "utils/trace.hpp"
 #include "x11/connection.hpp"
 
 using namespace polybar;
@@ -26,12 +30,18 @@ int main(int argc, char** argv) {
       command_line::option{"-w", "--print-wmname", "Print the generated WM_NAME and exit"},
       command_line::option{"-s", "--stdout", "Output data to stdout instead of drawing it to the X window"},
       command_line::option{"-p", "--png", "Save png snapshot to FILE after running for 3 seconds", "FILE"},
+      command_line::option{"-t", "--trace", "Record a trace of the event and render pipeline to FILE (FILE.1, FILE.2, ... after reloads)", "FILE"},
   };
   // clang-format on
 
   unsigned char exit_code{EXIT_SUCCESS};
   bool reload{false};
 
+  // Number of the trace recorded by this process, passed on when reloading
+  const string trace_run_var{"POLYBAR_TRACE_RUN"};
+  unsigned long trace_run{0};
+  bool traced{false};
+
   logger& logger{const_cast<decltype(logger)>(logger::make(loglevel::NOTICE))};
 
   try {
@@ -126,8 +136,13 @@ int main(int argc, char** argv) {
       printf("%s\n", conf.get(conf.section(), cli->get("dump")).c_str());
       return EXIT_SUCCESS;
     }
+
+    // Run on the main thread by the controller, shared by the components
+    // that wait for file descriptors
+    eventloop loop;
+
     if (cli->has("print-wmname")) {
-      printf("%s\n", bar::make(true)->settings().wmname.c_str());
+      printf("%s\n", bar::make(loop, true)->settings().wmname.c_str());
       return EXIT_SUCCESS;
     }
 
@@ -138,32 +153,51 @@ int main(int argc, char** argv) {
     unique_ptr<inotify_watch> config_watch{};
 
     if (conf.get(conf.section(), "enable-ipc", false)) {
-      ipc = ipc::make();
+      ipc = ipc::make(loop);
+    }
+    if (cli->has("trace")) {
+      // A reloaded process records into a new file instead of overwriting
+      // the trace of the previous one
+      auto path = cli->get("trace");
+      trace_run = std::strtoul(env_util::get(trace_run_var, "0").c_str(), nullptr, 10);
+      unsetenv(trace_run_var.c_str());
+      if (trace_run > 0) {
+        path += "." + to_string(trace_run);
+      }
+      trace_util::start(path);
+      trace_util::thread_name("main");
+      traced = true;
     }
     if (cli->has("reload")) {
       config_watch = inotify_util::make_watch(conf.filepath());
     }
 
-    auto ctrl = controller::make(move(ipc), move(config_watch));
+    auto ctrl = controller::make(loop, move(ipc), move(config_watch));
 
     if (!ctrl->run(cli->has("stdout"), cli->get("png"))) {
       reload = true;
     }
   } catch (const exception& err) {
-    logger.err(err.what());
+    POLYBAR_LOG_ERR(logger, "%s", err.what());
     exit_code = EXIT_FAILURE;
   }
 
-  logger.info("Waiting for spawned processes to end");
+  trace_util::stop();
+
+  POLYBAR_LOG_INFO(logger, "Waiting for spawned processes to end");
   while (process_util::notify_childprocess()) {
     ;
   }
 
   if (reload) {
-    logger.info("Re-launching application...");
+    POLYBAR_LOG_INFO(logger, "Re-launching application...");
+    logger::flush();
+    if (traced) {
+      setenv(trace_run_var.c_str(), to_string(trace_run + 1).c_str(), 1);
+    }
     process_util::exec(move(argv[0]), move(argv));
   }
 
-  logger.info("Reached end of application...");
+  POLYBAR_LOG_INFO(logger, "Reached end of application...");
   return exit_code;
 }
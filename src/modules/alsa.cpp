@@ -114,7 +114,7 @@ namespace modules {
         return true;
       }
     } catch (const alsa_exception& e) {
-      m_log.err("%s: %s", name(), e.what());
+      POLYBAR_LOG_ERR(m_log, "%s: %s", name(), e.what());
     }
 
     return false;
@@ -147,7 +147,7 @@ namespace modules {
         m_muted = m_muted || m_mixer[mixer::MASTER]->is_muted();
       }
     } catch (const alsa_exception& err) {
-      m_log.err("%s: Failed to query master mixer (%s)", name(), err.what());
+      POLYBAR_LOG_ERR(m_log, "%s: Failed to query master mixer (%s)", name(), err.what());
     }
 
     try {
@@ -158,7 +158,7 @@ namespace modules {
         m_muted = m_muted || m_mixer[mixer::HEADPHONE]->is_muted();
       }
     } catch (const alsa_exception& err) {
-      m_log.err("%s: Failed to query headphone mixer (%s)", name(), err.what());
+      POLYBAR_LOG_ERR(m_log, "%s: Failed to query headphone mixer (%s)", name(), err.what());
     }
 
     try {
@@ -168,7 +168,7 @@ namespace modules {
         m_muted = m_muted || m_mixer[mixer::SPEAKER]->is_muted();
       }
     } catch (const alsa_exception& err) {
-      m_log.err("%s: Failed to query speaker mixer (%s)", name(), err.what());
+      POLYBAR_LOG_ERR(m_log, "%s: Failed to query speaker mixer (%s)", name(), err.what());
     }
 
     // Replace label tokens
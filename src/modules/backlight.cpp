@@ -67,13 +67,13 @@ namespace modules {
     watch(path_backlight_val);
   }
 
-  void backlight_module::idle() {
-    sleep(75ms);
+  chrono::milliseconds backlight_module::idle_interval() const {
+    return 75ms;
   }
 
   bool backlight_module::on_event(inotify_event* event) {
     if (event != nullptr) {
-      m_log.trace("%s: %s", name(), event->filename);
+      POLYBAR_LOG_TRACE(m_log, "%s: %s", name(), event->filename);
     }
 
     m_max_brightness = m_max.read();
@@ -128,14 +128,14 @@ namespace modules {
   }
 
   void backlight_module::change_value(int value_mod) {
-    m_log.info("%s: Changing value by %d%", name(), value_mod);
+    POLYBAR_LOG_INFO(m_log, "%s: Changing value by %d%%", name(), value_mod);
 
     try {
       int rounded = math_util::cap<double>(m_percentage + value_mod, 0.0, 100.0) + 0.5;
       int value = math_util::percentage_to_value<int>(rounded, m_max_brightness);
       file_util::write_contents(m_path_backlight + "/brightness", to_string(value));
     } catch (const exception& err) {
-      m_log.err(
+      POLYBAR_LOG_ERR(m_log,
           "%s: Unable to change backlight value. Your system may require additional "
           "configuration. Please read the module documentation.\n(reason: %s)",
           name(), err.what());
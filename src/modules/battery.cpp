@@ -169,6 +169,10 @@ namespace modules {
    */
   void battery_module::start() {
     this->inotify_module::start();
+    if (m_interval.count() > 0) {
+      m_polltimer = eventloop::make().add_timer(
+          chrono::time_point_cast<eventloop::clock::duration>(m_lastpoll + m_interval), [this] { poll(); });
+    }
     // We only start animation thread if there is at least one animation.
     if (m_animation_charging || m_animation_discharging || m_animation_low) {
       m_subthread = thread(&battery_module::subthread, this);
@@ -179,31 +183,31 @@ namespace modules {
    * Release wake lock when stopping the module
    */
   void battery_module::teardown() {
+    eventloop::make().remove(m_polltimer);
+    m_polltimer = 0;
     if (m_subthread.joinable()) {
       m_subthread.join();
     }
   }
 
   /**
-   * Idle between polling inotify watches for events.
+   * Called from the event loop once per poll interval.
    *
-   * If the defined interval has been reached, trigger a manual
-   * poll in case the inotify events aren't fired.
+   * If no inotify event has been seen during the interval,
+   * trigger a manual poll in case the inotify events aren't fired.
    *
    * This fallback is needed because some systems won't
    * report inotify events for files on sysfs.
    */
-  void battery_module::idle() {
-    if (m_interval.count() > 0) {
-      auto now = chrono::system_clock::now();
-      if (chrono::duration_cast<decltype(m_interval)>(now - m_lastpoll) > m_interval) {
-        m_lastpoll = now;
-        m_log.info("%s: Polling values (inotify fallback)", name());
-        read(*m_capacity_reader);
-      }
+  void battery_module::poll() {
+    auto now = chrono::system_clock::now();
+    if (chrono::duration_cast<decltype(m_interval)>(now - m_lastpoll) >= m_interval) {
+      m_lastpoll = now;
+      POLYBAR_LOG_INFO(m_log, "%s: Polling values (inotify fallback)", name());
+      read(*m_capacity_reader);
     }
-
-    this->inotify_module::idle();
+    eventloop::make().reschedule(
+        m_polltimer, chrono::time_point_cast<eventloop::clock::duration>(m_lastpoll + m_interval));
   }
 
   /**
@@ -217,7 +221,7 @@ namespace modules {
     m_lastpoll = chrono::system_clock::now();
 
     if (event != nullptr) {
-      m_log.trace("%s: Inotify event reported for %s", name(), event->filename);
+      POLYBAR_LOG_TRACE(m_log, "%s: Inotify event reported for %s", name(), event->filename);
 
       if (state == m_state && percentage == m_percentage && m_unchanged--) {
         return false;
@@ -361,7 +365,7 @@ namespace modules {
    * same time.
    */
   void battery_module::subthread() {
-    m_log.trace("%s: Start of subthread", name());
+    POLYBAR_LOG_TRACE(m_log, "%s: Start of subthread", name());
 
     while (running()) {
       auto now = chrono::steady_clock::now();
@@ -385,7 +389,7 @@ namespace modules {
       this_thread::sleep_until(now);
     }
 
-    m_log.trace("%s: End of subthread", name());
+    POLYBAR_LOG_TRACE(m_log, "%s: End of subthread", name());
   }
 }  // namespace modules
 
@@ -145,15 +145,19 @@ namespace modules {
 
   void bspwm_module::stop() {
     if (m_subscriber) {
-      m_log.info("%s: Disconnecting from socket", name());
+      POLYBAR_LOG_INFO(m_log, "%s: Disconnecting from socket", name());
       m_subscriber->disconnect();
     }
     event_module::stop();
   }
 
+  int bspwm_module::get_event_fd() {
+    return m_subscriber ? m_subscriber->get_file_descriptor() : -1;
+  }
+
   bool bspwm_module::has_event() {
     if (m_subscriber->poll(POLLHUP, 0)) {
-      m_log.notice("%s: Reconnecting to socket...", name());
+      POLYBAR_LOG_NOTICE(m_log, "%s: Reconnecting to socket...", name());
       m_subscriber = bspwm_util::make_subscriber();
     }
     return m_subscriber->peek(1);
@@ -183,7 +187,7 @@ namespace modules {
 
     size_t prefix_len{strlen(BSPWM_STATUS_PREFIX)};
     if (data.compare(0, prefix_len, BSPWM_STATUS_PREFIX) != 0) {
-      m_log.err("%s: Unknown status '%s'", name(), data);
+      POLYBAR_LOG_ERR(m_log, "%s: Unknown status '%s'", name(), data);
       return false;
     }
 
@@ -222,7 +226,7 @@ namespace modules {
       return false;
     }
 
-    m_log.info("%s: Parsing socket data: %s", name(), data);
+    POLYBAR_LOG_INFO(m_log, "%s: Parsing socket data: %s", name(), data);
 
     m_monitors.clear();
 
@@ -279,7 +283,7 @@ namespace modules {
               mode_flag = mode::LAYOUT_TILED;
               break;
             default:
-              m_log.warn("%s: Undefined L => '%s'", name(), value);
+              POLYBAR_LOG_WARN(m_log, "%s: Undefined L => '%s'", name(), value);
           }
           break;
 
@@ -301,7 +305,7 @@ namespace modules {
               mode_flag = mode::STATE_PSEUDOTILED;
               break;
             default:
-              m_log.warn("%s: Undefined T => '%s'", name(), value);
+              POLYBAR_LOG_WARN(m_log, "%s: Undefined T => '%s'", name(), value);
           }
           break;
 
@@ -327,7 +331,7 @@ namespace modules {
                 mode_flag = mode::NODE_MARKED;
                 break;
               default:
-                m_log.warn("%s: Undefined G => '%s'", name(), value.substr(i, 1));
+                POLYBAR_LOG_WARN(m_log, "%s: Undefined G => '%s'", name(), value.substr(i, 1));
             }
 
             if (mode_flag != mode::NONE && !m_modelabels.empty()) {
@@ -337,12 +341,12 @@ namespace modules {
           continue;
 
         default:
-          m_log.warn("%s: Undefined tag => '%s'", name(), tag.substr(0, 1));
+          POLYBAR_LOG_WARN(m_log, "%s: Undefined tag => '%s'", name(), tag.substr(0, 1));
           continue;
       }
 
       if (!m_monitors.back()) {
-        m_log.warn("%s: No monitor created", name());
+        POLYBAR_LOG_WARN(m_log, "%s: No monitor created", name());
         continue;
       }
 
@@ -461,7 +465,7 @@ namespace modules {
       send_command("desktop -f " + m_monitors[monitor_n]->name + ":^" + workspace_n,
           "Sending desktop focus command to ipc handler");
     } else {
-      m_log.err("%s: Invalid monitor index in command: %s", name(), data);
+      POLYBAR_LOG_ERR(m_log, "%s: Invalid monitor index in command: %s", name(), data);
     }
   }
   void bspwm_module::action_next() {
@@ -496,7 +500,7 @@ namespace modules {
   void bspwm_module::send_command(const string& payload_cmd, const string& log_info) {
     auto ipc = bspwm_util::make_connection();
     auto payload = bspwm_util::make_payload(payload_cmd);
-    m_log.info("%s: %s", name(), log_info);
+    POLYBAR_LOG_INFO(m_log, "%s: %s", name(), log_info);
     ipc->send(payload->data, payload->len, 0);
     ipc->disconnect();
   }
@@ -150,7 +150,7 @@ namespace modules {
                                    m_cputimes.back()->idle + m_cputimes.back()->steal;
       }
     } catch (const std::ios_base::failure& e) {
-      m_log.err("Failed to read CPU values (what: %s)", e.what());
+      POLYBAR_LOG_ERR(m_log, "Failed to read CPU values (what: %s)", e.what());
     }
 
     return !m_cputimes.empty();
@@ -29,10 +29,11 @@ namespace modules {
     m_formatter->add(DEFAULT_FORMAT, TAG_LABEL, {TAG_LABEL, TAG_DATE});
 
     if (m_formatter->has(TAG_DATE)) {
-      m_log.warn("%s: The format tag `<date>` is deprecated, use `<label>` instead.", name());
+      POLYBAR_LOG_WARN(m_log, "%s: The format tag `<date>` is deprecated, use `<label>` instead.", name());
 
-      m_formatter->get(DEFAULT_FORMAT)->value =
-          string_util::replace_all(m_formatter->get(DEFAULT_FORMAT)->value, TAG_DATE, TAG_LABEL);
+      auto format = m_formatter->get(DEFAULT_FORMAT);
+      format->value = string_util::replace_all(format->value, TAG_DATE, TAG_LABEL);
+      format->compile();
     }
 
     if (m_formatter->has(TAG_LABEL)) {
@@ -60,11 +60,18 @@ namespace modules {
 
     // Warn about "unreachable" format tag
     if (m_formatter->has(TAG_LABEL_UNMOUNTED) && m_remove_unmounted) {
-      m_log.warn("%s: Defined format tag \"%s\" will never be used (reason: `remove-unmounted = true`)", name(),
-          string{TAG_LABEL_UNMOUNTED});
+      POLYBAR_LOG_WARN(m_log, "%s: Defined format tag \"%s\" will never be used (reason: `remove-unmounted = true`)",
+          name(), string{TAG_LABEL_UNMOUNTED});
     }
   }
 
+  /**
+   * Querying network mounts hangs while their server is unreachable
+   */
+  bool fs_module::blocking_update() const {
+    return true;
+  }
+
   /**
    * Update mountpoints
    */
@@ -91,9 +98,9 @@ namespace modules {
       struct statvfs buffer {};
 
       if (!m_mounts.back()->mounted) {
-        m_log.warn("%s: Mountpoint %s is not mounted", name(), mountpoint);
+        POLYBAR_LOG_WARN(m_log, "%s: Mountpoint %s is not mounted", name(), mountpoint);
       } else if (statvfs(mountpoint.c_str(), &buffer) == -1) {
-        m_log.err("%s: Failed to query filesystem (statvfs() error: %s)", name(), strerror(errno));
+        POLYBAR_LOG_ERR(m_log, "%s: Failed to query filesystem (statvfs() error: %s)", name(), strerror(errno));
       } else {
         auto& mount = m_mounts.back();
         mount->mountpoint = details->at(MOUNTINFO_DIR);
@@ -118,7 +125,8 @@ namespace modules {
           std::stable_partition(m_mounts.begin(), m_mounts.end(), [](const auto& mount) { return mount->mounted; });
 
       for (auto it = new_end; it < m_mounts.end(); ++it) {
-        m_log.info("%s: Removing mountpoint \"%s\" (reason: `remove-unmounted = true`)", name(), (*it)->mountpoint);
+        POLYBAR_LOG_INFO(m_log, "%s: Removing mountpoint \"%s\" (reason: `remove-unmounted = true`)", name(),
+            (*it)->mountpoint);
         m_mountpoints.erase(
             std::remove(m_mountpoints.begin(), m_mountpoints.end(), (*it)->mountpoint), m_mountpoints.end());
       }
@@ -41,6 +41,13 @@ namespace modules {
     update_label(0);
   }
 
+  /**
+   * The request can take as long as the server needs to respond
+   */
+  bool github_module::blocking_update() const {
+    return true;
+  }
+
   /**
    * Update module contents
    */
@@ -81,7 +88,7 @@ namespace modules {
       content = request();
     } catch (application_error& e) {
       if (!m_offline) {
-        m_log.info("%s: cannot complete the request to github: %s", name(), e.what());
+        POLYBAR_LOG_INFO(m_log, "%s: cannot complete the request to github: %s", name(), e.what());
       }
       m_offline = true;
       return -1;
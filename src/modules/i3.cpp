@@ -141,7 +141,7 @@ namespace modules {
   void i3_module::stop() {
     try {
       if (m_ipc) {
-        m_log.info("%s: Disconnecting from socket", name());
+        POLYBAR_LOG_INFO(m_log, "%s: Disconnecting from socket", name());
         shutdown(m_ipc->get_event_socket_fd(), SHUT_RDWR);
         shutdown(m_ipc->get_main_socket_fd(), SHUT_RDWR);
       }
@@ -151,17 +151,21 @@ namespace modules {
     event_module::stop();
   }
 
+  int i3_module::get_event_fd() {
+    return m_ipc ? m_ipc->get_event_socket_fd() : -1;
+  }
+
   bool i3_module::has_event() {
     try {
       m_ipc->handle_event();
       return true;
     } catch (const exception& err) {
       try {
-        m_log.warn("%s: Attempting to reconnect socket (reason: %s)", name(), err.what());
+        POLYBAR_LOG_WARN(m_log, "%s: Attempting to reconnect socket (reason: %s)", name(), err.what());
         m_ipc->connect_event_socket(true);
-        m_log.info("%s: Reconnecting socket succeeded", name());
+        POLYBAR_LOG_INFO(m_log, "%s: Reconnecting socket succeeded", name());
       } catch (const exception& err) {
-        m_log.err("%s: Failed to reconnect socket (reason: %s)", name(), err.what());
+        POLYBAR_LOG_ERR(m_log, "%s: Failed to reconnect socket (reason: %s)", name(), err.what());
       }
       return false;
     }
@@ -254,7 +258,7 @@ namespace modules {
       }
       return true;
     } catch (const exception& err) {
-      m_log.err("%s: %s", name(), err.what());
+      POLYBAR_LOG_ERR(m_log, "%s: %s", name(), err.what());
       return false;
     }
   }
@@ -300,7 +304,7 @@ namespace modules {
 
   void i3_module::action_focus(const string& ws) {
     const i3_util::connection_t conn{};
-    m_log.info("%s: Sending workspace focus command to ipc handler", name());
+    POLYBAR_LOG_INFO(m_log, "%s: Sending workspace focus command to ipc handler", name());
     conn.send_command(make_workspace_command(ws));
   }
 
@@ -319,23 +323,23 @@ namespace modules {
     auto current_ws = std::find_if(workspaces.begin(), workspaces.end(), [](auto ws) { return ws->visible; });
 
     if (current_ws == workspaces.end()) {
-      m_log.warn("%s: Current workspace not found", name());
+      POLYBAR_LOG_WARN(m_log, "%s: Current workspace not found", name());
       return;
     }
 
     if (next && (m_wrap || std::next(current_ws) != workspaces.end())) {
       if (!(*current_ws)->focused) {
-        m_log.info("%s: Sending workspace focus command to ipc handler", name());
+        POLYBAR_LOG_INFO(m_log, "%s: Sending workspace focus command to ipc handler", name());
         conn.send_command(make_workspace_command((*current_ws)->name));
       }
-      m_log.info("%s: Sending workspace next_on_output command to ipc handler", name());
+      POLYBAR_LOG_INFO(m_log, "%s: Sending workspace next_on_output command to ipc handler", name());
       conn.send_command("workspace next_on_output");
     } else if (!next && (m_wrap || current_ws != workspaces.begin())) {
       if (!(*current_ws)->focused) {
-        m_log.info("%s: Sending workspace focus command to ipc handler", name());
+        POLYBAR_LOG_INFO(m_log, "%s: Sending workspace focus command to ipc handler", name());
         conn.send_command(make_workspace_command((*current_ws)->name));
       }
-      m_log.info("%s: Sending workspace prev_on_output command to ipc handler", name());
+      POLYBAR_LOG_INFO(m_log, "%s: Sending workspace prev_on_output command to ipc handler", name());
       conn.send_command("workspace prev_on_output");
     }
   }
@@ -358,7 +362,7 @@ namespace modules {
     result.static_name = StripPrefix(sections[2], ':');
     result.dynamic_name = StripPrefix(sections[3], ':');
     result.local_number = std::stoi(StripPrefix(sections[4], ':'));
-    m_log.trace(
+    POLYBAR_LOG_TRACE(m_log,
         "%s: Workspace name sections parsed: global_number=%d, group=%s, static_name=%s, dynamic_name=%s, "
         "local_number=%d",
         name(), result.global_number, result.group, result.static_name, result.dynamic_name, result.local_number);
@@ -404,7 +408,7 @@ namespace modules {
       const auto& ws = i3_workspaces[i];
       const auto name_sections = parse_workspace_name(ws->name);
       if (ws->num != name_sections.global_number) {
-        m_log.warn("Mismatched workspace global number: %d vs %d", ws->num, name_sections.global_number);
+        POLYBAR_LOG_WARN(m_log, "Mismatched workspace global number: %d vs %d", ws->num, name_sections.global_number);
       }
 
       state ws_state{state::NONE};
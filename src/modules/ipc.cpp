@@ -21,7 +21,7 @@ namespace modules {
       m_hooks.emplace_back(std::make_unique<hook>(hook{name() + to_string(++index), command}));
     }
 
-    m_log.info("%s: Loaded %d hooks", name(), m_hooks.size());
+    POLYBAR_LOG_INFO(m_log, "%s: Loaded %d hooks", name(), m_hooks.size());
 
     if ((m_initial = m_conf.get(name(), "initial", 0_z)) && m_initial > m_hooks.size()) {
       throw module_error("Initial hook out of bounds (defined: " + to_string(m_hooks.size()) + ")");
@@ -109,7 +109,7 @@ namespace modules {
         continue;
       }
 
-      m_log.info("%s: Found matching hook (%s)", name(), hook->payload);
+      POLYBAR_LOG_INFO(m_log, "%s: Found matching hook (%s)", name(), hook->payload);
 
       try {
         // Clear the output in case the command produces no output
@@ -118,7 +118,7 @@ namespace modules {
         command->exec(false);
         command->tail([this](string line) { m_output = line; });
       } catch (const exception& err) {
-        m_log.err("%s: Failed to execute hook command (err: %s)", err.what());
+        POLYBAR_LOG_ERR(m_log, "%s: Failed to execute hook command (err: %s)", name(), err.what());
         m_output.clear();
       }
 
@@ -92,7 +92,7 @@ namespace modules {
         kb_avail = parsed["MemFree"] + parsed["Buffers"] + parsed["Cached"] + parsed["SReclaimable"] - parsed["Shmem"];
       }
     } catch (const std::exception& err) {
-      m_log.err("Failed to read memory values (what: %s)", err.what());
+      POLYBAR_LOG_ERR(m_log, "Failed to read memory values (what: %s)", err.what());
     }
 
     m_perc_memfree = math_util::percentage(kb_avail, kb_total);
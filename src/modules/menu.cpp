@@ -48,7 +48,7 @@ namespace modules {
         break;
       }
 
-      m_log.trace("%s: Creating menu level %i", name(), m_levels.size());
+      POLYBAR_LOG_TRACE(m_log, "%s: Creating menu level %i", name(), m_levels.size());
       m_levels.emplace_back(factory_util::unique<menu_tree>());
 
       while (true) {
@@ -58,7 +58,7 @@ namespace modules {
           break;
         }
 
-        m_log.trace("%s: Creating menu level item %i", name(), m_levels.back()->items.size());
+        POLYBAR_LOG_TRACE(m_log, "%s: Creating menu level item %i", name(), m_levels.back()->items.size());
         auto item = factory_util::unique<menu_tree_item>();
         item->label = load_label(m_conf, name(), item_param);
         item->exec = m_conf.get(name(), item_param + "-exec", actions_util::get_action_string(*this, EVENT_CLOSE, ""));
@@ -105,10 +105,10 @@ namespace modules {
   void menu_module::action_open(const string& data) {
     string level = data.empty() ? "0" : data;
     int level_num = m_level = std::strtol(level.c_str(), nullptr, 10);
-    m_log.info("%s: Opening menu level '%i'", name(), static_cast<int>(level_num));
+    POLYBAR_LOG_INFO(m_log, "%s: Opening menu level '%i'", name(), static_cast<int>(level_num));
 
     if (static_cast<size_t>(level_num) >= m_levels.size()) {
-      m_log.warn("%s: Cannot open unexisting menu level '%s'", name(), level);
+      POLYBAR_LOG_WARN(m_log, "%s: Cannot open unexisting menu level '%s'", name(), level);
       m_level = -1;
     } else {
       m_level = level_num;
@@ -117,7 +117,7 @@ namespace modules {
   }
 
   void menu_module::action_close() {
-    m_log.info("%s: Closing menu tree", name());
+    POLYBAR_LOG_INFO(m_log, "%s: Closing menu tree", name());
     if (m_level != -1) {
       m_level = -1;
       broadcast();
@@ -128,14 +128,14 @@ namespace modules {
     auto sep = element.find("-");
 
     if (sep == element.npos) {
-      m_log.err("%s: Malformed data for exec action (data: '%s')", name(), element);
+      POLYBAR_LOG_ERR(m_log, "%s: Malformed data for exec action (data: '%s')", name(), element);
     }
 
     auto level = std::strtoul(element.substr(0, sep).c_str(), nullptr, 10);
     auto item = std::strtoul(element.substr(sep + 1).c_str(), nullptr, 10);
 
     if (level >= m_levels.size() || item >= m_levels[level]->items.size()) {
-      m_log.err("%s: menu-exec-%d-%d doesn't exist (data: '%s')", name(), level, item, element);
+      POLYBAR_LOG_ERR(m_log, "%s: menu-exec-%d-%d doesn't exist (data: '%s')", name(), level, item, element);
     }
 
     string exec = m_levels[level]->items[item]->exec;
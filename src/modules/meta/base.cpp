@@ -83,6 +83,54 @@ namespace modules {
     return builder->flush();
   }
 
+  /**
+   * Split the value up at its tags, so that the output can be built without
+   * parsing the value again
+   *
+   * Has to be called again whenever the value is changed. Tags that are not
+   * allowed in the format are kept and still passed to build(), which
+   * builds nothing for them.
+   */
+  void module_format::compile() {
+    segments.clear();
+    tail.clear();
+    tag_mask = 0;
+
+    size_t pos{0};
+    size_t start, end;
+    while ((start = value.find('<', pos)) != string::npos && (end = value.find('>', start)) != string::npos) {
+      string tag{value.substr(start, end - start + 1)};
+      auto id = static_cast<size_t>(find(tags.begin(), tags.end(), tag) - tags.begin());
+      if (id == tags.size()) {
+        id = string::npos;
+      }
+
+      string text{value.substr(pos, start - pos)};
+      string trimmed{string_util::ltrim(string{text}, ' ')};
+      segments.emplace_back(segment{move(text), move(trimmed), move(tag), id});
+
+      if (id < MASK_BITS) {
+        tag_mask |= uint64_t{1} << id;
+      }
+      pos = end + 1;
+    }
+
+    tail = value.substr(pos);
+  }
+
+  /**
+   * Whether the given tag is used in the format
+   */
+  bool module_format::has(const string& tag) const {
+    auto id = static_cast<size_t>(find(tags.begin(), tags.end(), tag) - tags.begin());
+    if (id == tags.size()) {
+      return false;
+    } else if (id < MASK_BITS) {
+      return tag_mask & (uint64_t{1} << id);
+    }
+    return std::any_of(segments.begin(), segments.end(), [id](const segment& s) { return s.id == id; });
+  }
+
   // }}}
   // module_formatter {{{
 
@@ -104,6 +152,7 @@ namespace modules {
     format->offset = m_conf.get(m_modname, name + "-offset", formatdef("offset", format->offset));
     format->font = m_conf.get(m_modname, name + "-font", formatdef("font", format->font));
     format->tags.swap(tags);
+    format->tags.insert(format->tags.end(), whitelist.begin(), whitelist.end());
 
     try {
       format->prefix = load_label(m_conf, m_modname, name + "-prefix");
@@ -117,24 +166,7 @@ namespace modules {
       // suffix not defined
     }
 
-    vector<string> tag_collection;
-    tag_collection.reserve(format->tags.size() + whitelist.size());
-    tag_collection.insert(tag_collection.end(), format->tags.begin(), format->tags.end());
-    tag_collection.insert(tag_collection.end(), whitelist.begin(), whitelist.end());
-
-    size_t start, end;
-    while ((start = value.find('<')) != string::npos && (end = value.find('>', start)) != string::npos) {
-      if (start > 0) {
-        value.erase(0, start);
-        end -= start;
-        start = 0;
-      }
-      string tag{value.substr(start, end + 1)};
-      if (find(tag_collection.begin(), tag_collection.end(), tag) == tag_collection.end()) {
-        throw undefined_format_tag(tag + " is not a valid format tag for \"" + name + "\"");
-      }
-      value.erase(0, tag.size());
-    }
+    format->compile();
 
     m_formats.insert(make_pair(move(name), move(format)));
   }
@@ -156,12 +188,12 @@ namespace modules {
     if (format == m_formats.end()) {
       return false;
     }
-    return format->second->value.find(tag) != string::npos;
+    return format->second->has(tag);
   }
 
   bool module_formatter::has(const string& tag) {
     for (auto&& format : m_formats) {
-      if (format.second->value.find(tag) != string::npos) {
+      if (format.second->has(tag)) {
         return true;
       }
     }
@@ -137,7 +137,7 @@ namespace modules {
       m_mpd->connect();
       m_status = m_mpd->get_status();
     } catch (const mpd_exception& err) {
-      m_log.err("%s: %s", name(), err.what());
+      POLYBAR_LOG_ERR(m_log, "%s: %s", name(), err.what());
       m_mpd.reset();
     }
   }
@@ -176,7 +176,7 @@ namespace modules {
         m_mpd->connect();
       }
     } catch (const mpd_exception& err) {
-      m_log.err("%s: %s", name(), err.what());
+      POLYBAR_LOG_ERR(m_log, "%s: %s", name(), err.what());
       m_mpd.reset();
       return def;
     }
@@ -199,7 +199,7 @@ namespace modules {
         return true;
       }
     } catch (const mpd_exception& err) {
-      m_log.err("%s: %s", name(), err.what());
+      POLYBAR_LOG_ERR(m_log, "%s: %s", name(), err.what());
       m_mpd.reset();
       return def;
     }
@@ -263,7 +263,7 @@ namespace modules {
         }
       }
     } catch (const mpd_exception& err) {
-      m_log.err("%s: %s", name(), err.what());
+      POLYBAR_LOG_ERR(m_log, "%s: %s", name(), err.what());
       m_mpd.reset();
     }
 
@@ -312,7 +312,7 @@ namespace modules {
 
   string mpd_module::get_output() {
     if (m_status && m_status->get_queuelen() == 0) {
-      m_log.info("%s: Hiding module since queue is empty", name());
+      POLYBAR_LOG_INFO(m_log, "%s: Hiding module since queue is empty", name());
       return "";
     } else {
       return event_module::get_output();
@@ -21,12 +21,12 @@ namespace modules {
       if (type == "wired") {
         m_interface = net::find_wired_interface();
         if (!m_interface.empty()) {
-          m_log.notice("%s: Discovered wired interface %s", name(), m_interface);
+          POLYBAR_LOG_NOTICE(m_log, "%s: Discovered wired interface %s", name(), m_interface);
         }
       } else if (type == "wireless") {
         m_interface = net::find_wireless_interface();
         if (!m_interface.empty()) {
-          m_log.notice("%s: Discovered wireless interface %s", name(), m_interface);
+          POLYBAR_LOG_NOTICE(m_log, "%s: Discovered wireless interface %s", name(), m_interface);
         }
       } else {
         throw module_error("Invalid interface type '" + type + "'");
@@ -106,12 +106,19 @@ namespace modules {
     m_wired.reset();
   }
 
+  /**
+   * Pinging blocks for up to a few seconds
+   */
+  bool network_module::blocking_update() const {
+    return m_ping_nth_update > 0;
+  }
+
   bool network_module::update() {
     net::network* network =
         m_wireless ? static_cast<net::network*>(m_wireless.get()) : static_cast<net::network*>(m_wired.get());
 
     if (!network->query(m_accumulate)) {
-      m_log.warn("%s: Failed to query interface '%s'", name(), m_interface);
+      POLYBAR_LOG_WARN(m_log, "%s: Failed to query interface '%s'", name(), m_interface);
       m_connected = false;
       return false;
     }
@@ -122,7 +129,7 @@ namespace modules {
         m_quality = m_wireless->quality();
       }
     } catch (const net::network_error& err) {
-      m_log.warn("%s: Error getting interface data (%s)", name(), err.what());
+      POLYBAR_LOG_WARN(m_log, "%s: Error getting interface data (%s)", name(), err.what());
     }
 
     m_connected = network->connected();
@@ -212,7 +219,7 @@ namespace modules {
       this_thread::sleep_until(now);
     }
 
-    m_log.trace("%s: Reached end of network subthread", name());
+    POLYBAR_LOG_TRACE(m_log, "%s: Reached end of network subthread", name());
   }
 }  // namespace modules
 
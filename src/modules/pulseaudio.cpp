@@ -61,7 +61,7 @@ namespace modules {
       if (m_pulseaudio->wait())
         return true;
     } catch (const pulseaudio_error& e) {
-      m_log.err("%s: %s", name(), e.what());
+      POLYBAR_LOG_ERR(m_log, "%s: %s", name(), e.what());
     }
     return false;
   }
@@ -82,7 +82,7 @@ namespace modules {
         m_muted = m_muted || m_pulseaudio->is_muted();
       }
     } catch (const pulseaudio_error& err) {
-      m_log.err("%s: Failed to query pulseaudio sink (%s)", name(), err.what());
+      POLYBAR_LOG_ERR(m_log, "%s: Failed to query pulseaudio sink (%s)", name(), err.what());
     }
 
     // Replace label tokens
@@ -21,13 +21,13 @@ namespace modules {
           return [&] {
             if (!m_command || !m_command->is_running()) {
               string exec{string_util::replace_all(m_exec, "%counter%", to_string(++m_counter))};
-              m_log.info("%s: Invoking shell command: \"%s\"", name(), exec);
+              POLYBAR_LOG_INFO(m_log, "%s: Invoking shell command: \"%s\"", name(), exec);
               m_command = command_util::make_command<output_policy::REDIRECTED>(exec);
 
               try {
                 m_command->exec(false);
               } catch (const exception& err) {
-                m_log.err("%s: %s", name(), err.what());
+                POLYBAR_LOG_ERR(m_log, "%s: %s", name(), err.what());
                 throw module_error("Failed to execute command, stopping module...");
               }
             }
@@ -58,18 +58,18 @@ namespace modules {
         return [&] {
           try {
             auto exec = string_util::replace_all(m_exec, "%counter%", to_string(++m_counter));
-            m_log.info("%s: Invoking shell command: \"%s\"", name(), exec);
+            POLYBAR_LOG_INFO(m_log, "%s: Invoking shell command: \"%s\"", name(), exec);
             m_command = command_util::make_command<output_policy::REDIRECTED>(exec);
             m_command->exec(true);
           } catch (const exception& err) {
-            m_log.err("%s: %s", name(), err.what());
+            POLYBAR_LOG_ERR(m_log, "%s: %s", name(), err.what());
             throw module_error("Failed to execute command, stopping module...");
           }
 
           int fd = m_command->get_stdout(PIPE_READ);
           if (fd != -1 && io_util::poll_read(fd) && (m_output = m_command->readline()) != m_prev) {
-            broadcast();
             m_prev = m_output;
+            broadcast();
           } else if (m_command->get_exit_status() != 0) {
             m_output.clear();
             m_prev.clear();
@@ -146,9 +146,9 @@ namespace modules {
     } else if (command_util::make_command<output_policy::IGNORED>(m_exec_if)->exec(true) == 0) {
       return true;
     } else if (!m_output.empty()) {
-      broadcast();
       m_output.clear();
       m_prev.clear();
+      broadcast();
     }
     return false;
   }
@@ -46,7 +46,8 @@ namespace modules {
     // Deprecation warning for the %temperature% token
     if((m_label[temp_state::NORMAL] && m_label[temp_state::NORMAL]->has_token("%temperature%")) ||
         ((m_label[temp_state::WARN] && m_label[temp_state::WARN]->has_token("%temperature%")))) {
-      m_log.warn("%s: The token `%%temperature%%` is deprecated, use `%%temperature-c%%` instead.", name());
+      POLYBAR_LOG_WARN(m_log, "%s: The token `%%temperature%%` is deprecated, use `%%temperature-c%%` instead.",
+          name());
     }
   }
 
@@ -41,7 +41,7 @@ namespace modules {
       randr_util::get_backlight_range(m_connection, m_output, backlight);
       randr_util::get_backlight_value(m_connection, m_output, backlight);
     } catch (const exception& err) {
-      m_log.err("%s: Could not get data (err: %s)", name(), err.what());
+      POLYBAR_LOG_ERR(m_log, "%s: Could not get data (err: %s)", name(), err.what());
       throw module_error("Not supported for \"" + m_output->name + "\"");
     }
 
@@ -156,7 +156,7 @@ namespace modules {
   }
 
   void xbacklight_module::change_value(int value_mod) {
-    m_log.info("%s: Changing value by %i%", name(), value_mod);
+    POLYBAR_LOG_INFO(m_log, "%s: Changing value by %i%%", name(), value_mod);
     int rounded = math_util::cap<double>(m_percentage + value_mod, 0.0, 100.0) + 0.5;
 
     const int values[1]{math_util::percentage_to_value<int>(rounded, m_output->backlight.max)};
@@ -117,24 +117,27 @@ namespace modules {
    * Handler for XCB_PROPERTY_NOTIFY events
    */
   void xworkspaces_module::handle(const evt::property_notify& evt) {
-    std::lock_guard<std::mutex> lock(m_workspace_mutex);
-
-    if (evt->atom == m_ewmh->_NET_CLIENT_LIST || evt->atom == m_ewmh->_NET_WM_DESKTOP) {
-      rebuild_clientlist();
-      rebuild_desktop_states();
-    } else if (evt->atom == m_ewmh->_NET_DESKTOP_NAMES || evt->atom == m_ewmh->_NET_NUMBER_OF_DESKTOPS) {
-      m_desktop_names = get_desktop_names();
-      rebuild_desktops();
-      rebuild_clientlist();
-      rebuild_desktop_states();
-    } else if (evt->atom == m_ewmh->_NET_CURRENT_DESKTOP) {
-      update_current_desktop();
-      rebuild_desktop_states();
-    } else if (evt->atom == WM_HINTS) {
-      rebuild_urgent_hints();
-      rebuild_desktop_states();
-    } else {
-      return;
+    {
+      // Released before broadcasting, building the output needs it
+      std::lock_guard<std::mutex> lock(m_workspace_mutex);
+
+      if (evt->atom == m_ewmh->_NET_CLIENT_LIST || evt->atom == m_ewmh->_NET_WM_DESKTOP) {
+        rebuild_clientlist();
+        rebuild_desktop_states();
+      } else if (evt->atom == m_ewmh->_NET_DESKTOP_NAMES || evt->atom == m_ewmh->_NET_NUMBER_OF_DESKTOPS) {
+        m_desktop_names = get_desktop_names();
+        rebuild_desktops();
+        rebuild_clientlist();
+        rebuild_desktop_states();
+      } else if (evt->atom == m_ewmh->_NET_CURRENT_DESKTOP) {
+        update_current_desktop();
+        rebuild_desktop_states();
+      } else if (evt->atom == WM_HINTS) {
+        rebuild_urgent_hints();
+        rebuild_desktop_states();
+      } else {
+        return;
+      }
     }
 
     broadcast();
@@ -417,10 +420,10 @@ namespace modules {
   void xworkspaces_module::focus_desktop(unsigned new_desktop) {
     unsigned int current_desktop{ewmh_util::get_current_desktop()};
     if (new_desktop != current_desktop) {
-      m_log.info("%s: Requesting change to desktop #%u", name(), new_desktop);
+      POLYBAR_LOG_INFO(m_log, "%s: Requesting change to desktop #%u", name(), new_desktop);
       ewmh_util::change_current_desktop(new_desktop);
     } else {
-      m_log.info("%s: Ignoring change to current desktop", name());
+      POLYBAR_LOG_INFO(m_log, "%s: Ignoring change to current desktop", name());
     }
   }
 }  // namespace modules
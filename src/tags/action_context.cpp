@@ -10,9 +10,9 @@ namespace tags {
     m_action_blocks.clear();
   }
 
-  action_t action_context::action_open(mousebtn btn, const string&& cmd, alignment align, double x) {
+  action_t action_context::action_open(mousebtn btn, const string& cmd, alignment align, double x) {
     action_t id = m_action_blocks.size();
-    m_action_blocks.emplace_back(std::move(cmd), btn, align, true);
+    m_action_blocks.emplace_back(cmd, btn, align, true);
     set_start(id, x);
     return id;
   }
@@ -31,75 +31,62 @@ namespace tags {
     tags::parser p;
     p.set(std::move(data));
 
-    m_action_ctxt.reset();
-    m_ctxt = make_unique<context>(bar);
+    begin(bar);
 
     while (p.has_next_element()) {
       tags::element el;
       try {
         el = p.next_element();
       } catch (const tags::error& e) {
-        m_log.err("Parser error (reason: %s)", e.what());
+        POLYBAR_LOG_ERR(m_log, "Parser error (reason: %s)", e.what());
         continue;
       }
 
-      if (el.is_tag) {
-        switch (el.tag_data.type) {
-          case tags::tag_type::FORMAT:
-            switch (el.tag_data.subtype.format) {
-              case tags::syntaxtag::A:
-                handle_action(renderer, el.tag_data.action.btn, el.tag_data.action.closing, std::move(el.data));
-                break;
-              case tags::syntaxtag::B:
-                m_ctxt->apply_bg(el.tag_data.color);
-                break;
-              case tags::syntaxtag::F:
-                m_ctxt->apply_fg(el.tag_data.color);
-                break;
-              case tags::syntaxtag::T:
-                m_ctxt->apply_font(el.tag_data.font);
-                break;
-              case tags::syntaxtag::O:
-                renderer.render_offset(*m_ctxt, el.tag_data.offset);
-                break;
-              case tags::syntaxtag::R:
-                m_ctxt->apply_reverse();
-                break;
-              case tags::syntaxtag::o:
-                m_ctxt->apply_ol(el.tag_data.color);
-                break;
-              case tags::syntaxtag::u:
-                m_ctxt->apply_ul(el.tag_data.color);
-                break;
-              case tags::syntaxtag::P:
-                handle_control(el.tag_data.ctrl);
-                break;
-              case tags::syntaxtag::l:
-                m_ctxt->apply_alignment(alignment::LEFT);
-                renderer.change_alignment(*m_ctxt);
-                break;
-              case tags::syntaxtag::r:
-                m_ctxt->apply_alignment(alignment::RIGHT);
-                renderer.change_alignment(*m_ctxt);
-                break;
-              case tags::syntaxtag::c:
-                m_ctxt->apply_alignment(alignment::CENTER);
-                renderer.change_alignment(*m_ctxt);
-                break;
-              default:
-                throw runtime_error(
-                    "Unrecognized tag format: " + to_string(static_cast<int>(el.tag_data.subtype.format)));
-            }
-            break;
-          case tags::tag_type::ATTR:
-            m_ctxt->apply_attr(el.tag_data.subtype.activation, el.tag_data.attr);
-            break;
-        }
-      } else {
-        handle_text(renderer, std::move(el.data));
+      handle_element(renderer, el);
+    }
+
+    end(renderer);
+  }
+
+  /**
+   * Process already parsed elements
+   *
+   * Skips the tag parser completely, used when the formatting
+   * string was parsed in advance.
+   */
+  void dispatch::parse(const bar_settings& bar, renderer_interface& renderer, const format_string& elements) {
+    begin(bar);
+
+    for (const auto& el : elements) {
+      handle_element(renderer, el);
+    }
+
+    end(renderer);
+  }
+
+  /**
+   * Process already parsed elements, split up into blocks
+   *
+   * The blocks are drawn in order as if they were a single formatting string.
+   */
+  void dispatch::parse(const bar_settings& bar, renderer_interface& renderer, const format_blocks& blocks) {
+    begin(bar);
+
+    for (const auto& block : blocks) {
+      for (const auto& el : *block) {
+        handle_element(renderer, el);
       }
     }
 
+    end(renderer);
+  }
+
+  void dispatch::begin(const bar_settings& bar) {
+    m_action_ctxt.reset();
+    m_ctxt = make_unique<context>(bar);
+  }
+
+  void dispatch::end(renderer_interface& renderer) {
     /*
      * After rendering, we need to tell the action context about the position
      * of the alignment blocks so that it can do intersection tests.
@@ -115,33 +102,99 @@ namespace tags {
     }
   }
 
+  void dispatch::handle_element(renderer_interface& renderer, const element& el) {
+    if (!el.is_tag) {
+      handle_text(renderer, el.data);
+      return;
+    }
+
+    switch (el.tag_data.type) {
+      case tags::tag_type::FORMAT:
+        switch (el.tag_data.subtype.format) {
+          case tags::syntaxtag::A:
+            handle_action(renderer, el.tag_data.action.btn, el.tag_data.action.closing, el.data);
+            break;
+          case tags::syntaxtag::B:
+            m_ctxt->apply_bg(el.tag_data.color);
+            break;
+          case tags::syntaxtag::F:
+            m_ctxt->apply_fg(el.tag_data.color);
+            break;
+          case tags::syntaxtag::T:
+            m_ctxt->apply_font(el.tag_data.font);
+            break;
+          case tags::syntaxtag::O:
+            renderer.render_offset(*m_ctxt, el.tag_data.offset);
+            break;
+          case tags::syntaxtag::R:
+            m_ctxt->apply_reverse();
+            break;
+          case tags::syntaxtag::o:
+            m_ctxt->apply_ol(el.tag_data.color);
+            break;
+          case tags::syntaxtag::u:
+            m_ctxt->apply_ul(el.tag_data.color);
+            break;
+          case tags::syntaxtag::P:
+            handle_control(renderer, el.tag_data.ctrl, el.data);
+            break;
+          case tags::syntaxtag::l:
+            m_ctxt->apply_alignment(alignment::LEFT);
+            renderer.change_alignment(*m_ctxt);
+            break;
+          case tags::syntaxtag::r:
+            m_ctxt->apply_alignment(alignment::RIGHT);
+            renderer.change_alignment(*m_ctxt);
+            break;
+          case tags::syntaxtag::c:
+            m_ctxt->apply_alignment(alignment::CENTER);
+            renderer.change_alignment(*m_ctxt);
+            break;
+          default:
+            throw runtime_error("Unrecognized tag format: " + to_string(static_cast<int>(el.tag_data.subtype.format)));
+        }
+        break;
+      case tags::tag_type::ATTR:
+        m_ctxt->apply_attr(el.tag_data.subtype.activation, el.tag_data.attr);
+        break;
+    }
+  }
+
   /**
    * Process text contents
    */
-  void dispatch::handle_text(renderer_interface& renderer, string&& data) {
+  void dispatch::handle_text(renderer_interface& renderer, const string& data) {
 #ifdef DEBUG_WHITESPACE
+    string text{data};
     string::size_type p;
-    while ((p = data.find(' ')) != string::npos) {
-      data.replace(p, 1, "-"s);
+    while ((p = text.find(' ')) != string::npos) {
+      text.replace(p, 1, "-"s);
     }
+    renderer.render_text(*m_ctxt, text);
+#else
+    renderer.render_text(*m_ctxt, data);
 #endif
-
-    renderer.render_text(*m_ctxt, std::move(data));
   }
 
-  void dispatch::handle_action(renderer_interface& renderer, mousebtn btn, bool closing, const string&& cmd) {
+  void dispatch::handle_action(renderer_interface& renderer, mousebtn btn, bool closing, const string& cmd) {
     if (closing) {
       m_action_ctxt.action_close(btn, m_ctxt->get_alignment(), renderer.get_x(*m_ctxt));
     } else {
-      m_action_ctxt.action_open(btn, std::move(cmd), m_ctxt->get_alignment(), renderer.get_x(*m_ctxt));
+      m_action_ctxt.action_open(btn, cmd, m_ctxt->get_alignment(), renderer.get_x(*m_ctxt));
     }
   }
 
-  void dispatch::handle_control(controltag ctrl) {
+  void dispatch::handle_control(renderer_interface& renderer, controltag ctrl, const string& data) {
     switch (ctrl) {
       case controltag::R:
         m_ctxt->apply_reset();
         break;
+      case controltag::S:
+        renderer.begin_slice(*m_ctxt, data);
+        break;
+      case controltag::E:
+        renderer.end_slice(*m_ctxt);
+        break;
       default:
         throw runtime_error("Unrecognized polybar control tag: " + to_string(static_cast<int>(ctrl)));
     }
@@ -45,7 +45,7 @@ int command<output_policy::IGNORED>::exec(bool wait_for_completion) {
 
 void command<output_policy::IGNORED>::terminate() {
   if (is_running()) {
-    m_log.trace("command: Sending SIGTERM to running child process (%d)", m_forkpid);
+    POLYBAR_LOG_TRACE(m_log, "command: Sending SIGTERM to running child process (%d)", m_forkpid);
     killpg(m_forkpid, SIGTERM);
     wait();
   }
@@ -64,20 +64,20 @@ bool command<output_policy::IGNORED>::is_running() {
  */
 int command<output_policy::IGNORED>::wait() {
   do {
-    m_log.trace("command: Waiting for pid %d to finish...", m_forkpid);
+    POLYBAR_LOG_TRACE(m_log, "command: Waiting for pid %d to finish...", m_forkpid);
 
     process_util::wait_for_completion(m_forkpid, &m_forkstatus, WCONTINUED | WUNTRACED);
 
     if (WIFEXITED(m_forkstatus) && m_forkstatus > 0) {
-      m_log.trace("command: Exited with failed status %d", WEXITSTATUS(m_forkstatus));
+      POLYBAR_LOG_TRACE(m_log, "command: Exited with failed status %d", WEXITSTATUS(m_forkstatus));
     } else if (WIFEXITED(m_forkstatus)) {
-      m_log.trace("command: Exited with status %d", WEXITSTATUS(m_forkstatus));
+      POLYBAR_LOG_TRACE(m_log, "command: Exited with status %d", WEXITSTATUS(m_forkstatus));
     } else if (WIFSIGNALED(m_forkstatus)) {
-      m_log.trace("command: killed by signal %d", WTERMSIG(m_forkstatus));
+      POLYBAR_LOG_TRACE(m_log, "command: killed by signal %d", WTERMSIG(m_forkstatus));
     } else if (WIFSTOPPED(m_forkstatus)) {
-      m_log.trace("command: Stopped by signal %d", WSTOPSIG(m_forkstatus));
+      POLYBAR_LOG_TRACE(m_log, "command: Stopped by signal %d", WSTOPSIG(m_forkstatus));
     } else if (WIFCONTINUED(m_forkstatus)) {
-      m_log.trace("command: Continued");
+      POLYBAR_LOG_TRACE(m_log, "command: Continued");
     } else {
       break;
     }
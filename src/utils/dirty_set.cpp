@@ -0,0 +1,65 @@
+#include "utils/dirty_set.hpp"
+
+#include <cassert>
+
+POLYBAR_NS
+
+dirty_set::dirty_set(size_t size)
+    : m_size(size)
+    , m_words((size + WORD_BITS - 1) / WORD_BITS)
+    , m_bits(new std::atomic<uint64_t>[m_words]) {
+  for (size_t i = 0; i < m_words; i++) {
+    m_bits[i].store(0, std::memory_order_relaxed);
+  }
+}
+
+size_t dirty_set::size() const {
+  return m_size;
+}
+
+/**
+ * Whether any index was marked since the set was last taken
+ */
+bool dirty_set::pending() const {
+  return m_pending.load(std::memory_order_acquire);
+}
+
+/**
+ * Mark the given index as changed
+ *
+ * \returns true if the set was clean before, the caller then has to wake up
+ *          the consumer
+ */
+bool dirty_set::mark(size_t index) {
+  assert(index < m_size);
+  m_bits[index / WORD_BITS].fetch_or(uint64_t{1} << (index % WORD_BITS), std::memory_order_seq_cst);
+  return !m_pending.exchange(true, std::memory_order_seq_cst);
+}
+
+/**
+ * Take out all changed indices and leave the set clean
+ *
+ * The pending flag is cleared before the bits are swapped out, an index
+ * marked while this runs either ends up in the result or wakes up the
+ * consumer again. Both sides write one location and then access the other
+ * one, so all four operations have to be sequentially consistent, any
+ * weaker ordering lets a mark miss the swap without waking anyone up.
+ *
+ * \returns a flag for every index, set if it changed
+ */
+vector<bool> dirty_set::take() {
+  vector<bool> changed(m_size, false);
+  m_pending.store(false, std::memory_order_seq_cst);
+
+  for (size_t i = 0; i < m_words; i++) {
+    auto bits = m_bits[i].exchange(0, std::memory_order_seq_cst);
+    while (bits != 0) {
+      changed[i * WORD_BITS + __builtin_ctzll(bits)] = true;
+      bits &= bits - 1;
+    }
+  }
+
+  return changed;
+}
+
+POLYBAR_NS_END
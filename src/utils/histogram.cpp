@@ -0,0 +1,164 @@
+#include "utils/histogram.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+POLYBAR_NS
+
+namespace {
+  uint64_t nanoseconds(histogram::clock::duration d) {
+    return std::max<int64_t>(0, chrono::duration_cast<chrono::nanoseconds>(d).count());
+  }
+
+  string microseconds(histogram::clock::duration d) {
+    return to_string(chrono::duration_cast<chrono::microseconds>(d).count());
+  }
+}  // namespace
+
+histogram::scope::scope(histogram& h) : m_histogram(&h), m_start(clock::now()) {}
+
+histogram::scope::scope(scope&& other) : m_histogram(other.m_histogram), m_start(other.m_start) {
+  other.m_histogram = nullptr;
+}
+
+histogram::scope::~scope() {
+  if (m_histogram != nullptr) {
+    m_histogram->record(clock::now() - m_start);
+  }
+}
+
+/**
+ * Count a single duration
+ */
+void histogram::record(clock::duration d) {
+  auto ns = nanoseconds(d);
+
+  m_buckets[bucket_index(d)].fetch_add(1, std::memory_order_relaxed);
+  m_count.fetch_add(1, std::memory_order_relaxed);
+  m_sum.fetch_add(ns, std::memory_order_relaxed);
+
+  auto max = m_max.load(std::memory_order_relaxed);
+  while (ns > max && !m_max.compare_exchange_weak(max, ns, std::memory_order_relaxed)) {
+  }
+}
+
+/**
+ * Start measuring a duration, it is recorded once the returned object goes
+ * out of scope
+ */
+histogram::scope histogram::measure() {
+  return scope{*this};
+}
+
+void histogram::reset() {
+  for (auto&& bucket : m_buckets) {
+    bucket.store(0, std::memory_order_relaxed);
+  }
+  m_count.store(0, std::memory_order_relaxed);
+  m_sum.store(0, std::memory_order_relaxed);
+  m_max.store(0, std::memory_order_relaxed);
+}
+
+uint64_t histogram::count() const {
+  return m_count.load(std::memory_order_relaxed);
+}
+
+histogram::clock::duration histogram::sum() const {
+  return chrono::duration_cast<clock::duration>(chrono::nanoseconds(m_sum.load(std::memory_order_relaxed)));
+}
+
+histogram::clock::duration histogram::max() const {
+  return chrono::duration_cast<clock::duration>(chrono::nanoseconds(m_max.load(std::memory_order_relaxed)));
+}
+
+histogram::clock::duration histogram::mean() const {
+  auto n = count();
+  return n == 0 ? clock::duration::zero() : sum() / static_cast<clock::rep>(n);
+}
+
+/**
+ * Estimate the given percentile (0 to 1) of the recorded durations
+ *
+ * The result is the upper limit of the bucket the percentile falls into, but
+ * never more than the longest recorded duration.
+ */
+histogram::clock::duration histogram::percentile(double p) const {
+  auto n = count();
+  if (n == 0) {
+    return clock::duration::zero();
+  }
+
+  auto rank = static_cast<uint64_t>(std::ceil(std::min(std::max(p, 0.0), 1.0) * n));
+  uint64_t seen{0};
+
+  for (size_t i = 0; i < BUCKETS; i++) {
+    seen += bucket(i);
+    if (seen >= rank && seen > 0) {
+      return std::min(bucket_limit(i), max());
+    }
+  }
+
+  return max();
+}
+
+uint64_t histogram::bucket(size_t index) const {
+  return m_buckets[index].load(std::memory_order_relaxed);
+}
+
+/**
+ * Bucket the given duration is counted in
+ */
+size_t histogram::bucket_index(clock::duration d) {
+  auto us = nanoseconds(d) / 1000;
+  if (us == 0) {
+    return 0;
+  }
+
+  size_t index = 64 - __builtin_clzll(us);
+  return std::min(index, BUCKETS - 1);
+}
+
+/**
+ * Exclusive upper limit of the durations counted in the given bucket
+ *
+ * The last bucket has no limit, it also counts everything longer.
+ */
+histogram::clock::duration histogram::bucket_limit(size_t index) {
+  if (index + 1 >= BUCKETS) {
+    return clock::duration::max();
+  }
+  return chrono::duration_cast<clock::duration>(chrono::microseconds(1ULL << index));
+}
+
+/**
+ * Summary of the histogram as a JSON object
+ *
+ * All durations are given in microseconds. Only non-empty buckets are listed,
+ * each as a pair of its upper limit and its count.
+ */
+string histogram::to_json() const {
+  string buckets;
+  for (size_t i = 0; i < BUCKETS; i++) {
+    auto n = bucket(i);
+    if (n == 0) {
+      continue;
+    }
+    if (!buckets.empty()) {
+      buckets += ",";
+    }
+    buckets += "[" + (i + 1 < BUCKETS ? microseconds(bucket_limit(i)) : "null"s) + "," + to_string(n) + "]";
+  }
+
+  // clang-format off
+  return "{\"count\":" + to_string(count()) +
+    ",\"sum_us\":" + microseconds(sum()) +
+    ",\"mean_us\":" + microseconds(mean()) +
+    ",\"p50_us\":" + microseconds(percentile(0.5)) +
+    ",\"p90_us\":" + microseconds(percentile(0.9)) +
+    ",\"p99_us\":" + microseconds(percentile(0.99)) +
+    ",\"max_us\":" + microseconds(max()) +
+    ",\"buckets\":[" + buckets + "]}";
+  // clang-format on
+}
+
+POLYBAR_NS_END
@@ -0,0 +1,196 @@
+#include "utils/timer_wheel.hpp"
+
+#include <algorithm>
+#include <cassert>
+
+POLYBAR_NS
+
+constexpr unsigned int timer_wheel::LEVEL_BITS;
+constexpr unsigned int timer_wheel::SLOTS;
+constexpr unsigned int timer_wheel::LEVELS;
+
+namespace {
+  inline unsigned int digit(uint64_t tick, unsigned int level, unsigned int bits) {
+    return (tick >> (level * bits)) & ((1U << bits) - 1);
+  }
+}  // namespace
+
+/**
+ * Construct timer wheel with the given slot resolution
+ */
+timer_wheel::timer_wheel(clock::duration resolution, clock::time_point now)
+    : m_resolution(std::max(resolution, clock::duration{1})), m_current(floor_tick(now)) {}
+
+/**
+ * Schedule the timer with given id, replacing any previous deadline
+ *
+ * Deadlines in the past expire on the next call to expire()
+ */
+void timer_wheel::schedule(id_t id, clock::time_point deadline) {
+  cancel(id);
+  insert(id, std::max(ceil_tick(deadline), m_current));
+}
+
+/**
+ * Cancel the timer with given id
+ */
+bool timer_wheel::cancel(id_t id) {
+  auto it = m_entries.find(id);
+  if (it == m_entries.end()) {
+    return false;
+  }
+  unlink(id, it->second);
+  m_entries.erase(it);
+  return true;
+}
+
+bool timer_wheel::empty() const {
+  return m_entries.empty();
+}
+
+size_t timer_wheel::size() const {
+  return m_entries.size();
+}
+
+timer_wheel::clock::duration timer_wheel::resolution() const {
+  return m_resolution;
+}
+
+/**
+ * Get the time at which the next timer expires
+ *
+ * Only valid if the wheel is not empty
+ */
+timer_wheel::clock::time_point timer_wheel::next_expiry() const {
+  return clock::time_point{m_resolution * next_tick()};
+}
+
+/**
+ * Advance the wheel to the given time and return the ids of all
+ * expired timers, in order of expiry
+ *
+ * Expired timers are removed from the wheel
+ */
+vector<timer_wheel::id_t> timer_wheel::expire(clock::time_point now) {
+  vector<id_t> expired;
+  uint64_t target{floor_tick(now)};
+
+  while (!m_entries.empty()) {
+    uint64_t tick{next_tick()};
+    if (tick > target) {
+      break;
+    }
+
+    advance(tick);
+
+    auto& slot = m_slots[0][digit(tick, 0, LEVEL_BITS)];
+    for (auto&& id : slot) {
+      m_entries.erase(id);
+      expired.emplace_back(id);
+    }
+    slot.clear();
+  }
+
+  if (target > m_current) {
+    advance(target);
+  }
+
+  return expired;
+}
+
+uint64_t timer_wheel::floor_tick(clock::time_point point) const {
+  auto since_epoch = point.time_since_epoch();
+  if (since_epoch.count() <= 0) {
+    return 0;
+  }
+  return since_epoch / m_resolution;
+}
+
+uint64_t timer_wheel::ceil_tick(clock::time_point point) const {
+  auto since_epoch = point.time_since_epoch();
+  if (since_epoch.count() <= 0) {
+    return 0;
+  }
+  return (since_epoch + m_resolution - clock::duration{1}) / m_resolution;
+}
+
+/**
+ * Find the earliest deadline
+ *
+ * Timers on a lower level always expire before the ones on higher levels,
+ * and within a level the slots at or after the current position are ordered.
+ * Only the slots of level 0 map to a single tick.
+ */
+uint64_t timer_wheel::next_tick() const {
+  assert(!m_entries.empty());
+
+  for (unsigned int level = 0; level < LEVELS; level++) {
+    for (unsigned int slot = digit(m_current, level, LEVEL_BITS); slot < SLOTS; slot++) {
+      const auto& ids = m_slots[level][slot];
+      if (ids.empty()) {
+        continue;
+      }
+      uint64_t tick{m_entries.at(ids.front()).tick};
+      for (auto&& id : ids) {
+        tick = std::min(tick, m_entries.at(id).tick);
+      }
+      return tick;
+    }
+  }
+
+  // Unreachable as long as the entries and slots are in sync
+  return m_current;
+}
+
+/**
+ * Put the timer on the level of the most significant digit in which
+ * its deadline differs from the current tick
+ */
+void timer_wheel::insert(id_t id, uint64_t tick) {
+  uint64_t diff{tick ^ m_current};
+  unsigned int level{0};
+
+  while (level + 1 < LEVELS && (diff >> ((level + 1) * LEVEL_BITS)) != 0) {
+    level++;
+  }
+
+  unsigned int slot{digit(tick, level, LEVEL_BITS)};
+  m_slots[level][slot].emplace_back(id);
+  m_entries[id] = entry{tick, level, slot};
+}
+
+void timer_wheel::unlink(id_t id, const entry& e) {
+  auto& ids = m_slots[e.level][e.slot];
+  auto it = std::find(ids.begin(), ids.end(), id);
+  if (it != ids.end()) {
+    std::swap(*it, ids.back());
+    ids.pop_back();
+  }
+}
+
+/**
+ * Move the current position to the given tick
+ *
+ * The tick must not be past the earliest deadline. Timers in the slot
+ * matching the new position on each level now share a longer prefix
+ * with the current tick and are cascaded to the levels below.
+ */
+void timer_wheel::advance(uint64_t tick) {
+  m_current = tick;
+
+  for (unsigned int level = LEVELS - 1; level > 0; level--) {
+    auto& slot = m_slots[level][digit(tick, level, LEVEL_BITS)];
+    if (slot.empty()) {
+      continue;
+    }
+
+    vector<id_t> cascade;
+    std::swap(cascade, slot);
+
+    for (auto&& id : cascade) {
+      insert(id, m_entries.at(id).tick);
+    }
+  }
+}
+
+POLYBAR_NS_END
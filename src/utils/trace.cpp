@@ -0,0 +1,310 @@
+#include "utils/trace.hpp"
+
+#include <cxxabi.h>
+#include <unistd.h>
+
+#include <array>
+#include <condition_variable>
+#include <cstdlib>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include "errors.hpp"
+#include "utils/concurrency.hpp"
+
+POLYBAR_NS
+
+std::atomic<bool> g_tracing{false};
+
+namespace trace_util {
+  namespace {
+    struct event {
+      /**
+       * Either 'X' for a span or 'M' for the name of the thread
+       */
+      char phase{'X'};
+      const char* name{nullptr};
+      string arg;
+      uint64_t start{0};
+      uint64_t end{0};
+    };
+
+    /**
+     * Events of a single thread
+     *
+     * Only the owning thread adds events and only the flusher removes them.
+     */
+    struct ring_buffer {
+      static constexpr size_t SIZE{4096};
+
+      explicit ring_buffer(size_t tid) : tid(tid) {}
+
+      bool push(event&& e) {
+        auto h = head.load(std::memory_order_relaxed);
+        if (h - tail.load(std::memory_order_acquire) == SIZE) {
+          dropped.fetch_add(1, std::memory_order_relaxed);
+          return false;
+        }
+        events[h % SIZE] = move(e);
+        head.store(h + 1, std::memory_order_release);
+        return true;
+      }
+
+      template <typename Fn>
+      void drain(Fn&& fn) {
+        auto t = tail.load(std::memory_order_relaxed);
+        auto h = head.load(std::memory_order_acquire);
+        for (; t != h; t++) {
+          fn(events[t % SIZE]);
+          events[t % SIZE].arg.clear();
+        }
+        tail.store(t, std::memory_order_release);
+      }
+
+      const size_t tid;
+      std::array<event, SIZE> events{};
+      std::atomic<size_t> head{0};
+      std::atomic<size_t> tail{0};
+      std::atomic<size_t> dropped{0};
+    };
+
+    /**
+     * State of the trace that is being recorded
+     */
+    struct recorder {
+      std::ofstream out;
+      uint64_t origin{0};
+      bool first{true};
+
+      std::mutex lock;
+      std::condition_variable wakeup;
+      vector<shared_ptr<ring_buffer>> buffers;
+      std::atomic<size_t> generation{0};
+      bool stopping{false};
+      std::thread flusher;
+    };
+
+    recorder g_recorder;
+
+    thread_local string t_name;
+    thread_local shared_ptr<ring_buffer> t_buffer;
+    thread_local size_t t_generation{0};
+
+    string escape(const string& value) {
+      string escaped;
+      for (auto&& c : value) {
+        if (c == '"' || c == '\\') {
+          escaped += '\\';
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+          continue;
+        }
+        escaped += c;
+      }
+      return escaped;
+    }
+
+    /**
+     * Trace timestamps are microseconds, with nanosecond precision
+     */
+    string timestamp(uint64_t ns) {
+      auto fraction = to_string(1000 + ns % 1000).substr(1);
+      return to_string(ns / 1000) + "." + fraction;
+    }
+
+    /**
+     * Start the next entry of the event array
+     */
+    std::ofstream& next() {
+      auto& r = g_recorder;
+      r.out << (r.first ? "\n" : ",\n");
+      r.first = false;
+      return r.out;
+    }
+
+    void write(const ring_buffer& buffer, const event& e) {
+      auto& r = g_recorder;
+      next();
+
+      if (e.phase == 'M') {
+        r.out << R"({"name":"thread_name","ph":"M","pid":)" << getpid() << R"(,"tid":)" << buffer.tid
+              << R"(,"args":{"name":")" << escape(e.arg) << R"("}})";
+        return;
+      }
+
+      auto start = e.start > r.origin ? e.start - r.origin : 0;
+      auto duration = e.end > e.start ? e.end - e.start : 0;
+
+      r.out << R"({"name":")" << escape(e.name) << R"(","cat":"polybar","ph":"X","ts":)" << timestamp(start)
+            << R"(,"dur":)" << timestamp(duration) << R"(,"pid":)" << getpid() << R"(,"tid":)" << buffer.tid;
+      if (!e.arg.empty()) {
+        r.out << R"(,"args":{"detail":")" << escape(e.arg) << R"("})";
+      }
+      r.out << "}";
+    }
+
+    /**
+     * Write out all buffered events, has to be called with the lock held
+     */
+    void flush() {
+      for (auto&& buffer : g_recorder.buffers) {
+        buffer->drain([&](const event& e) { write(*buffer, e); });
+      }
+      g_recorder.out.flush();
+    }
+
+    /**
+     * Buffer of the calling thread, created on first use
+     */
+    ring_buffer* buffer() {
+      if (t_buffer == nullptr || t_generation != g_recorder.generation) {
+        auto b = make_shared<ring_buffer>(concurrency_util::thread_id(std::this_thread::get_id()));
+        {
+          std::lock_guard<std::mutex> guard(g_recorder.lock);
+          g_recorder.buffers.emplace_back(b);
+          t_generation = g_recorder.generation;
+        }
+        t_buffer = move(b);
+
+        if (!t_name.empty()) {
+          event e{};
+          e.phase = 'M';
+          e.arg = t_name;
+          t_buffer->push(move(e));
+        }
+      }
+      return t_buffer.get();
+    }
+  }  // namespace
+
+  /**
+   * Monotonic time in nanoseconds
+   */
+  uint64_t now() {
+    return chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now().time_since_epoch()).count();
+  }
+
+  /**
+   * Start recording a trace into the given file
+   */
+  void start(const string& path) {
+    auto& r = g_recorder;
+    std::lock_guard<std::mutex> guard(r.lock);
+
+    if (enabled()) {
+      throw application_error("A trace is already being recorded");
+    }
+
+    r.out.open(path, std::ios::out | std::ios::trunc);
+    if (!r.out) {
+      throw application_error("Failed to open trace file " + path);
+    }
+
+    r.out << "[";
+    r.first = true;
+    r.origin = now();
+    r.stopping = false;
+    r.generation++;
+    r.buffers.clear();
+
+    r.flusher = std::thread([&r] {
+      std::unique_lock<std::mutex> guard(r.lock);
+      while (!r.stopping) {
+        r.wakeup.wait_for(guard, chrono::milliseconds(50));
+        flush();
+      }
+    });
+
+    g_tracing = true;
+  }
+
+  /**
+   * Write out the remaining events and close the trace file
+   */
+  void stop() {
+    auto& r = g_recorder;
+    {
+      std::lock_guard<std::mutex> guard(r.lock);
+      if (!enabled()) {
+        return;
+      }
+      g_tracing = false;
+      r.stopping = true;
+    }
+
+    r.wakeup.notify_all();
+    r.flusher.join();
+
+    std::lock_guard<std::mutex> guard(r.lock);
+    flush();
+
+    size_t dropped{0};
+    for (auto&& buffer : r.buffers) {
+      dropped += buffer->dropped;
+    }
+    if (dropped > 0) {
+      next() << R"({"name":"dropped_events","ph":"i","s":"g","ts":)" << timestamp(now() - r.origin)
+             << R"(,"pid":)" << getpid() << R"(,"tid":0,"args":{"count":)" << dropped << "}}";
+    }
+
+    r.out << "\n]\n";
+    r.out.close();
+    r.buffers.clear();
+  }
+
+  /**
+   * Name the calling thread in the trace
+   */
+  void thread_name(const string& name) {
+    if (!enabled()) {
+      t_name = name;
+      return;
+    }
+
+    // A new buffer starts out with the name, set it first so that it is
+    // not written twice
+    bool fresh = t_buffer == nullptr || t_generation != g_recorder.generation;
+    t_name = name;
+    auto b = buffer();
+
+    if (!fresh) {
+      event e{};
+      e.phase = 'M';
+      e.arg = name;
+      b->push(move(e));
+    }
+  }
+
+  /**
+   * Add a span to the buffer of the calling thread
+   */
+  void record(const char* name, const string* arg, uint64_t start, uint64_t end) {
+    if (!enabled()) {
+      return;
+    }
+
+    event e{};
+    e.name = name;
+    if (arg != nullptr) {
+      e.arg = *arg;
+    }
+    e.start = start;
+    e.end = end;
+    buffer()->push(move(e));
+  }
+
+  string demangle(const char* name) {
+    int status{0};
+    char* demangled = abi::__cxa_demangle(name, nullptr, nullptr, &status);
+    if (demangled == nullptr) {
+      return name;
+    }
+
+    string result{demangled};
+    free(demangled);
+    return result;
+  }
+}  // namespace trace_util
+
+POLYBAR_NS_END
@@ -62,9 +62,9 @@ void background_manager::deactivate() {
 
 void background_manager::activate() {
   if(!m_visual) {
-    m_log.trace("background_manager: Finding root visual");
+    POLYBAR_LOG_TRACE(m_log, "background_manager: Finding root visual");
     m_visual = m_connection.visual_type_for_id(m_connection.screen(), m_connection.screen()->root_visual);
-    m_log.trace("background_manager: Got root visual with depth %d", m_connection.screen()->root_depth);
+    POLYBAR_LOG_TRACE(m_log, "background_manager: Got root visual with depth %d", m_connection.screen()->root_depth);
   }
 }
 
@@ -73,7 +73,7 @@ void background_manager::free_resources() {
 }
 
 void background_manager::fetch_root_pixmap() {
-  m_log.trace("background_manager: Fetching pixmap");
+  POLYBAR_LOG_TRACE(m_log, "background_manager: Fetching pixmap");
 
   int pixmap_depth;
   xcb_pixmap_t pixmap;
@@ -81,13 +81,17 @@ void background_manager::fetch_root_pixmap() {
 
   try {
     if (!m_connection.root_pixmap(&pixmap, &pixmap_depth, &pixmap_geom)) {
-      return m_log.warn("background_manager: Failed to get root pixmap, default to black (is there a wallpaper?)");
+      POLYBAR_LOG_WARN(m_log,
+          "background_manager: Failed to get root pixmap, default to black (is there a wallpaper?)");
+      return;
     };
-    m_log.trace("background_manager: root pixmap (%d:%d) %dx%d+%d+%d", pixmap, pixmap_depth,
+    POLYBAR_LOG_TRACE(m_log, "background_manager: root pixmap (%d:%d) %dx%d+%d+%d", pixmap, pixmap_depth,
                 pixmap_geom.width, pixmap_geom.height, pixmap_geom.x, pixmap_geom.y);
 
     if (pixmap_depth == 1 && pixmap_geom.width == 1 && pixmap_geom.height == 1) {
-      return m_log.err("background_manager: Cannot find root pixmap, try a different tool to set the desktop background");
+      POLYBAR_LOG_ERR(m_log,
+          "background_manager: Cannot find root pixmap, try a different tool to set the desktop background");
+      return;
     }
 
     for (auto it = m_slices.begin(); it != m_slices.end(); ) {
@@ -103,7 +107,8 @@ void background_manager::fetch_root_pixmap() {
       auto src_y = math_util::cap(translated->dst_y, pixmap_geom.y, int16_t(pixmap_geom.y + pixmap_geom.height));
       auto w = math_util::cap(slice->m_rect.width, uint16_t(0), uint16_t(pixmap_geom.width - (src_x - pixmap_geom.x)));
       auto h = math_util::cap(slice->m_rect.height, uint16_t(0), uint16_t(pixmap_geom.height - (src_y - pixmap_geom.y)));
-      m_log.trace("background_manager: Copying from root pixmap (%d:%d) %dx%d+%d+%d", pixmap, pixmap_depth, w, h, src_x, src_y);
+      POLYBAR_LOG_TRACE(m_log, "background_manager: Copying from root pixmap (%d:%d) %dx%d+%d+%d", pixmap, pixmap_depth,
+          w, h, src_x, src_y);
       m_connection.copy_area_checked(pixmap, slice->m_pixmap, slice->m_gcontext, src_x, src_y, 0, 0, w, h);
 
       it++;
@@ -111,12 +116,12 @@ void background_manager::fetch_root_pixmap() {
 
     // if there are no active slices, deactivate
     if (m_slices.empty()) {
-      m_log.trace("background_manager: deactivating because there are no slices to observe");
+      POLYBAR_LOG_TRACE(m_log, "background_manager: deactivating because there are no slices to observe");
       deactivate();
     }
 
   } catch(const exception& err) {
-    m_log.err("background_manager: Failed to copy slice of root pixmap (%s)", err.what());
+    POLYBAR_LOG_ERR(m_log, "background_manager: Failed to copy slice of root pixmap (%s)", err.what());
     throw;
   }
 
@@ -164,13 +169,13 @@ bg_slice::~bg_slice() {
 
 void bg_slice::allocate_resources(const logger& log, xcb_visualtype_t* visual) {
   if(m_pixmap == XCB_NONE) {
-    log.trace("background_manager: Allocating pixmap");
+    POLYBAR_LOG_TRACE(log, "background_manager: Allocating pixmap");
     m_pixmap = m_connection.generate_id();
     m_connection.create_pixmap(m_connection.screen()->root_depth, m_pixmap, m_window, m_rect.width, m_rect.height);
   }
 
   if(m_gcontext == XCB_NONE) {
-    log.trace("background_manager: Allocating graphics context");
+    POLYBAR_LOG_TRACE(log, "background_manager: Allocating graphics context");
     auto black_pixel = m_connection.screen()->black_pixel;
     unsigned int mask = XCB_GC_GRAPHICS_EXPOSURES | XCB_GC_FOREGROUND | XCB_GC_BACKGROUND;
     unsigned int value_list[3] = {black_pixel, black_pixel, 0};
@@ -179,7 +184,7 @@ void bg_slice::allocate_resources(const logger& log, xcb_visualtype_t* visual) {
   }
 
   if(!m_surface) {
-    log.trace("background_manager: Allocating cairo surface");
+    POLYBAR_LOG_TRACE(log, "background_manager: Allocating cairo surface");
     m_surface = make_unique<cairo::xcb_surface>(m_connection, m_pixmap, visual, m_rect.width, m_rect.height);
   }
 
@@ -0,0 +1,120 @@
+#include "x11/extensions/present.hpp"
+
+#include <cstdlib>
+
+#include "errors.hpp"
+#include "x11/connection.hpp"
+
+POLYBAR_NS
+
+namespace present_util {
+  /**
+   * Query for the Present extension
+   *
+   * \returns true if the server supports it
+   */
+  bool query_extension(connection& conn) {
+    auto ext = xcb_get_extension_data(conn, &xcb_present_id);
+    if (ext == nullptr || !ext->present) {
+      return false;
+    }
+
+    auto reply =
+        xcb_present_query_version_reply(conn, xcb_present_query_version(conn, XCB_PRESENT_MAJOR_VERSION, 0), nullptr);
+    bool supported = reply != nullptr && reply->major_version >= 1;
+    free(reply);
+    return supported;
+  }
+}  // namespace present_util
+
+/**
+ * Subscribe to the presentation events of the given window
+ */
+present_window::present_window(connection& conn, xcb_window_t window) : m_connection(conn), m_window(window) {
+  m_eid = m_connection.generate_id();
+  xcb_present_select_input(
+      m_connection, m_eid, m_window, XCB_PRESENT_EVENT_MASK_COMPLETE_NOTIFY | XCB_PRESENT_EVENT_MASK_IDLE_NOTIFY);
+  m_events = xcb_register_for_special_xge(m_connection, &xcb_present_id, m_eid, nullptr);
+
+  if (m_events == nullptr) {
+    throw application_error("Failed to register for Present events");
+  }
+}
+
+present_window::~present_window() {
+  xcb_present_select_input(m_connection, m_eid, m_window, XCB_PRESENT_EVENT_MASK_NO_EVENT);
+  xcb_unregister_for_special_event(m_connection, m_events);
+}
+
+/**
+ * Show the whole pixmap on the window at the next vertical blank
+ *
+ * Does not wait for the previous presentation, callers keep at most one
+ * frame in flight by only drawing the next one once done() returns true.
+ */
+void present_window::present(xcb_pixmap_t pixmap) {
+  xcb_present_pixmap(m_connection, m_window, pixmap, ++m_serial, XCB_NONE, XCB_NONE, 0, 0, XCB_NONE, XCB_NONE,
+      XCB_NONE, XCB_PRESENT_OPTION_NONE, 0, 0, 0, 0, nullptr);
+  m_busy[pixmap]++;
+}
+
+/**
+ * Check if the newest presentation was executed
+ */
+bool present_window::done() {
+  while (process()) {
+  }
+
+  return m_completed == m_serial;
+}
+
+/**
+ * Check if the server is done reading from the pixmap
+ */
+bool present_window::idle(xcb_pixmap_t pixmap) {
+  while (process()) {
+  }
+
+  auto it = m_busy.find(pixmap);
+  return it == m_busy.end() || it->second == 0;
+}
+
+/**
+ * Handle the next pending event
+ *
+ * \returns false if there was no event
+ */
+bool present_window::process() {
+  auto evt = xcb_poll_for_special_event(m_connection, m_events);
+  if (evt == nullptr) {
+    return false;
+  }
+
+  handle(evt);
+  free(evt);
+  return true;
+}
+
+void present_window::handle(const xcb_generic_event_t* evt) {
+  switch (reinterpret_cast<const xcb_ge_generic_event_t*>(evt)->event_type) {
+    case XCB_PRESENT_COMPLETE_NOTIFY: {
+      auto complete = reinterpret_cast<const xcb_present_complete_notify_event_t*>(evt);
+      if (complete->kind == XCB_PRESENT_COMPLETE_KIND_PIXMAP) {
+        m_completed = complete->serial;
+      }
+      break;
+    }
+    case XCB_PRESENT_IDLE_NOTIFY: {
+      auto idle = reinterpret_cast<const xcb_present_idle_notify_event_t*>(evt);
+      auto it = m_busy.find(idle->pixmap);
+      if (it != m_busy.end() && it->second > 0) {
+        it->second--;
+      }
+      break;
+    }
+    default:
+      break;
+  }
+}
+
+POLYBAR_NS_END
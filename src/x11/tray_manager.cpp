@@ -41,19 +41,20 @@ POLYBAR_NS
 /**
  * Create instance
  */
-tray_manager::make_type tray_manager::make() {
+tray_manager::make_type tray_manager::make(eventloop& loop) {
   return factory_util::unique<tray_manager>(
-      connection::make(), signal_emitter::make(), logger::make(), background_manager::make());
+      connection::make(), signal_emitter::make(), logger::make(), background_manager::make(), loop);
 }
 
-tray_manager::tray_manager(connection& conn, signal_emitter& emitter, const logger& logger, background_manager& back)
-    : m_connection(conn), m_sig(emitter), m_log(logger), m_background_manager(back) {
+tray_manager::tray_manager(
+    connection& conn, signal_emitter& emitter, const logger& logger, background_manager& back, eventloop& loop)
+    : m_connection(conn), m_sig(emitter), m_log(logger), m_background_manager(back), m_loop(loop) {
   m_connection.attach_sink(this, SINK_PRIORITY_TRAY);
 }
 
 tray_manager::~tray_manager() {
-  if (m_delaythread.joinable()) {
-    m_delaythread.join();
+  if (m_notify_timer) {
+    m_loop.remove(m_notify_timer);
   }
   m_connection.detach_sink(this, SINK_PRIORITY_TRAY);
   deactivate();
@@ -67,7 +68,8 @@ void tray_manager::setup(const bar_settings& bar_opts) {
   try {
     position = conf.get(bs, "tray-position");
   } catch (const key_error& err) {
-    return m_log.info("Disabling tray manager (reason: missing `tray-position`)");
+    POLYBAR_LOG_INFO(m_log, "Disabling tray manager (reason: missing `tray-position`)");
+    return;
   }
 
   if (position == "left") {
@@ -77,7 +79,8 @@ void tray_manager::setup(const bar_settings& bar_opts) {
   } else if (position == "center") {
     m_opts.align = alignment::CENTER;
   } else if (position != "none") {
-    return m_log.err("Disabling tray manager (reason: Invalid position \"" + position + "\")");
+    POLYBAR_LOG_ERR(m_log, "Disabling tray manager (reason: Invalid position \"%s\")", position);
+    return;
   } else {
     return;
   }
@@ -124,14 +127,15 @@ void tray_manager::setup(const bar_settings& bar_opts) {
   }
 
   if (conf.has(bs, "tray-transparent")) {
-    m_log.warn("tray-transparent is deprecated, the tray always uses pseudo-transparency. Please remove it.");
+    POLYBAR_LOG_WARN(m_log,
+        "tray-transparent is deprecated, the tray always uses pseudo-transparency. Please remove it.");
   }
 
   // Set user-defined background color
   m_opts.background = conf.get(bs, "tray-background", bar_opts.background);
 
   if (m_opts.background.alpha_i() != 255) {
-    m_log.trace("tray: enable transparency");
+    POLYBAR_LOG_TRACE(m_log, "tray: enable transparency");
     m_opts.transparent = true;
   }
 
@@ -189,7 +193,7 @@ void tray_manager::activate() {
     return;
   }
 
-  m_log.info("Activating tray manager");
+  POLYBAR_LOG_INFO(m_log, "Activating tray manager");
   m_activated = true;
   m_opts.running = true;
 
@@ -202,8 +206,8 @@ void tray_manager::activate() {
     set_wm_hints();
     set_tray_colors();
   } catch (const exception& err) {
-    m_log.err(err.what());
-    m_log.err("Cannot activate tray manager... failed to setup window");
+    POLYBAR_LOG_ERR(m_log, "%s", err.what());
+    POLYBAR_LOG_ERR(m_log, "Cannot activate tray manager... failed to setup window");
     m_activated = false;
     return;
   }
@@ -235,22 +239,22 @@ void tray_manager::deactivate(bool clear_selection) {
     return;
   }
 
-  m_log.info("Deactivating tray manager");
+  POLYBAR_LOG_INFO(m_log, "Deactivating tray manager");
   m_activated = false;
   m_opts.running = false;
 
   m_sig.detach(this);
 
   if (!m_connection.connection_has_error() && clear_selection && m_acquired_selection) {
-    m_log.trace("tray: Unset selection owner");
+    POLYBAR_LOG_TRACE(m_log, "tray: Unset selection owner");
     m_connection.set_selection_owner(XCB_NONE, m_atom, XCB_CURRENT_TIME);
   }
 
-  m_log.trace("tray: Unembed clients");
+  POLYBAR_LOG_TRACE(m_log, "tray: Unembed clients");
   m_clients.clear();
 
   if (m_tray) {
-    m_log.trace("tray: Destroy window");
+    POLYBAR_LOG_TRACE(m_log, "tray: Destroy window");
     m_connection.destroy_window(m_tray);
   }
   m_context.reset();
@@ -292,17 +296,17 @@ void tray_manager::reconfigure() {
     try {
       reconfigure_clients();
     } catch (const exception& err) {
-      m_log.err("Failed to reconfigure tray clients (%s)", err.what());
+      POLYBAR_LOG_ERR(m_log, "Failed to reconfigure tray clients (%s)", err.what());
     }
     try {
       reconfigure_window();
     } catch (const exception& err) {
-      m_log.err("Failed to reconfigure tray window (%s)", err.what());
+      POLYBAR_LOG_ERR(m_log, "Failed to reconfigure tray window (%s)", err.what());
     }
     try {
       reconfigure_bg();
     } catch (const exception& err) {
-      m_log.err("Failed to reconfigure tray background (%s)", err.what());
+      POLYBAR_LOG_ERR(m_log, "Failed to reconfigure tray background (%s)", err.what());
     }
 
     m_opts.configured_slots = mapped_clients();
@@ -318,7 +322,8 @@ void tray_manager::reconfigure() {
  * Reconfigure container window
  */
 void tray_manager::reconfigure_window() {
-  m_log.trace("tray: Reconfigure window (mapped=%i, clients=%i)", static_cast<bool>(m_mapped), m_clients.size());
+  POLYBAR_LOG_TRACE(m_log, "tray: Reconfigure window (mapped=%i, clients=%i)", static_cast<bool>(m_mapped),
+      m_clients.size());
 
   if (!m_tray) {
     return;
@@ -326,10 +331,10 @@ void tray_manager::reconfigure_window() {
 
   auto clients = mapped_clients();
   if (!clients && m_mapped) {
-    m_log.trace("tray: Reconfigure window / unmap");
+    POLYBAR_LOG_TRACE(m_log, "tray: Reconfigure window / unmap");
     m_connection.unmap_window_checked(m_tray);
   } else if (clients && !m_mapped && !m_hidden) {
-    m_log.trace("tray: Reconfigure window / map");
+    POLYBAR_LOG_TRACE(m_log, "tray: Reconfigure window / map");
     m_connection.map_window_checked(m_tray);
   }
 
@@ -342,7 +347,7 @@ void tray_manager::reconfigure_window() {
   }
 
   if (width > 0) {
-    m_log.trace("tray: New window values, width=%d, x=%d", width, x);
+    POLYBAR_LOG_TRACE(m_log, "tray: New window values, width=%d, x=%d", width, x);
 
     unsigned int mask = 0;
     unsigned int values[7];
@@ -362,7 +367,7 @@ void tray_manager::reconfigure_window() {
  * Reconfigure clients
  */
 void tray_manager::reconfigure_clients() {
-  m_log.trace("tray: Reconfigure clients");
+  POLYBAR_LOG_TRACE(m_log, "tray: Reconfigure clients");
 
   int x = m_opts.spacing;
 
@@ -388,15 +393,17 @@ void tray_manager::reconfigure_bg(bool realloc) {
     return;
   };
 
-  m_log.trace("tray: Reconfigure bg (realloc=%i)", realloc);
+  POLYBAR_LOG_TRACE(m_log, "tray: Reconfigure bg (realloc=%i)", realloc);
 
   if (!m_context) {
-    return m_log.err("tray: no context for drawing the background");
+    POLYBAR_LOG_ERR(m_log, "tray: no context for drawing the background");
+    return;
   }
 
   cairo::surface* surface = m_bg_slice->get_surface();
   if (!surface) {
-    return m_log.err("tray: no root surface");
+    POLYBAR_LOG_ERR(m_log, "tray: no root surface");
+    return;
   }
 
   m_context->clear();
@@ -417,7 +424,7 @@ void tray_manager::refresh_window() {
 
   std::lock_guard<mutex> lock(m_mtx, std::adopt_lock);
 
-  m_log.trace("tray: Refreshing window");
+  POLYBAR_LOG_TRACE(m_log, "tray: Refreshing window");
 
   auto width = calculate_w();
   auto height = calculate_h();
@@ -439,7 +446,7 @@ void tray_manager::refresh_window() {
         client->clear_window();
       }
     } catch (const std::exception& e) {
-      m_log.err("Failed to clear tray client %s '%s' (%s)", m_connection.id(client->window()),
+      POLYBAR_LOG_ERR(m_log, "Failed to clear tray client %s '%s' (%s)", m_connection.id(client->window()),
           ewmh_util::get_wm_name(client->window()), e.what());
     }
   }
@@ -457,7 +464,7 @@ void tray_manager::refresh_window() {
  * Redraw window
  */
 void tray_manager::redraw_window(bool realloc_bg) {
-  m_log.info("Redraw tray container (id=%s)", m_connection.id(m_tray));
+  POLYBAR_LOG_INFO(m_log, "Redraw tray container (id=%s)", m_connection.id(m_tray));
   reconfigure_bg(realloc_bg);
   refresh_window();
 }
@@ -466,7 +473,7 @@ void tray_manager::redraw_window(bool realloc_bg) {
  * Find the systray selection atom
  */
 void tray_manager::query_atom() {
-  m_log.trace("tray: Find systray selection atom for the default screen");
+  POLYBAR_LOG_TRACE(m_log, "tray: Find systray selection atom for the default screen");
   string name{"_NET_SYSTEM_TRAY_S" + to_string(m_connection.default_screen())};
   auto reply = m_connection.intern_atom(false, name.length(), name.c_str());
   m_atom = reply.atom();
@@ -476,7 +483,7 @@ void tray_manager::query_atom() {
  * Create tray window
  */
 void tray_manager::create_window() {
-  m_log.trace("tray: Create tray window");
+  POLYBAR_LOG_TRACE(m_log, "tray: Create tray window");
 
   // clang-format off
   auto win = winspec(m_connection, m_tray)
@@ -496,7 +503,7 @@ void tray_manager::create_window() {
   }
 
   m_tray = win << cw_flush(true);
-  m_log.info("Tray window: %s", m_connection.id(m_tray));
+  POLYBAR_LOG_INFO(m_log, "Tray window: %s", m_connection.id(m_tray));
 
   // activate the background manager if we have transparency
   if (m_opts.transparent) {
@@ -542,7 +549,8 @@ void tray_manager::create_bg(bool realloc) {
       m_pixmap = m_connection.generate_id();
       m_connection.create_pixmap_checked(m_connection.screen()->root_depth, m_pixmap, m_tray, w, h);
     } catch (const exception& err) {
-      return m_log.err("Failed to create pixmap for tray background (err: %s)", err.what());
+      POLYBAR_LOG_ERR(m_log, "Failed to create pixmap for tray background (err: %s)", err.what());
+      return;
     }
   }
 
@@ -556,7 +564,8 @@ void tray_manager::create_bg(bool realloc) {
       m_gc = m_connection.generate_id();
       m_connection.create_gc_checked(m_gc, m_pixmap, mask, values);
     } catch (const exception& err) {
-      return m_log.err("Failed to create gcontext for tray background (err: %s)", err.what());
+      POLYBAR_LOG_ERR(m_log, "Failed to create gcontext for tray background (err: %s)", err.what());
+      return;
     }
   }
 
@@ -564,7 +573,8 @@ void tray_manager::create_bg(bool realloc) {
     xcb_visualtype_t* visual =
         m_connection.visual_type_for_id(m_connection.screen(), m_connection.screen()->root_visual);
     if (!visual) {
-      return m_log.err("Failed to get root visual for tray background");
+      POLYBAR_LOG_ERR(m_log, "Failed to get root visual for tray background");
+      return;
     }
     m_surface = make_unique<cairo::xcb_surface>(m_connection, m_pixmap, visual, w, h);
   }
@@ -579,7 +589,7 @@ void tray_manager::create_bg(bool realloc) {
   try {
     m_connection.change_window_attributes_checked(m_tray, XCB_CW_BACK_PIXMAP, &m_pixmap);
   } catch (const exception& err) {
-    m_log.err("Failed to set tray window back pixmap (%s)", err.what());
+    POLYBAR_LOG_ERR(m_log, "Failed to set tray window back pixmap (%s)", err.what());
   }
 }
 
@@ -592,7 +602,7 @@ void tray_manager::restack_window() {
   }
 
   try {
-    m_log.trace("tray: Restacking tray window");
+    POLYBAR_LOG_TRACE(m_log, "tray: Restacking tray window");
 
     unsigned int mask = 0;
     unsigned int values[7];
@@ -605,7 +615,7 @@ void tray_manager::restack_window() {
     m_connection.configure_window_checked(m_tray, mask, values);
   } catch (const exception& err) {
     auto id = m_connection.id(m_opts.sibling);
-    m_log.err("tray: Failed to put tray above %s in the stack (%s)", id, err.what());
+    POLYBAR_LOG_ERR(m_log, "tray: Failed to put tray above %s in the stack (%s)", id, err.what());
   }
 }
 
@@ -616,26 +626,26 @@ void tray_manager::set_wm_hints() {
   const unsigned int visual{m_connection.screen()->root_visual};
   const unsigned int orientation{_NET_SYSTEM_TRAY_ORIENTATION_HORZ};
 
-  m_log.trace("bar: Set window WM_NAME / WM_CLASS");
+  POLYBAR_LOG_TRACE(m_log, "bar: Set window WM_NAME / WM_CLASS");
   icccm_util::set_wm_name(m_connection, m_tray, TRAY_WM_NAME, 19_z, TRAY_WM_CLASS, 12_z);
 
-  m_log.trace("tray: Set window WM_PROTOCOLS");
+  POLYBAR_LOG_TRACE(m_log, "tray: Set window WM_PROTOCOLS");
   icccm_util::set_wm_protocols(m_connection, m_tray, {WM_DELETE_WINDOW, WM_TAKE_FOCUS});
 
-  m_log.trace("tray: Set window _NET_WM_WINDOW_TYPE");
+  POLYBAR_LOG_TRACE(m_log, "tray: Set window _NET_WM_WINDOW_TYPE");
   ewmh_util::set_wm_window_type(m_tray, {_NET_WM_WINDOW_TYPE_DOCK, _NET_WM_WINDOW_TYPE_NORMAL});
 
-  m_log.trace("tray: Set window _NET_WM_STATE");
+  POLYBAR_LOG_TRACE(m_log, "tray: Set window _NET_WM_STATE");
   ewmh_util::set_wm_state(m_tray, {_NET_WM_STATE_SKIP_TASKBAR});
 
-  m_log.trace("tray: Set window _NET_WM_PID");
+  POLYBAR_LOG_TRACE(m_log, "tray: Set window _NET_WM_PID");
   ewmh_util::set_wm_pid(m_tray);
 
-  m_log.trace("tray: Set window _NET_SYSTEM_TRAY_VISUAL");
+  POLYBAR_LOG_TRACE(m_log, "tray: Set window _NET_SYSTEM_TRAY_VISUAL");
   xcb_change_property(
       m_connection, XCB_PROP_MODE_REPLACE, m_tray, _NET_SYSTEM_TRAY_VISUAL, XCB_ATOM_VISUALID, 32, 1, &visual);
 
-  m_log.trace("tray: Set window _NET_SYSTEM_TRAY_ORIENTATION");
+  POLYBAR_LOG_TRACE(m_log, "tray: Set window _NET_SYSTEM_TRAY_ORIENTATION");
   xcb_change_property(m_connection, XCB_PROP_MODE_REPLACE, m_tray, _NET_SYSTEM_TRAY_ORIENTATION,
       _NET_SYSTEM_TRAY_ORIENTATION, 32, 1, &orientation);
 }
@@ -644,7 +654,7 @@ void tray_manager::set_wm_hints() {
  * Set color atom used by clients when determing icon theme
  */
 void tray_manager::set_tray_colors() {
-  m_log.trace("tray: Set _NET_SYSTEM_TRAY_COLORS to %x", m_opts.background);
+  POLYBAR_LOG_TRACE(m_log, "tray: Set _NET_SYSTEM_TRAY_COLORS to %x", static_cast<uint32_t>(m_opts.background));
 
   auto r = m_opts.background.red_i();
   auto g = m_opts.background.green_i();
@@ -675,13 +685,13 @@ void tray_manager::acquire_selection() {
   }
 
   if (owner == m_tray) {
-    m_log.trace("tray: Already managing the systray selection");
+    POLYBAR_LOG_TRACE(m_log, "tray: Already managing the systray selection");
     m_acquired_selection = true;
   } else if ((m_othermanager = owner) != XCB_NONE) {
-    m_log.warn("Systray selection already managed (window=%s)", m_connection.id(owner));
+    POLYBAR_LOG_WARN(m_log, "Systray selection already managed (window=%s)", m_connection.id(owner));
     track_selection_owner(m_othermanager);
   } else {
-    m_log.trace("tray: Change selection owner to %s", m_connection.id(m_tray));
+    POLYBAR_LOG_TRACE(m_log, "tray: Change selection owner to %s", m_connection.id(m_tray));
     m_connection.set_selection_owner_checked(m_tray, m_atom, XCB_CURRENT_TIME);
     if (m_connection.get_selection_owner_unchecked(m_atom)->owner != m_tray) {
       throw application_error("Failed to get control of the systray selection");
@@ -695,7 +705,7 @@ void tray_manager::acquire_selection() {
  */
 void tray_manager::notify_clients() {
   if (m_activated) {
-    m_log.info("Notifying pending tray clients");
+    POLYBAR_LOG_INFO(m_log, "Notifying pending tray clients");
     auto message = m_connection.make_client_message(MANAGER, m_connection.root());
     message->data.data32[0] = XCB_CURRENT_TIME;
     message->data.data32[1] = m_atom;
@@ -706,15 +716,16 @@ void tray_manager::notify_clients() {
 
 /**
  * Send delayed notification to pending clients
+ *
+ * Runs on the main event loop, together with the X event handling
  */
 void tray_manager::notify_clients_delayed() {
-  if (m_delaythread.joinable()) {
-    m_delaythread.join();
+  auto when = eventloop::clock::now() + 1s;
+  if (m_notify_timer) {
+    m_loop.reschedule(m_notify_timer, when);
+  } else {
+    m_notify_timer = m_loop.add_timer(when, [this] { notify_clients(); });
   }
-  m_delaythread = thread([this]() {
-    this_thread::sleep_for(1s);
-    notify_clients();
-  });
 }
 
 /**
@@ -723,7 +734,7 @@ void tray_manager::notify_clients_delayed() {
  */
 void tray_manager::track_selection_owner(xcb_window_t owner) {
   if (owner != XCB_NONE) {
-    m_log.trace("tray: Listen for events on the new selection window");
+    POLYBAR_LOG_TRACE(m_log, "tray: Listen for events on the new selection window");
     const unsigned int mask{XCB_CW_EVENT_MASK};
     const unsigned int values[]{XCB_EVENT_MASK_STRUCTURE_NOTIFY};
     m_connection.change_window_attributes(owner, mask, values);
@@ -734,16 +745,17 @@ void tray_manager::track_selection_owner(xcb_window_t owner) {
  * Process client docking request
  */
 void tray_manager::process_docking_request(xcb_window_t win) {
-  m_log.info("Processing docking request from '%s' (%s)", ewmh_util::get_wm_name(win), m_connection.id(win));
+  POLYBAR_LOG_INFO(m_log, "Processing docking request from '%s' (%s)", ewmh_util::get_wm_name(win),
+      m_connection.id(win));
 
   m_clients.emplace_back(factory_util::shared<tray_client>(m_connection, win, m_opts.width, m_opts.height));
   auto& client = m_clients.back();
 
   try {
-    m_log.trace("tray: Get client _XEMBED_INFO");
+    POLYBAR_LOG_TRACE(m_log, "tray: Get client _XEMBED_INFO");
     xembed::query(m_connection, win, client->xembed());
   } catch (const std::exception& err) {
-    m_log.err("Failed to query _XEMBED_INFO, removing client... (%s)", err.what());
+    POLYBAR_LOG_ERR(m_log, "Failed to query _XEMBED_INFO, removing client... (%s)", err.what());
     remove_client(win, true);
     return;
   }
@@ -752,29 +764,29 @@ void tray_manager::process_docking_request(xcb_window_t win) {
     const unsigned int mask = XCB_CW_EVENT_MASK;
     const unsigned int values[]{XCB_EVENT_MASK_PROPERTY_CHANGE | XCB_EVENT_MASK_STRUCTURE_NOTIFY};
 
-    m_log.trace("tray: Update client window");
+    POLYBAR_LOG_TRACE(m_log, "tray: Update client window");
     m_connection.change_window_attributes_checked(client->window(), mask, values);
 
-    m_log.trace("tray: Configure client size");
+    POLYBAR_LOG_TRACE(m_log, "tray: Configure client size");
     client->reconfigure(0, 0);
 
-    m_log.trace("tray: Add client window to the save set");
+    POLYBAR_LOG_TRACE(m_log, "tray: Add client window to the save set");
     m_connection.change_save_set_checked(XCB_SET_MODE_INSERT, client->window());
 
-    m_log.trace("tray: Reparent client");
+    POLYBAR_LOG_TRACE(m_log, "tray: Reparent client");
     m_connection.reparent_window_checked(
         client->window(), m_tray, calculate_client_x(client->window()), calculate_client_y());
 
-    m_log.trace("tray: Send embbeded notification to client");
+    POLYBAR_LOG_TRACE(m_log, "tray: Send embbeded notification to client");
     xembed::notify_embedded(m_connection, client->window(), m_tray, client->xembed()->version);
 
     if (client->xembed()->flags & XEMBED_MAPPED) {
-      m_log.trace("tray: Map client");
+      POLYBAR_LOG_TRACE(m_log, "tray: Map client");
       m_connection.map_window_checked(client->window());
     }
 
   } catch (const std::exception& err) {
-    m_log.err("Failed to setup tray client removing... (%s)", err.what());
+    POLYBAR_LOG_ERR(m_log, "Failed to setup tray client removing... (%s)", err.what());
     remove_client(win, false);
   }
 }
@@ -908,7 +920,7 @@ void tray_manager::handle(const evt::expose& evt) {
  */
 void tray_manager::handle(const evt::visibility_notify& evt) {
   if (m_activated && !m_clients.empty()) {
-    m_log.trace("tray: Received visibility_notify for %s", m_connection.id(evt->window));
+    POLYBAR_LOG_TRACE(m_log, "tray: Received visibility_notify for %s", m_connection.id(evt->window));
     reconfigure_window();
   }
 }
@@ -920,18 +932,18 @@ void tray_manager::handle(const evt::client_message& evt) {
   if (!m_activated) {
     return;
   } else if (evt->type == WM_PROTOCOLS && evt->data.data32[0] == WM_DELETE_WINDOW && evt->window == m_tray) {
-    m_log.notice("Received WM_DELETE");
+    POLYBAR_LOG_NOTICE(m_log, "Received WM_DELETE");
     m_tray = 0;
     deactivate();
   } else if (evt->type == _NET_SYSTEM_TRAY_OPCODE && evt->format == 32) {
-    m_log.trace("tray: Received client_message");
+    POLYBAR_LOG_TRACE(m_log, "tray: Received client_message");
 
     if (SYSTEM_TRAY_REQUEST_DOCK == evt->data.data32[1]) {
       if (!is_embedded(evt->data.data32[2])) {
         process_docking_request(evt->data.data32[2]);
       } else {
         auto win = evt->data.data32[2];
-        m_log.warn("Tray client %s already embedded, ignoring request...", m_connection.id(win));
+        POLYBAR_LOG_WARN(m_log, "Tray client %s already embedded, ignoring request...", m_connection.id(win));
       }
     }
   }
@@ -947,10 +959,10 @@ void tray_manager::handle(const evt::client_message& evt) {
 void tray_manager::handle(const evt::configure_request& evt) {
   if (m_activated && is_embedded(evt->window)) {
     try {
-      m_log.trace("tray: Client configure request %s", m_connection.id(evt->window));
+      POLYBAR_LOG_TRACE(m_log, "tray: Client configure request %s", m_connection.id(evt->window));
       find_client(evt->window)->configure_notify(calculate_client_x(evt->window), calculate_client_y());
     } catch (const xpp::x::error::window& err) {
-      m_log.err("Failed to reconfigure tray client, removing... (%s)", err.what());
+      POLYBAR_LOG_ERR(m_log, "Failed to reconfigure tray client, removing... (%s)", err.what());
       remove_client(evt->window);
     }
   }
@@ -962,10 +974,10 @@ void tray_manager::handle(const evt::configure_request& evt) {
 void tray_manager::handle(const evt::resize_request& evt) {
   if (m_activated && is_embedded(evt->window)) {
     try {
-      m_log.trace("tray: Received resize_request for client %s", m_connection.id(evt->window));
+      POLYBAR_LOG_TRACE(m_log, "tray: Received resize_request for client %s", m_connection.id(evt->window));
       find_client(evt->window)->configure_notify(calculate_client_x(evt->window), calculate_client_y());
     } catch (const xpp::x::error::window& err) {
-      m_log.err("Failed to reconfigure tray client, removing... (%s)", err.what());
+      POLYBAR_LOG_ERR(m_log, "Failed to reconfigure tray client, removing... (%s)", err.what());
       remove_client(evt->window);
     }
   }
@@ -984,11 +996,11 @@ void tray_manager::handle(const evt::selection_clear& evt) {
   }
 
   try {
-    m_log.warn("Lost systray selection, deactivating...");
+    POLYBAR_LOG_WARN(m_log, "Lost systray selection, deactivating...");
     m_othermanager = m_connection.get_selection_owner(m_atom).owner<xcb_window_t>();
     track_selection_owner(m_othermanager);
   } catch (const exception& err) {
-    m_log.err("Failed to get systray selection owner");
+    POLYBAR_LOG_ERR(m_log, "Failed to get systray selection owner");
     m_othermanager = XCB_NONE;
   }
 
@@ -1017,28 +1029,28 @@ void tray_manager::handle(const evt::property_notify& evt) {
     return;
   }
 
-  m_log.trace("tray: _XEMBED_INFO: %s", m_connection.id(evt->window));
+  POLYBAR_LOG_TRACE(m_log, "tray: _XEMBED_INFO: %s", m_connection.id(evt->window));
 
   auto xd = client->xembed();
   auto win = client->window();
 
   if (evt->state == XCB_PROPERTY_NEW_VALUE) {
-    m_log.trace("tray: _XEMBED_INFO value has changed");
+    POLYBAR_LOG_TRACE(m_log, "tray: _XEMBED_INFO value has changed");
   }
 
   try {
-    m_log.trace("tray: Get client _XEMBED_INFO");
+    POLYBAR_LOG_TRACE(m_log, "tray: Get client _XEMBED_INFO");
     xembed::query(m_connection, win, xd);
   } catch (const application_error& err) {
-    m_log.err(err.what());
+    POLYBAR_LOG_ERR(m_log, "%s", err.what());
     return;
   } catch (const xpp::x::error::window& err) {
-    m_log.err("Failed to query _XEMBED_INFO, removing client... (%s)", err.what());
+    POLYBAR_LOG_ERR(m_log, "Failed to query _XEMBED_INFO, removing client... (%s)", err.what());
     remove_client(win, true);
     return;
   }
 
-  m_log.trace("tray: _XEMBED_INFO[0]=%u _XEMBED_INFO[1]=%u", xd->version, xd->flags);
+  POLYBAR_LOG_TRACE(m_log, "tray: _XEMBED_INFO[0]=%u _XEMBED_INFO[1]=%u", xd->version, xd->flags);
 
   if ((client->xembed()->flags & XEMBED_MAPPED) & XEMBED_MAPPED) {
     reconfigure();
@@ -1050,7 +1062,7 @@ void tray_manager::handle(const evt::property_notify& evt) {
  */
 void tray_manager::handle(const evt::reparent_notify& evt) {
   if (m_activated && is_embedded(evt->window) && evt->parent != m_tray) {
-    m_log.trace("tray: Received reparent_notify for client, remove...");
+    POLYBAR_LOG_TRACE(m_log, "tray: Received reparent_notify for client, remove...");
     remove_client(evt->window);
   }
 }
@@ -1062,10 +1074,10 @@ void tray_manager::handle(const evt::destroy_notify& evt) {
   if (m_activated && evt->window == m_tray) {
     deactivate();
   } else if (!m_activated && evt->window == m_othermanager) {
-    m_log.info("Systray selection unmanaged... re-activating");
+    POLYBAR_LOG_INFO(m_log, "Systray selection unmanaged... re-activating");
     activate();
   } else if (m_activated && is_embedded(evt->window)) {
-    m_log.trace("tray: Received destroy_notify for client, remove...");
+    POLYBAR_LOG_TRACE(m_log, "tray: Received destroy_notify for client, remove...");
     remove_client(evt->window);
     redraw_window();
   }
@@ -1076,13 +1088,13 @@ void tray_manager::handle(const evt::destroy_notify& evt) {
  */
 void tray_manager::handle(const evt::map_notify& evt) {
   if (m_activated && evt->window == m_tray) {
-    m_log.trace("tray: Received map_notify");
-    m_log.trace("tray: Update container mapped flag");
+    POLYBAR_LOG_TRACE(m_log, "tray: Received map_notify");
+    POLYBAR_LOG_TRACE(m_log, "tray: Update container mapped flag");
     m_mapped = true;
     redraw_window();
   } else if (is_embedded(evt->window)) {
-    m_log.trace("tray: Received map_notify");
-    m_log.trace("tray: Set client mapped");
+    POLYBAR_LOG_TRACE(m_log, "tray: Received map_notify");
+    POLYBAR_LOG_TRACE(m_log, "tray: Set client mapped");
     find_client(evt->window)->mapped(true);
     unsigned int clientcount{mapped_clients()};
     if (clientcount > m_opts.configured_slots) {
@@ -1097,12 +1109,12 @@ void tray_manager::handle(const evt::map_notify& evt) {
  */
 void tray_manager::handle(const evt::unmap_notify& evt) {
   if (m_activated && evt->window == m_tray) {
-    m_log.trace("tray: Received unmap_notify");
-    m_log.trace("tray: Update container mapped flag");
+    POLYBAR_LOG_TRACE(m_log, "tray: Received unmap_notify");
+    POLYBAR_LOG_TRACE(m_log, "tray: Update container mapped flag");
     m_mapped = false;
   } else if (m_activated && is_embedded(evt->window)) {
-    m_log.trace("tray: Received unmap_notify");
-    m_log.trace("tray: Set client unmapped");
+    POLYBAR_LOG_TRACE(m_log, "tray: Received unmap_notify");
+    POLYBAR_LOG_TRACE(m_log, "tray: Set client unmapped");
     find_client(evt->window)->mapped(false);
     m_sig.emit(signals::ui_tray::mapped_clients{mapped_clients()});
   }
@@ -1117,7 +1129,7 @@ bool tray_manager::on(const signals::ui::visibility_change& evt) {
   bool visible{evt.cast()};
   unsigned int clients{mapped_clients()};
 
-  m_log.trace("tray: visibility_change (state=%i, activated=%i, mapped=%i, hidden=%i)", visible,
+  POLYBAR_LOG_TRACE(m_log, "tray: visibility_change (state=%i, activated=%i, mapped=%i, hidden=%i)", visible,
       static_cast<bool>(m_activated), static_cast<bool>(m_mapped), static_cast<bool>(m_hidden));
 
   m_hidden = !visible;
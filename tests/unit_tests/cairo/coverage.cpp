@@ -0,0 +1,105 @@
+#include "cairo/coverage.hpp"
+
+#include "common/test.hpp"
+
+using namespace polybar;
+using namespace cairo;
+
+class CoverageTest : public ::testing::Test {
+ protected:
+  /**
+   * Font 0 covers ASCII, font 1 covers everything but 'x', font 2 covers
+   * only U+1F600 and nothing covers U+2603
+   */
+  bool probe(size_t slot, uint32_t codepoint) {
+    probes++;
+    switch (slot) {
+      case 0:
+        return codepoint < 0x80;
+      case 1:
+        return codepoint != 'x' && codepoint != 0x2603;
+      case 2:
+        return codepoint == 0x1F600;
+      default:
+        return false;
+    }
+  }
+
+  size_t probes{0};
+  font_coverage coverage{[this](size_t slot, uint32_t codepoint) { return probe(slot, codepoint); }};
+};
+
+TEST_F(CoverageTest, covers) {
+  coverage.reset(3);
+
+  EXPECT_TRUE(coverage.covers(0, 'x'));
+  EXPECT_FALSE(coverage.covers(1, 'x'));
+  EXPECT_TRUE(coverage.covers(1, 0xE9));
+  EXPECT_FALSE(coverage.covers(0, 0xE9));
+  EXPECT_TRUE(coverage.covers(2, 0x1F600));
+  EXPECT_FALSE(coverage.covers(3, 'a'));
+}
+
+TEST_F(CoverageTest, cachesResults) {
+  coverage.reset(3);
+
+  coverage.covers(0, 'a');
+  size_t ascii_probes = probes;
+  EXPECT_EQ(128 * 3, ascii_probes);
+
+  coverage.covers(2, 'b');
+  EXPECT_EQ(ascii_probes, probes);
+
+  coverage.covers(1, 0x1F600);
+  coverage.covers(2, 0x1F600);
+  EXPECT_EQ(ascii_probes + 3, probes);
+}
+
+TEST_F(CoverageTest, negativeCache) {
+  coverage.reset(3);
+
+  EXPECT_FALSE(coverage.covered(0x2603));
+  size_t count = probes;
+  EXPECT_FALSE(coverage.covered(0x2603));
+  EXPECT_EQ(count, probes);
+}
+
+TEST_F(CoverageTest, bmpCollisions) {
+  coverage.reset(3);
+
+  // Both map to the same direct-mapped slot
+  EXPECT_TRUE(coverage.covers(1, 0x100));
+  EXPECT_TRUE(coverage.covers(1, 0x500));
+  size_t count = probes;
+  EXPECT_TRUE(coverage.covers(1, 0x100));
+  EXPECT_EQ(count, probes);
+}
+
+TEST_F(CoverageTest, boundedCache) {
+  coverage.reset(3);
+
+  // Outside of the BMP, so only the LRU cache is involved
+  EXPECT_TRUE(coverage.covered(0x1F600));
+  size_t count = probes;
+  for (uint32_t i = 1; i < font_coverage::CACHE_SIZE; i++) {
+    coverage.covered(0x20000 + i);
+  }
+  EXPECT_TRUE(coverage.covered(0x1F600));
+  EXPECT_EQ(count + 3 * (font_coverage::CACHE_SIZE - 1), probes);
+
+  // Evicts the least recently used codepoint
+  coverage.covered(0x20000);
+  count = probes;
+  EXPECT_TRUE(coverage.covered(0x1F600));
+  EXPECT_EQ(count, probes);
+  coverage.covered(0x20001);
+  EXPECT_EQ(count + 3, probes);
+}
+
+TEST_F(CoverageTest, reset) {
+  coverage.reset(1);
+  EXPECT_FALSE(coverage.covered(0xE9));
+
+  coverage.reset(2);
+  EXPECT_TRUE(coverage.covered(0xE9));
+}
@@ -0,0 +1,162 @@
+#include "components/eventloop.hpp"
+
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include <future>
+
+#include "common/test.hpp"
+
+using namespace polybar;
+using namespace std::chrono_literals;
+
+TEST(EventLoop, timerFires) {
+  eventloop loop;
+  std::promise<void> fired;
+
+  auto handle = loop.add_timer(eventloop::clock::now() + 10ms, [&] { fired.set_value(); });
+  loop.start();
+
+  EXPECT_EQ(std::future_status::ready, fired.get_future().wait_for(1s));
+
+  loop.remove(handle);
+  loop.stop();
+}
+
+TEST(EventLoop, pastTimerFiresImmediately) {
+  eventloop loop;
+  std::promise<void> fired;
+
+  auto handle = loop.add_timer(eventloop::clock::time_point{}, [&] { fired.set_value(); });
+  loop.start();
+
+  EXPECT_EQ(std::future_status::ready, fired.get_future().wait_for(1s));
+
+  loop.remove(handle);
+}
+
+TEST(EventLoop, rescheduleTimer) {
+  eventloop loop;
+  std::atomic_int count{0};
+  std::promise<void> done;
+  eventloop::handle_t handle{0};
+
+  handle = loop.add_timer(eventloop::clock::now(), [&] {
+    if (++count == 3) {
+      done.set_value();
+    } else {
+      loop.reschedule(handle, eventloop::clock::now() + 1ms);
+    }
+  });
+  loop.start();
+
+  EXPECT_EQ(std::future_status::ready, done.get_future().wait_for(1s));
+  EXPECT_EQ(3, count);
+
+  loop.remove(handle);
+}
+
+TEST(EventLoop, fdReadable) {
+  eventloop loop;
+  int fd{eventfd(0, EFD_NONBLOCK)};
+  std::promise<uint64_t> value;
+
+  auto handle = loop.add_fd(fd, EPOLLIN, [&](int fd, unsigned int) {
+    uint64_t n;
+    if (::read(fd, &n, sizeof(n)) == sizeof(n)) {
+      value.set_value(n);
+    }
+  });
+  loop.start();
+
+  uint64_t n{5};
+  ASSERT_EQ(sizeof(n), ::write(fd, &n, sizeof(n)));
+
+  auto result = value.get_future();
+  ASSERT_EQ(std::future_status::ready, result.wait_for(1s));
+  EXPECT_EQ(5, result.get());
+
+  loop.remove(handle);
+  close(fd);
+}
+
+TEST(EventLoop, post) {
+  eventloop loop;
+  std::promise<bool> in_loop;
+
+  loop.start();
+  loop.post([&] { in_loop.set_value(loop.in_loop_thread()); });
+
+  auto result = in_loop.get_future();
+  ASSERT_EQ(std::future_status::ready, result.wait_for(1s));
+  EXPECT_TRUE(result.get());
+  EXPECT_FALSE(loop.in_loop_thread());
+}
+
+TEST(EventLoop, removeWaitsForCallback) {
+  eventloop loop;
+  std::promise<void> entered;
+  std::atomic_bool finished{false};
+
+  auto handle = loop.add_timer(eventloop::clock::now(), [&] {
+    entered.set_value();
+    std::this_thread::sleep_for(50ms);
+    finished = true;
+  });
+  loop.start();
+
+  entered.get_future().wait();
+  loop.remove(handle);
+  EXPECT_TRUE(finished);
+}
+
+TEST(EventLoop, removeFromCallback) {
+  eventloop loop;
+  std::atomic_int count{0};
+  std::promise<void> done;
+  eventloop::handle_t handle{0};
+
+  handle = loop.add_timer(eventloop::clock::now(), [&] {
+    count++;
+    loop.remove(handle);
+    loop.add_timer(eventloop::clock::now() + 20ms, [&] { done.set_value(); });
+  });
+  loop.start();
+
+  EXPECT_EQ(std::future_status::ready, done.get_future().wait_for(1s));
+  EXPECT_EQ(1, count);
+}
+
+TEST(EventLoop, coalescedTimersShareDeferred) {
+  eventloop loop{50ms};
+  std::atomic_int fired{0};
+  std::atomic_int deferred{0};
+  std::promise<void> done;
+
+  // Pick deadlines inside a single 50ms window
+  auto since_epoch = eventloop::clock::now().time_since_epoch();
+  auto deadline = eventloop::clock::time_point{(since_epoch / 50ms + 2) * 50ms} + 5ms;
+  auto cb = [&] {
+    fired++;
+    loop.defer_unique("flush", [&] {
+      if (++deferred == 1) {
+        done.set_value();
+      }
+    });
+  };
+
+  auto a = loop.add_timer(deadline, cb);
+  auto b = loop.add_timer(deadline + 5ms, cb);
+  auto c = loop.add_timer(deadline + 10ms, cb);
+  loop.start();
+
+  ASSERT_EQ(std::future_status::ready, done.get_future().wait_for(1s));
+  std::this_thread::sleep_for(100ms);
+
+  EXPECT_EQ(3, fired);
+  EXPECT_EQ(1, deferred);
+
+  loop.remove(a);
+  loop.remove(b);
+  loop.remove(c);
+}
@@ -0,0 +1,77 @@
+#include "components/frame_scheduler.hpp"
+
+#include "common/test.hpp"
+
+using namespace polybar;
+using namespace std::chrono_literals;
+
+using time_point = frame_scheduler::clock::time_point;
+
+static time_point at(chrono::milliseconds ms) {
+  return time_point{ms};
+}
+
+TEST(FrameScheduler, budget) {
+  EXPECT_EQ(chrono::duration_cast<frame_scheduler::clock::duration>(1s) / 50, frame_scheduler{50}.budget());
+  EXPECT_EQ(frame_scheduler::clock::duration{0}, frame_scheduler{0}.budget());
+}
+
+TEST(FrameScheduler, firstFrameIsImmediate) {
+  frame_scheduler frames{10};
+  EXPECT_FALSE(frames.pending());
+
+  frames.request(false, at(1000ms));
+  EXPECT_TRUE(frames.pending());
+  EXPECT_EQ(at(1000ms), frames.deadline());
+}
+
+TEST(FrameScheduler, immediateAfterIdle) {
+  frame_scheduler frames{10};
+  frames.request(false, at(1000ms));
+  frames.begin_frame(at(1000ms));
+
+  frames.request(false, at(1500ms));
+  EXPECT_EQ(at(1500ms), frames.deadline());
+}
+
+TEST(FrameScheduler, respectsBudget) {
+  frame_scheduler frames{10};
+  frames.request(false, at(1000ms));
+  frames.begin_frame(at(1000ms));
+
+  frames.request(false, at(1020ms));
+  EXPECT_EQ(at(1100ms), frames.deadline());
+}
+
+TEST(FrameScheduler, mergesRequests) {
+  frame_scheduler frames{10};
+  frames.request(false, at(1000ms));
+  frames.begin_frame(at(1000ms));
+
+  frames.request(false, at(1020ms));
+  frames.request(true, at(1040ms));
+  frames.request(false, at(1060ms));
+
+  EXPECT_EQ(at(1100ms), frames.deadline());
+  EXPECT_EQ(2, frames.get_stats().merged);
+  EXPECT_TRUE(frames.begin_frame(at(1100ms)));
+  EXPECT_FALSE(frames.pending());
+  EXPECT_EQ(2, frames.get_stats().rendered);
+}
+
+TEST(FrameScheduler, countsDroppedFrames) {
+  frame_scheduler frames{10};
+  frames.request(false, at(1000ms));
+  frames.begin_frame(at(1350ms));
+  EXPECT_EQ(3, frames.get_stats().dropped);
+}
+
+TEST(FrameScheduler, unlimited) {
+  frame_scheduler frames{0};
+  frames.request(false, at(1000ms));
+  frames.begin_frame(at(1000ms));
+  frames.request(false, at(1000ms));
+  EXPECT_EQ(at(1000ms), frames.deadline());
+  frames.begin_frame(at(5000ms));
+  EXPECT_EQ(0, frames.get_stats().dropped);
+}
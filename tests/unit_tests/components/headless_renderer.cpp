@@ -0,0 +1,67 @@
+#include "components/headless_renderer.hpp"
+
+#include "cairo/surface.hpp"
+#include "common/test.hpp"
+#include "components/config.hpp"
+#include "components/logger.hpp"
+#include "tags/action_context.hpp"
+#include "tags/dispatch.hpp"
+
+using namespace polybar;
+
+class HeadlessRendererTest : public ::testing::Test {
+ protected:
+  HeadlessRendererTest() {
+    m_conf.set_sections({{"bar/test", {{"font-0", "fixed"}}}});
+
+    m_bar.size.w = 100;
+    m_bar.size.h = 20;
+    m_bar.background = rgba{0xFF112233};
+
+    m_renderer = make_unique<headless_renderer>(m_conf, m_log, m_bar, m_action_ctxt);
+  }
+
+  void draw(string contents) {
+    m_renderer->begin(m_bar.inner_area());
+    m_dispatch.parse(m_bar, *m_renderer, move(contents));
+    m_renderer->end();
+  }
+
+  /**
+   * Color of the given pixel in the newest frame
+   */
+  uint32_t pixel(int x, int y) const {
+    const auto& image = m_renderer->image();
+    return *reinterpret_cast<const uint32_t*>(image.data() + y * image.stride() + x * 4);
+  }
+
+  logger m_log{loglevel::NONE};
+  config m_conf{m_log, "", "test"};
+  bar_settings m_bar{};
+  tags::action_context m_action_ctxt{};
+  tags::dispatch m_dispatch{m_log, m_action_ctxt};
+  unique_ptr<headless_renderer> m_renderer;
+};
+
+TEST_F(HeadlessRendererTest, drawsBackground) {
+  draw("");
+
+  EXPECT_EQ(1U, m_renderer->frames());
+  EXPECT_EQ(0xFF112233, pixel(0, 0));
+  EXPECT_EQ(0xFF112233, pixel(99, 19));
+}
+
+TEST_F(HeadlessRendererTest, onlyPresentsChanges) {
+  draw("%{O10}foo");
+  EXPECT_EQ(1U, m_renderer->frames());
+  EXPECT_FALSE(m_renderer->damage().empty());
+
+  draw("%{O10}foo");
+  EXPECT_EQ(1U, m_renderer->frames());
+  EXPECT_TRUE(m_renderer->damage().empty());
+
+  draw("%{O10}bar");
+  EXPECT_EQ(2U, m_renderer->frames());
+  ASSERT_EQ(1U, m_renderer->damage().size());
+  EXPECT_EQ(0, m_renderer->damage()[0].x);
+}
@@ -0,0 +1,119 @@
+#include "components/logger.hpp"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <future>
+
+#include "common/test.hpp"
+
+using namespace polybar;
+
+/**
+ * Redirects stderr into a pipe for the duration of a test
+ */
+class LoggerTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    ASSERT_EQ(0, pipe(m_pipe));
+    m_stderr = dup(STDERR_FILENO);
+    dup2(m_pipe[1], STDERR_FILENO);
+  }
+
+  void TearDown() override {
+    logger::flush();
+    dup2(m_stderr, STDERR_FILENO);
+    close(m_stderr);
+    close(m_pipe[0]);
+    close(m_pipe[1]);
+  }
+
+  /**
+   * Everything that was written to stderr so far
+   */
+  string output() {
+    string result;
+    char buffer[BUFSIZ];
+    fcntl(m_pipe[0], F_SETFL, O_NONBLOCK);
+    ssize_t n;
+    while ((n = read(m_pipe[0], buffer, sizeof(buffer))) > 0) {
+      result.append(buffer, n);
+    }
+    return result;
+  }
+
+  int m_pipe[2];
+  int m_stderr;
+  logger m_log{loglevel::INFO};
+};
+
+TEST_F(LoggerTest, writesMessages) {
+  POLYBAR_LOG_INFO(m_log, "first %s %i", "message", 1);
+  POLYBAR_LOG_ERR(m_log, "second message");
+  POLYBAR_LOG_INFO(m_log, "%s", string(2000, 'x'));
+  logger::flush();
+
+  auto out = output();
+  auto first = out.find("first message 1\n");
+  auto second = out.find("second message\n");
+  EXPECT_NE(string::npos, first);
+  EXPECT_NE(string::npos, second);
+  EXPECT_LT(first, second);
+  EXPECT_NE(string::npos, out.find(string(2000, 'x') + "\n"));
+}
+
+TEST_F(LoggerTest, filtersLevel) {
+  logger log{loglevel::WARNING};
+  POLYBAR_LOG_INFO(log, "hidden %i", 1);
+  POLYBAR_LOG_WARN(log, "visible %i", 2);
+  logger::flush();
+
+  auto out = output();
+  EXPECT_EQ(string::npos, out.find("hidden"));
+  EXPECT_NE(string::npos, out.find("visible 2"));
+}
+
+TEST_F(LoggerTest, dropsWhenFull) {
+  // Nobody reads the pipe, so the writer thread blocks once it is full
+  const string line(1000, 'y');
+  for (int i = 0; i < 2000; i++) {
+    POLYBAR_LOG_INFO(m_log, "%s", line);
+  }
+
+  auto flushed = std::async(std::launch::async, [] { logger::flush(); });
+  string out;
+  while (flushed.wait_for(std::chrono::milliseconds(1)) != std::future_status::ready) {
+    out += output();
+  }
+  out += output();
+
+  EXPECT_NE(string::npos, out.find("Dropped "));
+  EXPECT_NE(string::npos, out.find(" log messages\n"));
+}
+
+TEST_F(LoggerTest, evaluatesArgumentsOnlyIfEnabled) {
+  int calls{0};
+  auto arg = [&] { return ++calls; };
+
+  logger log{loglevel::WARNING};
+  POLYBAR_LOG_INFO(log, "skipped %i", arg());
+  POLYBAR_LOG_TRACE_X(log, "skipped %i", arg());
+  EXPECT_EQ(0, calls);
+
+  POLYBAR_LOG_WARN(log, "evaluated %i", arg());
+  EXPECT_EQ(1, calls);
+}
+
+TEST(LogFormat, valid) {
+  EXPECT_TRUE(log_format::valid<>("no conversions, but a literal %%"));
+  EXPECT_TRUE((log_format::valid<string, const char*, int>("%s: %s (%i)")));
+  EXPECT_TRUE((log_format::valid<size_t, unsigned char, double, std::thread::id>("%lu %03u %.2f %zu")));
+  EXPECT_TRUE((log_format::valid<int, string, void*>("%*s %p")));
+
+  EXPECT_FALSE(log_format::valid<>("%s"));
+  EXPECT_FALSE(log_format::valid<int>("no conversions"));
+  EXPECT_FALSE(log_format::valid<int>("%s"));
+  EXPECT_FALSE(log_format::valid<string>("%i"));
+  EXPECT_FALSE(log_format::valid<int>("%f"));
+  EXPECT_FALSE(log_format::valid<int>("%i%"));
+}
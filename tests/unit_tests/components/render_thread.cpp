@@ -0,0 +1,109 @@
+#include "components/render_thread.hpp"
+
+#include <future>
+
+#include "common/test.hpp"
+#include "components/logger.hpp"
+#include "errors.hpp"
+
+using namespace polybar;
+
+class RenderThreadTest : public ::testing::Test {
+ protected:
+  using frame = render_thread::frame;
+
+  static frame make_frame(string text, bool force = false) {
+    frame f{bar_settings{}, {}, xcb_rectangle_t{}, false};
+    f.elements.emplace_back(make_shared<const tags::format_string>(tags::format_string{tags::element{move(text)}}));
+    f.force = force;
+    return f;
+  }
+
+  /**
+   * Wait until everything posted so far ran on the rendering thread
+   */
+  void sync(render_thread& thread) {
+    std::promise<void> done;
+    thread.post([&] { done.set_value(); });
+    done.get_future().wait();
+  }
+
+  logger m_log{loglevel::NONE};
+};
+
+TEST_F(RenderThreadTest, rendersFrames) {
+  vector<string> drawn;
+  render_thread thread(m_log, [&](const frame& f) { drawn.emplace_back(f.elements.front()->front().data); });
+
+  thread.submit(make_frame("foo"));
+  sync(thread);
+  thread.submit(make_frame("bar"));
+  sync(thread);
+
+  EXPECT_EQ((vector<string>{"foo", "bar"}), drawn);
+  EXPECT_EQ(2, thread.get_stats().rendered);
+}
+
+TEST_F(RenderThreadTest, replacesPendingFrame) {
+  std::promise<void> blocked;
+  std::promise<void> release;
+  auto release_future = release.get_future();
+  vector<pair<string, bool>> drawn;
+
+  render_thread thread(m_log, [&](const frame& f) { drawn.emplace_back(f.elements.front()->front().data, f.force); });
+
+  // Keep the thread busy while submitting frames
+  thread.post([&] {
+    blocked.set_value();
+    release_future.wait();
+  });
+  blocked.get_future().wait();
+
+  thread.submit(make_frame("first", true));
+  thread.submit(make_frame("second"));
+  thread.submit(make_frame("third"));
+  release.set_value();
+  sync(thread);
+
+  ASSERT_EQ(1, drawn.size());
+  EXPECT_EQ("third", drawn[0].first);
+  EXPECT_TRUE(drawn[0].second);
+  EXPECT_EQ(2, thread.get_stats().replaced);
+}
+
+TEST_F(RenderThreadTest, holdsFrameUntilReady) {
+  std::atomic<bool> ready{false};
+  std::promise<string> drawn;
+  render_thread thread(
+      m_log, [&](const frame& f) { drawn.set_value(f.elements.front()->front().data); }, [&] { return ready.load(); });
+
+  thread.submit(make_frame("first"));
+  sync(thread);
+  thread.submit(make_frame("second"));
+  // Tasks are not held up by the frame
+  sync(thread);
+
+  EXPECT_EQ(0, thread.get_stats().rendered);
+  EXPECT_LT(0, thread.get_stats().held);
+  EXPECT_EQ(1, thread.get_stats().replaced);
+
+  ready = true;
+  EXPECT_EQ("second", drawn.get_future().get());
+  sync(thread);
+  EXPECT_EQ(1, thread.get_stats().rendered);
+}
+
+TEST_F(RenderThreadTest, survivesExceptions) {
+  size_t calls{0};
+  render_thread thread(m_log, [&](const frame&) {
+    calls++;
+    throw application_error("failed");
+  });
+
+  thread.submit(make_frame("foo"));
+  sync(thread);
+  thread.submit(make_frame("bar"));
+  sync(thread);
+
+  EXPECT_EQ(2, calls);
+}
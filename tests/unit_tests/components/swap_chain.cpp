@@ -0,0 +1,113 @@
+#include "components/swap_chain.hpp"
+
+#include "common/test.hpp"
+
+using namespace polybar;
+
+static const xcb_rectangle_t FULL{0, 0, 100, 20};
+
+static bool operator==(const xcb_rectangle_t& a, const xcb_rectangle_t& b) {
+  return a.x == b.x && a.y == b.y && a.width == b.width && a.height == b.height;
+}
+
+/**
+ * Without the Present extension every buffer is idle and they are used in turn
+ */
+TEST(SwapChain, fallbackRotates) {
+  swap_chain chain{3, FULL};
+  EXPECT_EQ(0U, chain.front());
+
+  for (size_t i = 1; i <= 6; i++) {
+    EXPECT_TRUE(chain.acquire());
+    EXPECT_EQ(i % 3, chain.back());
+    chain.present({FULL});
+    EXPECT_EQ(i % 3, chain.front());
+  }
+}
+
+TEST(SwapChain, skipsBusyBuffers) {
+  swap_chain chain{3, FULL};
+  vector<bool> busy{false, true, false};
+
+  auto idle = [&](size_t i) { return !busy[i]; };
+
+  EXPECT_TRUE(chain.acquire(idle));
+  EXPECT_EQ(2U, chain.back());
+  chain.present({FULL});
+  EXPECT_EQ(2U, chain.front());
+
+  busy = {true, false, false};
+  EXPECT_TRUE(chain.acquire(idle));
+  EXPECT_EQ(1U, chain.back());
+}
+
+TEST(SwapChain, neverHandsOutBusyBuffers) {
+  swap_chain chain{3, FULL};
+  vector<bool> busy{false, true, true};
+  size_t calls{0};
+  auto idle = [&](size_t i) {
+    calls++;
+    return !busy[i];
+  };
+
+  EXPECT_FALSE(chain.available(idle));
+  EXPECT_FALSE(chain.acquire(idle));
+  EXPECT_EQ(0U, chain.back());
+  // The front buffer is never asked for
+  EXPECT_EQ(4U, calls);
+
+  busy[2] = false;
+  EXPECT_TRUE(chain.available(idle));
+  EXPECT_TRUE(chain.acquire(idle));
+  EXPECT_EQ(2U, chain.back());
+}
+
+TEST(SwapChain, tracksStaleAreas) {
+  swap_chain chain{3, FULL};
+  const xcb_rectangle_t a{0, 0, 10, 20};
+  const xcb_rectangle_t b{50, 0, 10, 20};
+
+  EXPECT_TRUE(chain.acquire());
+  EXPECT_TRUE(chain.take_stale().empty());
+  chain.present({a});
+
+  EXPECT_TRUE(chain.acquire());
+  EXPECT_EQ(2U, chain.back());
+  EXPECT_EQ(vector<xcb_rectangle_t>({a}), chain.take_stale());
+  EXPECT_TRUE(chain.take_stale().empty());
+  chain.present({b});
+
+  // Buffer 0 missed both frames
+  EXPECT_TRUE(chain.acquire());
+  EXPECT_EQ(0U, chain.back());
+  EXPECT_EQ(vector<xcb_rectangle_t>({a, b}), chain.take_stale());
+}
+
+TEST(SwapChain, collapsesStaleAreas) {
+  swap_chain chain{3, FULL};
+  const xcb_rectangle_t area{0, 0, 1, 1};
+  auto skip_first = [](size_t i) { return i != 0; };
+  auto only_first = [](size_t i) { return i == 0; };
+
+  // Buffer 0 stays busy while frames keep coming
+  for (size_t i = 0; i < swap_chain::MAX_STALE_AREAS; i++) {
+    EXPECT_TRUE(chain.acquire(skip_first));
+    EXPECT_NE(0U, chain.back());
+    chain.present({area});
+  }
+
+  EXPECT_TRUE(chain.acquire(only_first));
+  EXPECT_EQ(0U, chain.back());
+  EXPECT_EQ(vector<xcb_rectangle_t>(swap_chain::MAX_STALE_AREAS, area), chain.take_stale());
+  chain.present({area});
+
+  for (size_t i = 0; i <= swap_chain::MAX_STALE_AREAS; i++) {
+    EXPECT_TRUE(chain.acquire(skip_first));
+    EXPECT_NE(0U, chain.back());
+    chain.present({area});
+  }
+
+  EXPECT_TRUE(chain.acquire(only_first));
+  EXPECT_EQ(0U, chain.back());
+  EXPECT_EQ(vector<xcb_rectangle_t>({FULL}), chain.take_stale());
+}
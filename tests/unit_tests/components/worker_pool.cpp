@@ -0,0 +1,81 @@
+#include "components/worker_pool.hpp"
+
+#include <set>
+
+#include "common/test.hpp"
+#include "errors.hpp"
+
+using namespace polybar;
+using namespace std::chrono_literals;
+
+TEST(WorkerPool, runsAllTasks) {
+  worker_pool pool{3};
+  EXPECT_EQ(3U, pool.size());
+
+  for (size_t round = 0; round < 100; round++) {
+    vector<int> results(20, 0);
+    vector<worker_pool::task_fn> tasks;
+    for (size_t i = 0; i < results.size(); i++) {
+      tasks.emplace_back([&results, i] { results[i] = static_cast<int>(i) + 1; });
+    }
+
+    pool.run(tasks);
+
+    for (size_t i = 0; i < results.size(); i++) {
+      EXPECT_EQ(static_cast<int>(i) + 1, results[i]);
+    }
+  }
+}
+
+TEST(WorkerPool, runsInParallel) {
+  worker_pool pool{3};
+  std::mutex lock;
+  std::set<std::thread::id> threads;
+  vector<worker_pool::task_fn> tasks;
+
+  for (size_t i = 0; i < 4; i++) {
+    tasks.emplace_back([&] {
+      std::this_thread::sleep_for(50ms);
+      std::lock_guard<std::mutex> guard(lock);
+      threads.emplace(std::this_thread::get_id());
+    });
+  }
+
+  auto start = std::chrono::steady_clock::now();
+  pool.run(tasks);
+
+  EXPECT_LT(std::chrono::steady_clock::now() - start, 150ms);
+  EXPECT_LT(1U, threads.size());
+}
+
+TEST(WorkerPool, withoutWorkers) {
+  worker_pool pool{0};
+  vector<std::thread::id> threads;
+  vector<worker_pool::task_fn> tasks;
+
+  for (size_t i = 0; i < 3; i++) {
+    tasks.emplace_back([&] { threads.emplace_back(std::this_thread::get_id()); });
+  }
+
+  pool.run(tasks);
+
+  EXPECT_EQ(vector<std::thread::id>(3, std::this_thread::get_id()), threads);
+}
+
+TEST(WorkerPool, rethrowsAfterAllTasks) {
+  worker_pool pool{2};
+  std::atomic<size_t> ran{0};
+  vector<worker_pool::task_fn> tasks;
+
+  for (size_t i = 0; i < 10; i++) {
+    tasks.emplace_back([&, i] {
+      ran++;
+      if (i == 3) {
+        throw application_error("failed");
+      }
+    });
+  }
+
+  EXPECT_THROW(pool.run(tasks), application_error);
+  EXPECT_EQ(10U, ran);
+}
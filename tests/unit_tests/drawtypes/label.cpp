@@ -107,3 +107,51 @@ TEST_P(GetTest, soundness) {
   EXPECT_TRUE(m_label->m_maxlen == 0 || actual.length() <= m_label->m_maxlen) << "Returned text is longer than maxlen";
   EXPECT_GE(actual.length(), m_label->m_minlen) << "Returned text is shorter than minlen";
 }
+
+TEST(Label, cloneKeepsSettings) {
+  label test_label("%x%", rgba{0xff112233}, rgba{}, rgba{}, rgba{}, 2, {1U, 2U}, {3U, 4U}, 5, 7,
+      alignment::RIGHT, true, {token{"%x%"}});
+  auto copy = test_label.clone();
+
+  EXPECT_EQ(test_label.m_foreground, copy->m_foreground);
+  EXPECT_EQ(2, copy->m_font);
+  EXPECT_EQ(2U, copy->m_padding.right);
+  EXPECT_EQ(3U, copy->m_margin.left);
+  EXPECT_EQ(5U, copy->m_minlen);
+  EXPECT_EQ(7U, copy->m_maxlen);
+  EXPECT_EQ(alignment::RIGHT, copy->m_alignment);
+
+  copy->replace_token("%x%", "ab");
+  EXPECT_EQ("   ab", copy->get());
+}
+
+TEST(Label, replaceToken) {
+  vector<token> tokens{{"%x%", 3, 0, "", true}, {"%y%"}, {"%x%", 0, 2, "~"}};
+  label test_label("a %x% b %y% c %x%", rgba{}, rgba{}, rgba{}, rgba{}, 0, {0U, 0U}, {0U, 0U}, 0, 0,
+      alignment::LEFT, true, move(tokens));
+  EXPECT_EQ("a %x% b %y% c %x%", test_label.get());
+  EXPECT_TRUE(test_label.has_token("%x%"));
+
+  test_label.replace_token("%x%", "12345");
+  EXPECT_FALSE(test_label.has_token("%x%"));
+  EXPECT_EQ("a 12345 b %y% c 12~", test_label.get());
+
+  // Filled tokens stay until the tokens are reset
+  test_label.replace_token("%x%", "9");
+  EXPECT_EQ("a 12345 b %y% c 12~", test_label.get());
+
+  test_label.reset_tokens();
+  test_label.replace_token("%x%", "9");
+  test_label.replace_token("%y%", "Y");
+  EXPECT_EQ("a 009 b Y c 9", test_label.get());
+
+  auto copy = test_label.clone();
+  EXPECT_EQ("a %x% b %y% c %x%", copy->get());
+  copy->replace_token("%x%", "1");
+  EXPECT_EQ("a 001 b %y% c 1", copy->get());
+  EXPECT_EQ("a 009 b Y c 9", test_label.get());
+
+  test_label.clear();
+  EXPECT_EQ("", test_label.get());
+  EXPECT_FALSE(test_label.has_token("%y%"));
+}
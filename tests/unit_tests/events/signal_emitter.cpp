@@ -0,0 +1,153 @@
+#include "events/signal_emitter.hpp"
+
+#include <thread>
+
+#include "common/test.hpp"
+#include "events/signal.hpp"
+
+using namespace polybar;
+
+namespace {
+  template <int Priority>
+  class recorder : public signal_receiver<Priority, signals::ui::tick, signals::ui::changed> {
+   public:
+    recorder(vector<int>& calls, bool handle) : m_calls(calls), m_handle(handle) {}
+
+    bool on(const signals::ui::tick&) override {
+      m_calls.push_back(Priority);
+      return m_handle;
+    }
+
+    bool on(const signals::ui::changed&) override {
+      m_calls.push_back(-Priority);
+      return false;
+    }
+
+   private:
+    vector<int>& m_calls;
+    bool m_handle;
+  };
+}  // namespace
+
+class SignalEmitterTest : public ::testing::Test {
+ protected:
+  signal_emitter m_sig;
+  vector<int> m_calls;
+};
+
+TEST_F(SignalEmitterTest, ordersByPriority) {
+  recorder<2> second{m_calls, false};
+  recorder<1> first{m_calls, false};
+  recorder<3> third{m_calls, false};
+  m_sig.attach(&second);
+  m_sig.attach(&first);
+  m_sig.attach(&third);
+
+  EXPECT_FALSE(m_sig.emit(signals::ui::tick{}));
+  EXPECT_EQ((vector<int>{1, 2, 3}), m_calls);
+
+  m_calls.clear();
+  EXPECT_FALSE(m_sig.emit(signals::ui::changed{}));
+  EXPECT_EQ((vector<int>{-1, -2, -3}), m_calls);
+
+  m_sig.detach(&first);
+  m_sig.detach(&second);
+  m_sig.detach(&third);
+}
+
+TEST_F(SignalEmitterTest, stopsWhenHandled) {
+  recorder<1> first{m_calls, true};
+  recorder<2> second{m_calls, false};
+  m_sig.attach(&first);
+  m_sig.attach(&second);
+
+  EXPECT_TRUE(m_sig.emit(signals::ui::tick{}));
+  EXPECT_EQ((vector<int>{1}), m_calls);
+
+  m_sig.detach(&first);
+  m_sig.detach(&second);
+}
+
+TEST_F(SignalEmitterTest, detach) {
+  recorder<1> first{m_calls, false};
+  recorder<1> second{m_calls, false};
+  m_sig.attach(&first);
+  m_sig.attach(&second);
+  m_sig.detach(&first);
+
+  EXPECT_FALSE(m_sig.emit(signals::ui::tick{}));
+  EXPECT_EQ(1U, m_calls.size());
+
+  m_sig.detach(&second);
+  m_calls.clear();
+  EXPECT_FALSE(m_sig.emit(signals::ui::tick{}));
+  EXPECT_TRUE(m_calls.empty());
+}
+
+TEST_F(SignalEmitterTest, detachWhileEmitting) {
+  class detacher : public signal_receiver<0, signals::ui::tick> {
+   public:
+    explicit detacher(signal_emitter& sig) : m_sig(sig) {}
+    bool on(const signals::ui::tick&) override {
+      m_sig.detach(this);
+      return false;
+    }
+
+   private:
+    signal_emitter& m_sig;
+  };
+
+  detacher d{m_sig};
+  recorder<1> after{m_calls, false};
+  m_sig.attach(&d);
+  m_sig.attach(&after);
+
+  m_sig.emit(signals::ui::tick{});
+  EXPECT_EQ((vector<int>{1}), m_calls);
+
+  m_calls.clear();
+  m_sig.emit(signals::ui::tick{});
+  EXPECT_EQ((vector<int>{1}), m_calls);
+
+  m_sig.detach(&after);
+}
+
+TEST_F(SignalEmitterTest, detachWaitsForEmits) {
+  class blocker : public signal_receiver<0, signals::ui::tick> {
+   public:
+    bool on(const signals::ui::tick&) override {
+      entered = true;
+      while (!release) {
+        std::this_thread::yield();
+      }
+      left = true;
+      return false;
+    }
+
+    std::atomic<bool> entered{false};
+    std::atomic<bool> release{false};
+    std::atomic<bool> left{false};
+  };
+
+  blocker b;
+  m_sig.attach(&b);
+
+  std::thread emitter([&] { m_sig.emit(signals::ui::tick{}); });
+  while (!b.entered) {
+    std::this_thread::yield();
+  }
+
+  std::atomic<bool> detached{false};
+  std::thread detaching([&] {
+    m_sig.detach(&b);
+    detached = true;
+  });
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  EXPECT_FALSE(detached);
+
+  b.release = true;
+  detaching.join();
+  EXPECT_TRUE(b.left);
+  emitter.join();
+}
@@ -0,0 +1,317 @@
+#include "modules/meta/base.hpp"
+
+#include <future>
+#include <thread>
+
+#include "components/builder.hpp"
+
+#include "common/test.hpp"
+#include "components/eventloop.hpp"
+#include "modules/meta/base.inl"
+
+using namespace polybar;
+
+namespace polybar {
+  namespace modules {
+    /**
+     * Module showing a fixed text, counting how often its output is built
+     */
+    class test_module : public module<test_module> {
+     public:
+      explicit test_module(const bar_settings& bar, string name_) : module<test_module>(bar, move(name_)) {
+        m_formatter->add(DEFAULT_FORMAT, TAG_TEXT, {TAG_TEXT, TAG_EMPTY});
+      }
+
+      void start() override {}
+
+      bool build(builder* builder, const string& tag) const {
+        if (tag == TAG_TEXT) {
+          builder->node(m_text);
+          m_builds++;
+          return true;
+        }
+        return false;
+      }
+
+      shared_ptr<module_format> format() {
+        return m_formatter->get(DEFAULT_FORMAT);
+      }
+
+      using module<test_module>::broadcast;
+      using module<test_module>::lock_update;
+      using module<test_module>::get_output;
+
+      static constexpr auto TYPE = "test";
+      static constexpr auto TAG_TEXT = "<text>";
+      static constexpr auto TAG_EMPTY = "<empty>";
+
+      string m_text{"foo"};
+      mutable size_t m_builds{0};
+    };
+
+    template class module<test_module>;
+  }  // namespace modules
+}  // namespace polybar
+
+class ModuleTest : public ::testing::Test {
+ protected:
+  ModuleTest() {
+    m_module.set_change_handler([this] { m_notified++; });
+  }
+
+  ~ModuleTest() {
+    m_module.stop();
+  }
+
+  /**
+   * Broadcast from the module event loop and wait until it is done
+   */
+  void broadcast_from_loop() {
+    auto& loop = eventloop::make();
+    loop.start();
+
+    std::promise<void> done;
+    loop.post([&] {
+      m_module.broadcast();
+      done.set_value();
+    });
+    done.get_future().wait();
+  }
+
+  bar_settings m_bar{};
+  modules::test_module m_module{m_bar, "test"};
+  size_t m_notified{0};
+};
+
+/**
+ * Tests the compiled format output against the format parsing that
+ * get_output did before formats were compiled
+ */
+class ModuleFormatTest : public ModuleTest, public ::testing::WithParamInterface<pair<string, size_t>> {
+ protected:
+  string output(const string& value, size_t spacing) {
+    auto format = m_module.format();
+    format->value = value;
+    format->spacing = spacing;
+    format->compile();
+    return m_module.get_output();
+  }
+
+  /**
+   * The old get_output, which cut the value apart on every call
+   */
+  string legacy_output(string value, size_t spacing) {
+    builder b{m_bar};
+    bool no_tag_built{true};
+    bool tag_built{false};
+    auto mingap = std::max(1_z, spacing);
+    size_t start, end;
+    while ((start = value.find('<')) != string::npos && (end = value.find('>', start)) != string::npos) {
+      if (start > 0) {
+        if (no_tag_built) {
+          auto trimmed = string_util::ltrim(value.substr(0, start), ' ');
+          if (!trimmed.empty()) {
+            b.node(move(trimmed));
+          }
+        } else {
+          b.node(value.substr(0, start));
+        }
+        value.erase(0, start);
+        end -= start;
+        start = 0;
+      }
+      string tag{value.substr(start, end + 1)};
+      if (!no_tag_built) {
+        b.space(spacing);
+      }
+      if (!(tag_built = m_module.build(&b, tag)) && !no_tag_built) {
+        b.remove_trailing_space(mingap);
+      }
+      if (tag_built) {
+        no_tag_built = false;
+      }
+      value.erase(0, tag.size());
+    }
+    if (!value.empty()) {
+      b.append(value);
+    }
+    return b.flush();
+  }
+};
+
+TEST_F(ModuleTest, emptyBeforeBroadcast) {
+  EXPECT_FALSE(m_module.changed());
+  EXPECT_EQ("", m_module.contents());
+  EXPECT_EQ(0U, m_module.m_builds);
+}
+
+TEST_F(ModuleTest, publishesSnapshot) {
+  m_module.broadcast();
+  EXPECT_EQ(1U, m_module.m_builds);
+  EXPECT_EQ(1U, m_notified);
+  EXPECT_TRUE(m_module.changed());
+
+  auto contents = m_module.contents();
+  EXPECT_EQ(0U, contents.find("foo"));
+  EXPECT_FALSE(m_module.changed());
+
+  // The snapshot only changes with the next broadcast
+  m_module.m_text = "bar";
+  EXPECT_EQ(contents, m_module.contents());
+  EXPECT_EQ(1U, m_module.m_builds);
+
+  m_module.broadcast();
+  EXPECT_TRUE(m_module.changed());
+  EXPECT_EQ(0U, m_module.contents().find("bar"));
+}
+
+TEST_F(ModuleTest, changedUntilRead) {
+  m_module.broadcast();
+  m_module.broadcast();
+  EXPECT_TRUE(m_module.changed());
+
+  m_module.contents();
+  EXPECT_FALSE(m_module.changed());
+  m_module.contents();
+  EXPECT_FALSE(m_module.changed());
+}
+
+TEST_F(ModuleTest, hiddenModuleIsNotBuilt) {
+  m_module.broadcast();
+  m_module.contents();
+
+  EXPECT_TRUE(m_module.input(modules::test_module::EVENT_MODULE_HIDE, ""));
+  EXPECT_FALSE(m_module.visible());
+  EXPECT_EQ(2U, m_notified);
+
+  m_module.m_text = "bar";
+  m_module.broadcast();
+  EXPECT_EQ(1U, m_module.m_builds);
+  EXPECT_FALSE(m_module.changed());
+
+  EXPECT_TRUE(m_module.input(modules::test_module::EVENT_MODULE_SHOW, ""));
+  EXPECT_TRUE(m_module.visible());
+  EXPECT_EQ(2U, m_module.m_builds);
+  EXPECT_TRUE(m_module.changed());
+  EXPECT_EQ(0U, m_module.contents().find("bar"));
+}
+
+TEST_F(ModuleTest, stoppedModuleIsNotBuilt) {
+  m_module.stop();
+  EXPECT_FALSE(m_module.running());
+  EXPECT_EQ(1U, m_notified);
+
+  m_module.broadcast();
+  EXPECT_EQ(0U, m_module.m_builds);
+  EXPECT_EQ("", m_module.contents());
+}
+
+TEST_F(ModuleTest, loopBroadcastBuildsOnRead) {
+  broadcast_from_loop();
+  EXPECT_EQ(0U, m_module.m_builds);
+  EXPECT_EQ(1U, m_notified);
+  EXPECT_TRUE(m_module.changed());
+
+  EXPECT_EQ(0U, m_module.contents().find("foo"));
+  EXPECT_EQ(1U, m_module.m_builds);
+  EXPECT_FALSE(m_module.changed());
+
+  // Reading again does not build again
+  m_module.contents();
+  EXPECT_EQ(1U, m_module.m_builds);
+}
+
+TEST_F(ModuleTest, busyModuleIsBuiltLater) {
+  std::promise<void> locked;
+  std::promise<void> release;
+  auto release_future = release.get_future();
+
+  // Keep the module busy updating on another thread
+  std::thread updater([&] {
+    auto guard = m_module.lock_update();
+    locked.set_value();
+    release_future.wait();
+  });
+  locked.get_future().wait();
+
+  broadcast_from_loop();
+  EXPECT_EQ(1U, m_notified);
+
+  // Returns the previous snapshot instead of waiting and asks to be read again
+  EXPECT_EQ("", m_module.contents());
+  EXPECT_EQ(0U, m_module.m_builds);
+  EXPECT_EQ(2U, m_notified);
+  EXPECT_TRUE(m_module.changed());
+
+  release.set_value();
+  updater.join();
+
+  EXPECT_EQ(0U, m_module.contents().find("foo"));
+  EXPECT_EQ(1U, m_module.m_builds);
+  EXPECT_FALSE(m_module.changed());
+}
+
+TEST_F(ModuleFormatTest, compile) {
+  auto format = m_module.format();
+  format->value = "  a <text> b<empty>c";
+  format->compile();
+
+  ASSERT_EQ(2U, format->segments.size());
+  EXPECT_EQ("  a ", format->segments[0].text);
+  EXPECT_EQ("a ", format->segments[0].trimmed);
+  EXPECT_EQ("<text>", format->segments[0].tag);
+  EXPECT_EQ(0U, format->segments[0].id);
+  EXPECT_EQ(" b", format->segments[1].text);
+  EXPECT_EQ("<empty>", format->segments[1].tag);
+  EXPECT_EQ(1U, format->segments[1].id);
+  EXPECT_EQ("c", format->tail);
+  EXPECT_TRUE(format->has("<text>"));
+  EXPECT_TRUE(format->has("<empty>"));
+}
+
+TEST_F(ModuleFormatTest, unknownTag) {
+  auto format = m_module.format();
+  format->value = "<text> <unknown>";
+  EXPECT_NO_THROW(format->compile());
+
+  ASSERT_EQ(2U, format->segments.size());
+  EXPECT_EQ("<unknown>", format->segments[1].tag);
+  EXPECT_EQ(string::npos, format->segments[1].id);
+  EXPECT_FALSE(format->has("<unknown>"));
+  EXPECT_FALSE(format->has("<empty>"));
+}
+
+TEST_F(ModuleFormatTest, leadingAndTrailingText) {
+  EXPECT_EQ("a foo b", output("  a <text> b", 0));
+  EXPECT_EQ("foo b", output("<text> b", 1));
+  EXPECT_EQ("foo  foo", output("<text> <text>", 1));
+  EXPECT_EQ("foo", output(" <empty> <text>", 1));
+  EXPECT_EQ("x foo", output(" <empty> x <text>", 1));
+}
+
+vector<pair<string, size_t>> legacy_formats = {
+  {"<text>", 0},
+  {"  a <text> b", 0},
+  {"  a <text> b", 2},
+  {"<text> <text>", 1},
+  {"<text>  <text>", 1},
+  {"<empty> <text>", 0},
+  {"<empty> <text>", 3},
+  {"x <empty> <text> y", 1},
+  {"<text> <empty> <text>", 1},
+  {"<text> <empty>", 2},
+  {"<text> <unknown> <text>", 1},
+  {"<unknown> <text>", 1},
+  {"a < b <text>", 1},
+  {"<text> >", 0},
+  {"no tags", 0},
+  {"", 0},
+};
+
+TEST_P(ModuleFormatTest, matchesLegacyOutput) {
+  const auto& value = GetParam().first;
+  auto spacing = GetParam().second;
+  EXPECT_EQ(legacy_output(value, spacing), output(value, spacing));
+}
+
+INSTANTIATE_TEST_SUITE_P(Inst, ModuleFormatTest, ::testing::ValuesIn(legacy_formats));
@@ -3,6 +3,7 @@
 #include "common/test.hpp"
 #include "components/logger.hpp"
 #include "gmock/gmock.h"
+#include "tags/parser.hpp"
 
 using namespace polybar;
 using namespace std;
@@ -20,8 +21,10 @@ class MockRenderer : public renderer_interface {
   MockRenderer(action_context& action_ctxt) : renderer_interface(action_ctxt){};
 
   MOCK_METHOD(void, render_offset, (const context& ctxt, int pixels), (override));
-  MOCK_METHOD(void, render_text, (const context& ctxt, const string&& str), (override));
+  MOCK_METHOD(void, render_text, (const context& ctxt, const string& str), (override));
   MOCK_METHOD(void, change_alignment, (const context& ctxt), (override));
+  MOCK_METHOD(void, begin_slice, (const context& ctxt, const string& key), (override));
+  MOCK_METHOD(void, end_slice, (const context& ctxt), (override));
   MOCK_METHOD(double, get_x, (const context& ctxt), (const, override));
   MOCK_METHOD(double, get_alignment_start, (const alignment align), (const, override));
 };
@@ -148,3 +151,84 @@ TEST_F(DispatchTest, actions) {
   EXPECT_EQ(mousebtn::LEFT, blk.button);
   EXPECT_EQ("cmd", blk.cmd);
 }
+
+TEST_F(DispatchTest, parsedElements) {
+  bar_settings settings;
+  rgba c1{"#ff0000"};
+
+  {
+    InSequence seq;
+    EXPECT_CALL(r, change_alignment(match_left_align)).Times(1);
+    EXPECT_CALL(r, get_x(_)).WillOnce(Return(0));
+    EXPECT_CALL(r, render_text(AllOf(match_left_align, match_fg(c1)), string{"foo"})).Times(1);
+    EXPECT_CALL(r, get_x(_)).WillOnce(Return(3));
+    EXPECT_CALL(r, render_text(match_fg(settings.foreground), string{"bar"})).Times(1);
+  }
+
+  parser p;
+  p.set("%{l}%{A1:cmd:}%{F#ff0000}foo%{F-}%{A}bar");
+  m_dispatch->parse(settings, r, p.parse());
+
+  ASSERT_EQ(1, m_action_ctxt->get_blocks().size());
+  EXPECT_EQ(3, m_action_ctxt->get_blocks()[0].end_x);
+}
+
+TEST_F(DispatchTest, parsedBlocks) {
+  bar_settings settings;
+  rgba c1{"#ff0000"};
+
+  {
+    InSequence seq;
+    EXPECT_CALL(r, change_alignment(match_left_align)).Times(1);
+    EXPECT_CALL(r, render_text(AllOf(match_left_align, match_fg(c1)), string{"foo"})).Times(1);
+    EXPECT_CALL(r, change_alignment(match_right_align)).Times(1);
+    EXPECT_CALL(r, render_text(AllOf(match_right_align, match_fg(c1)), string{"bar"})).Times(1);
+  }
+
+  parser p;
+  format_blocks blocks;
+  p.set("%{l}%{F#ff0000}foo");
+  blocks.emplace_back(make_shared<const format_string>(p.parse()));
+  p.set("%{r}bar");
+  blocks.emplace_back(make_shared<const format_string>(p.parse()));
+
+  // State carries over from one block to the next
+  m_dispatch->parse(settings, r, blocks);
+}
+
+TEST_F(DispatchTest, slices) {
+  bar_settings settings;
+  rgba c1{"#ff0000"};
+
+  {
+    InSequence seq;
+    EXPECT_CALL(r, change_alignment(match_left_align)).Times(1);
+    EXPECT_CALL(r, begin_slice(match_fg(c1), string{"foo%{PR}"})).Times(1);
+    EXPECT_CALL(r, render_text(_, string{"foo"})).Times(1);
+    EXPECT_CALL(r, end_slice(match_fg(settings.foreground))).Times(1);
+  }
+
+  parser p;
+  p.set("%{l}%{F#ff0000}");
+  format_string elements = p.parse();
+
+  element begin{"foo%{PR}"};
+  begin.is_tag = true;
+  begin.tag_data.type = tag_type::FORMAT;
+  begin.tag_data.subtype.format = syntaxtag::P;
+  begin.tag_data.ctrl = controltag::S;
+  elements.emplace_back(move(begin));
+
+  p.set("foo%{PR}");
+  auto contents = p.parse();
+  elements.insert(elements.end(), contents.begin(), contents.end());
+
+  element end{};
+  end.is_tag = true;
+  end.tag_data.type = tag_type::FORMAT;
+  end.tag_data.subtype.format = syntaxtag::P;
+  end.tag_data.ctrl = controltag::E;
+  elements.emplace_back(move(end));
+
+  m_dispatch->parse(settings, r, elements);
+}
@@ -0,0 +1,76 @@
+#include "utils/dirty_set.hpp"
+
+#include <thread>
+
+#include "common/test.hpp"
+
+using namespace polybar;
+
+TEST(DirtySet, empty) {
+  dirty_set set{3};
+  EXPECT_EQ(3U, set.size());
+  EXPECT_FALSE(set.pending());
+  EXPECT_EQ(vector<bool>({false, false, false}), set.take());
+}
+
+TEST(DirtySet, wakesOnlyOnFirstMark) {
+  dirty_set set{3};
+  EXPECT_TRUE(set.mark(2));
+  EXPECT_FALSE(set.mark(0));
+  EXPECT_FALSE(set.mark(2));
+  EXPECT_TRUE(set.pending());
+
+  EXPECT_EQ(vector<bool>({true, false, true}), set.take());
+  EXPECT_FALSE(set.pending());
+  EXPECT_EQ(vector<bool>({false, false, false}), set.take());
+
+  EXPECT_TRUE(set.mark(1));
+  EXPECT_EQ(vector<bool>({false, true, false}), set.take());
+}
+
+TEST(DirtySet, spansWords) {
+  dirty_set set{130};
+  set.mark(0);
+  set.mark(63);
+  set.mark(64);
+  set.mark(129);
+
+  auto changed = set.take();
+  ASSERT_EQ(130U, changed.size());
+  for (size_t i = 0; i < changed.size(); i++) {
+    EXPECT_EQ(i == 0 || i == 63 || i == 64 || i == 129, changed[i]) << i;
+  }
+}
+
+TEST(DirtySet, concurrentMarks) {
+  const size_t threads{4};
+  const size_t rounds{10000};
+  dirty_set set{threads};
+  std::atomic<size_t> finished{0};
+  vector<std::thread> producers;
+
+  for (size_t t = 0; t < threads; t++) {
+    producers.emplace_back([&, t] {
+      for (size_t i = 0; i < rounds; i++) {
+        set.mark(t);
+      }
+      finished++;
+    });
+  }
+
+  vector<bool> seen(threads, false);
+  while (finished < threads || set.pending()) {
+    auto changed = set.take();
+    for (size_t t = 0; t < threads; t++) {
+      seen[t] = seen[t] || changed[t];
+    }
+  }
+
+  for (auto&& p : producers) {
+    p.join();
+  }
+
+  // No mark is left behind once the set is no longer pending
+  EXPECT_EQ(vector<bool>(threads, true), seen);
+  EXPECT_EQ(vector<bool>(threads, false), set.take());
+}
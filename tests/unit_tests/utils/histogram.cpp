@@ -0,0 +1,87 @@
+#include "utils/histogram.hpp"
+
+#include "common/test.hpp"
+
+using namespace polybar;
+using namespace std::chrono_literals;
+
+TEST(Histogram, empty) {
+  histogram h;
+  EXPECT_EQ(0U, h.count());
+  EXPECT_EQ(histogram::clock::duration::zero(), h.mean());
+  EXPECT_EQ(histogram::clock::duration::zero(), h.percentile(0.5));
+  EXPECT_EQ("{\"count\":0,\"sum_us\":0,\"mean_us\":0,\"p50_us\":0,\"p90_us\":0,\"p99_us\":0,\"max_us\":0,\"buckets\":[]}",
+      h.to_json());
+}
+
+TEST(Histogram, bucketIndex) {
+  EXPECT_EQ(0U, histogram::bucket_index(0ns));
+  EXPECT_EQ(0U, histogram::bucket_index(999ns));
+  EXPECT_EQ(1U, histogram::bucket_index(1us));
+  EXPECT_EQ(2U, histogram::bucket_index(2us));
+  EXPECT_EQ(2U, histogram::bucket_index(3us));
+  EXPECT_EQ(3U, histogram::bucket_index(4us));
+  EXPECT_EQ(10U, histogram::bucket_index(1ms));
+  EXPECT_EQ(histogram::BUCKETS - 1, histogram::bucket_index(10000s));
+  EXPECT_EQ(0U, histogram::bucket_index(-1s));
+
+  for (size_t i = 0; i + 1 < histogram::BUCKETS; i++) {
+    EXPECT_EQ(i + 1, histogram::bucket_index(histogram::bucket_limit(i)));
+  }
+}
+
+TEST(Histogram, record) {
+  histogram h;
+  h.record(1us);
+  h.record(3us);
+  h.record(100us);
+
+  EXPECT_EQ(3U, h.count());
+  EXPECT_EQ(104us, h.sum());
+  EXPECT_EQ(100us, h.max());
+  EXPECT_EQ(chrono::nanoseconds(104000 / 3), h.mean());
+  EXPECT_EQ(1U, h.bucket(1));
+  EXPECT_EQ(1U, h.bucket(2));
+  EXPECT_EQ(1U, h.bucket(7));
+
+  h.reset();
+  EXPECT_EQ(0U, h.count());
+  EXPECT_EQ(0U, h.bucket(1));
+}
+
+TEST(Histogram, percentile) {
+  histogram h;
+  for (int i = 0; i < 90; i++) {
+    h.record(10us);
+  }
+  for (int i = 0; i < 10; i++) {
+    h.record(300us);
+  }
+
+  // Upper limit of the bucket [8, 16)
+  EXPECT_EQ(16us, h.percentile(0.5));
+  EXPECT_EQ(16us, h.percentile(0.9));
+  // Capped to the maximum instead of the bucket limit of 512us
+  EXPECT_EQ(300us, h.percentile(0.99));
+  EXPECT_EQ(300us, h.percentile(1));
+}
+
+TEST(Histogram, measure) {
+  histogram h;
+  {
+    auto timer = h.measure();
+  }
+  EXPECT_EQ(1U, h.count());
+}
+
+TEST(Histogram, json) {
+  histogram h;
+  h.record(10us);
+  h.record(10us);
+  h.record(30us);
+
+  EXPECT_EQ(
+      "{\"count\":3,\"sum_us\":50,\"mean_us\":16,\"p50_us\":16,\"p90_us\":30,\"p99_us\":30,\"max_us\":30,"
+      "\"buckets\":[[16,2],[32,1]]}",
+      h.to_json());
+}
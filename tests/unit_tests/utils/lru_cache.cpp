@@ -0,0 +1,45 @@
+#include "utils/lru_cache.hpp"
+
+#include "common/test.hpp"
+
+using namespace polybar;
+
+TEST(LruCache, getAndPut) {
+  lru_cache<string, int> cache{2};
+
+  EXPECT_EQ(nullptr, cache.get("a"));
+
+  cache.put("a", 1);
+  ASSERT_NE(nullptr, cache.get("a"));
+  EXPECT_EQ(1, *cache.get("a"));
+
+  cache.put("a", 2);
+  EXPECT_EQ(2, *cache.get("a"));
+  EXPECT_EQ(1, cache.size());
+}
+
+TEST(LruCache, evictsLeastRecentlyUsed) {
+  lru_cache<string, int> cache{2};
+
+  cache.put("a", 1);
+  cache.put("b", 2);
+
+  // Touch "a" so that "b" is the least recently used entry
+  cache.get("a");
+  cache.put("c", 3);
+
+  EXPECT_EQ(2, cache.size());
+  EXPECT_NE(nullptr, cache.get("a"));
+  EXPECT_EQ(nullptr, cache.get("b"));
+  EXPECT_NE(nullptr, cache.get("c"));
+}
+
+TEST(LruCache, clear) {
+  lru_cache<int, int> cache{4};
+  cache.put(1, 1);
+  cache.put(2, 2);
+  cache.clear();
+
+  EXPECT_EQ(0, cache.size());
+  EXPECT_EQ(nullptr, cache.get(1));
+}
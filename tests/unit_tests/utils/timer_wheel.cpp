@@ -0,0 +1,113 @@
+#include "utils/timer_wheel.hpp"
+
+#include <algorithm>
+#include <map>
+#include <random>
+
+#include "common/test.hpp"
+
+using namespace polybar;
+using namespace std::chrono_literals;
+
+using wheel_clock = timer_wheel::clock;
+
+static wheel_clock::time_point at(chrono::milliseconds ms) {
+  return wheel_clock::time_point{ms};
+}
+
+TEST(TimerWheel, empty) {
+  timer_wheel wheel{10ms, at(0ms)};
+  EXPECT_TRUE(wheel.empty());
+  EXPECT_TRUE(wheel.expire(at(10000ms)).empty());
+}
+
+TEST(TimerWheel, roundsUpToResolution) {
+  timer_wheel wheel{10ms, at(1000ms)};
+  wheel.schedule(1, at(1001ms));
+  EXPECT_EQ(at(1010ms), wheel.next_expiry());
+  EXPECT_TRUE(wheel.expire(at(1009ms)).empty());
+  EXPECT_EQ(vector<timer_wheel::id_t>{1}, wheel.expire(at(1010ms)));
+  EXPECT_TRUE(wheel.empty());
+}
+
+TEST(TimerWheel, coalesceSlackWindow) {
+  timer_wheel wheel{50ms, at(0ms)};
+  wheel.schedule(1, at(1001ms));
+  wheel.schedule(2, at(1020ms));
+  wheel.schedule(3, at(1049ms));
+  wheel.schedule(4, at(1051ms));
+
+  EXPECT_EQ(at(1050ms), wheel.next_expiry());
+
+  auto expired = wheel.expire(at(1050ms));
+  std::sort(expired.begin(), expired.end());
+  EXPECT_EQ((vector<timer_wheel::id_t>{1, 2, 3}), expired);
+  EXPECT_EQ(1, wheel.size());
+  EXPECT_EQ(at(1100ms), wheel.next_expiry());
+}
+
+TEST(TimerWheel, pastDeadlineExpiresImmediately) {
+  timer_wheel wheel{10ms, at(5000ms)};
+  wheel.schedule(1, at(0ms));
+  EXPECT_EQ(at(5000ms), wheel.next_expiry());
+  EXPECT_EQ(vector<timer_wheel::id_t>{1}, wheel.expire(at(5000ms)));
+}
+
+TEST(TimerWheel, rescheduleAndCancel) {
+  timer_wheel wheel{1ms, at(0ms)};
+  wheel.schedule(1, at(100ms));
+  wheel.schedule(2, at(200ms));
+  wheel.schedule(1, at(300ms));
+
+  EXPECT_EQ(at(200ms), wheel.next_expiry());
+  EXPECT_TRUE(wheel.cancel(2));
+  EXPECT_FALSE(wheel.cancel(2));
+  EXPECT_EQ(at(300ms), wheel.next_expiry());
+  EXPECT_TRUE(wheel.expire(at(299ms)).empty());
+  EXPECT_EQ(vector<timer_wheel::id_t>{1}, wheel.expire(at(300ms)));
+}
+
+TEST(TimerWheel, farDeadlinesCascade) {
+  timer_wheel wheel{1ms, at(0ms)};
+  wheel.schedule(1, at(24h));
+  wheel.schedule(2, at(65ms));
+  wheel.schedule(3, at(4097ms));
+
+  EXPECT_EQ(vector<timer_wheel::id_t>{2}, wheel.expire(at(1000ms)));
+  EXPECT_EQ(at(4097ms), wheel.next_expiry());
+  EXPECT_EQ(vector<timer_wheel::id_t>{3}, wheel.expire(at(10000ms)));
+  EXPECT_EQ(at(24h), wheel.next_expiry());
+  EXPECT_TRUE(wheel.expire(at(24h - 1ms)).empty());
+  EXPECT_EQ(vector<timer_wheel::id_t>{1}, wheel.expire(at(24h)));
+}
+
+TEST(TimerWheel, randomized) {
+  std::mt19937 rng{42};
+  std::uniform_int_distribution<int> delay{0, 200000};
+
+  timer_wheel wheel{1ms, at(0ms)};
+  std::multimap<int, timer_wheel::id_t> expected;
+
+  for (timer_wheel::id_t id = 1; id <= 500; id++) {
+    int ms = delay(rng);
+    wheel.schedule(id, at(chrono::milliseconds{ms}));
+    expected.emplace(ms, id);
+  }
+
+  int now{0};
+  while (!expected.empty()) {
+    now += delay(rng) / 100;
+    auto expired = wheel.expire(at(chrono::milliseconds{now}));
+
+    vector<timer_wheel::id_t> due;
+    while (!expected.empty() && expected.begin()->first <= now) {
+      due.emplace_back(expected.begin()->second);
+      expected.erase(expected.begin());
+    }
+
+    std::sort(expired.begin(), expired.end());
+    std::sort(due.begin(), due.end());
+    ASSERT_EQ(due, expired) << "at " << now << "ms";
+  }
+  EXPECT_TRUE(wheel.empty());
+}
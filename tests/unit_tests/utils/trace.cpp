@@ -0,0 +1,92 @@
+#include "utils/trace.hpp"
+
+#include <unistd.h>
+
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+#include "common/test.hpp"
+#include "errors.hpp"
+
+using namespace polybar;
+
+class Trace : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    char name[] = "/tmp/polybar_trace.XXXXXX";
+    int fd = mkstemp(name);
+    ASSERT_NE(-1, fd);
+    close(fd);
+    m_path = name;
+  }
+
+  void TearDown() override {
+    trace_util::stop();
+    unlink(m_path.c_str());
+  }
+
+  string contents() const {
+    std::ifstream in(m_path);
+    std::stringstream ss;
+    ss << in.rdbuf();
+    return ss.str();
+  }
+
+  string m_path;
+};
+
+TEST_F(Trace, disabled) {
+  EXPECT_FALSE(trace_util::enabled());
+  { trace_util::span span{"nothing"}; }
+  EXPECT_EQ("", contents());
+}
+
+TEST_F(Trace, recordsSpans) {
+  const string detail{"module/date"};
+
+  trace_util::start(m_path);
+  EXPECT_TRUE(trace_util::enabled());
+
+  std::thread([&] {
+    trace_util::thread_name("worker");
+    trace_util::span span{"update", detail};
+  }).join();
+
+  trace_util::stop();
+  EXPECT_FALSE(trace_util::enabled());
+
+  auto trace = contents();
+  EXPECT_EQ('[', trace.front());
+  EXPECT_EQ("]\n", trace.substr(trace.size() - 2));
+  EXPECT_NE(string::npos, trace.find(R"("ph":"M")"));
+  EXPECT_NE(string::npos, trace.find(R"("args":{"name":"worker"})"));
+  EXPECT_NE(string::npos, trace.find(R"({"name":"update","cat":"polybar","ph":"X")"));
+  EXPECT_NE(string::npos, trace.find(R"("args":{"detail":"module/date"})"));
+}
+
+TEST_F(Trace, renamedThreadIsNamedOnce) {
+  std::thread([&] {
+    trace_util::thread_name("before");
+    trace_util::start(m_path);
+    trace_util::thread_name("after");
+    trace_util::stop();
+  }).join();
+
+  auto trace = contents();
+  EXPECT_EQ(string::npos, trace.find(R"("args":{"name":"before"})"));
+  auto first = trace.find(R"("args":{"name":"after"})");
+  EXPECT_NE(string::npos, first);
+  EXPECT_EQ(string::npos, trace.find(R"("args":{"name":"after"})", first + 1));
+}
+
+TEST_F(Trace, startTwice) {
+  trace_util::start(m_path);
+  EXPECT_THROW(trace_util::start(m_path), application_error);
+}
+
+TEST(TraceUtil, typeName) {
+  EXPECT_EQ("int", trace_util::type_name<int>());
+  EXPECT_NE(string::npos, trace_util::type_name<application_error>().find("application_error"));
+}